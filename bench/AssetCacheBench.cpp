@@ -0,0 +1,141 @@
+// Compares the per-request cost of the old CommServer file path (canonicalise + ifstream
+// + stringstream on every GET) with AssetCache lookups, for both full responses and
+// If-None-Match revalidations. Runs in-process, so the numbers are handler throughput
+// (requests/s the event-loop thread can serve) without socket overhead.
+//
+// Usage: AssetCacheBench [web_root] [icons_root] [iterations]
+
+#include "AssetCache.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+#ifndef WEBSTREAMDECK_SOURCE_DIR
+#define WEBSTREAMDECK_SOURCE_DIR "."
+#endif
+
+namespace {
+
+// Verbatim copy of the lookup CommServer did before the cache existed
+std::optional<std::string> legacyReadFile(const fs::path& path, const fs::path& webRoot, const fs::path& iconsRoot) {
+    auto canonicalPath = fs::weakly_canonical(path);
+    auto webRootCanonical = fs::weakly_canonical(webRoot);
+    auto iconsRootCanonical = fs::weakly_canonical(iconsRoot);
+
+    bool isInWebRoot = (canonicalPath.string().find(webRootCanonical.string()) == 0);
+    bool isInIconsRoot = (canonicalPath.string().find(iconsRootCanonical.string()) == 0);
+    if (!isInWebRoot && !isInIconsRoot) {
+        return std::nullopt;
+    }
+    if (!fs::exists(canonicalPath) || !fs::is_regular_file(canonicalPath)) {
+        return std::nullopt;
+    }
+    std::ifstream file(canonicalPath, std::ios::binary);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+struct Request {
+    std::string url;
+    fs::path diskPath;
+};
+
+template <typename Fn>
+double measureRequestsPerSecond(const std::vector<Request>& requests, int iterations, Fn&& handler) {
+    size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const auto& request : requests) {
+            sink += handler(request);
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (sink == 0) std::cerr << "(no bytes served)" << std::endl;
+    return static_cast<double>(requests.size()) * iterations / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    fs::path webRoot = argc > 1 ? fs::path(argv[1]) : fs::path(WEBSTREAMDECK_SOURCE_DIR) / "web";
+    fs::path iconsRoot = argc > 2 ? fs::path(argv[2]) : fs::path(WEBSTREAMDECK_SOURCE_DIR) / "assets/icons";
+    int iterations = argc > 3 ? std::stoi(argv[3]) : 2000;
+
+    AssetCache cache;
+    cache.addRoot("/assets/icons/", iconsRoot);
+    cache.addRoot("/", webRoot);
+
+    auto preloadStart = std::chrono::steady_clock::now();
+    size_t fileCount = cache.preload();
+    std::chrono::duration<double, std::milli> preloadMs = std::chrono::steady_clock::now() - preloadStart;
+    if (fileCount == 0) {
+        std::cerr << "No files found below " << webRoot << " and " << iconsRoot << std::endl;
+        return 1;
+    }
+
+    // One request per file, same mapping CommServer uses
+    std::vector<Request> requests;
+    for (const auto& [root, prefix] : {std::pair{webRoot, std::string("/")}, std::pair{iconsRoot, std::string("/assets/icons/")}}) {
+        for (const auto& entry : fs::recursive_directory_iterator(root)) {
+            if (!entry.is_regular_file()) continue;
+            requests.push_back({prefix + fs::relative(entry.path(), root).generic_string(), entry.path()});
+        }
+    }
+
+    const std::string acceptEncoding = "gzip, deflate, br";
+
+    double legacy = measureRequestsPerSecond(requests, iterations, [&](const Request& request) -> size_t {
+        auto content = legacyReadFile(request.diskPath, webRoot, iconsRoot);
+        return content ? content->size() + AssetCache::getMimeType(request.diskPath).size() : 0;
+    });
+
+    double cachedFull = measureRequestsPerSecond(requests, iterations, [&](const Request& request) -> size_t {
+        const CachedAsset* asset = cache.find(request.url);
+        if (!asset) return 0;
+        switch (AssetCache::selectEncoding(acceptEncoding, *asset)) {
+            case AssetEncoding::Brotli: return asset->brotliBody.size();
+            case AssetEncoding::Gzip: return asset->gzipBody.size();
+            default: return asset->body.size();
+        }
+    });
+
+    double cachedRevalidate = measureRequestsPerSecond(requests, iterations, [&](const Request& request) -> size_t {
+        const CachedAsset* asset = cache.find(request.url);
+        return (asset && AssetCache::matchesETag(asset->etag, asset->etag)) ? 1 : 0;
+    });
+
+    size_t identityBytes = 0;
+    size_t negotiatedBytes = 0;
+    for (const auto& request : requests) {
+        const CachedAsset* asset = cache.find(request.url);
+        if (!asset) continue;
+        identityBytes += asset->body.size();
+        switch (AssetCache::selectEncoding(acceptEncoding, *asset)) {
+            case AssetEncoding::Brotli: negotiatedBytes += asset->brotliBody.size(); break;
+            case AssetEncoding::Gzip: negotiatedBytes += asset->gzipBody.size(); break;
+            default: negotiatedBytes += asset->body.size(); break;
+        }
+    }
+
+    std::cout << "Files: " << fileCount << ", preload: " << preloadMs.count() << " ms, cache size: "
+              << cache.totalBytes() << " bytes\n";
+    std::cout << "Bytes per full page load: " << identityBytes << " identity, " << negotiatedBytes
+              << " with Accept-Encoding: " << acceptEncoding << "\n";
+    std::cout << "legacy readFile        : " << static_cast<long long>(legacy) << " req/s\n";
+    std::cout << "AssetCache 200         : " << static_cast<long long>(cachedFull) << " req/s ("
+              << cachedFull / legacy << "x)\n";
+    std::cout << "AssetCache 304         : " << static_cast<long long>(cachedRevalidate) << " req/s ("
+              << cachedRevalidate / legacy << "x)\n";
+    return 0;
+}
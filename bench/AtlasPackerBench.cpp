@@ -0,0 +1,136 @@
+// How well SkylinePacker fills a 1024x1024 icon atlas page, without a GL context.
+// Reports icons per page, occupancy and fragmentation for uniform and mixed icon sizes,
+// then replaces icons at random (as config edits do) to show how often the free list is
+// enough and how often the page has to be repacked.
+//
+// Usage: AtlasPackerBench [display_size] [churn_rounds]
+
+#include "Utils/SkylinePacker.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int PAGE_SIZE = 1024;
+constexpr int PADDING = 1; // As IconAtlas: one repeated edge pixel on every side
+
+struct Size {
+    int width;
+    int height;
+};
+
+// Icons the way IconAtlas stores them: downscaled to at most displaySize, plus padding
+std::vector<Size> makeIcons(size_t count, int displaySize, bool mixed, std::mt19937& rng) {
+    // Common icon file sizes; anything above the display size is downscaled to it
+    const int sourceSizes[] = {16, 24, 32, 48, 64, 72, 96, 128, 256, 512};
+    std::uniform_int_distribution<size_t> pick(0, std::size(sourceSizes) - 1);
+    std::vector<Size> icons;
+    icons.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        int width = displaySize;
+        int height = displaySize;
+        if (mixed) {
+            width = std::min(sourceSizes[pick(rng)], displaySize);
+            height = (rng() % 4 == 0) ? std::min(sourceSizes[pick(rng)], displaySize) : width; // Some non-square
+        }
+        icons.push_back({width + 2 * PADDING, height + 2 * PADDING});
+    }
+    return icons;
+}
+
+// Inserts until the page is full; returns how many fit
+size_t fill(SkylinePacker& packer, const std::vector<Size>& icons, std::vector<PackedRect>& placed, double& nsPerInsert) {
+    auto start = std::chrono::steady_clock::now();
+    size_t attempts = 0;
+    for (const auto& icon : icons) {
+        ++attempts;
+        auto rect = packer.insert(icon.width, icon.height);
+        if (!rect) break;
+        placed.push_back(*rect);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    nsPerInsert = elapsed.count() / static_cast<double>(attempts);
+    return placed.size();
+}
+
+void printRow(const char* label, const SkylinePacker& packer, double nsPerInsert) {
+    SkylinePacker::Stats stats = packer.stats();
+    std::printf("%-26s %8zu %10.1f%% %13.1f%% %10d %11.0f\n", label, stats.rects, stats.occupancy * 100.0,
+                stats.fragmentation * 100.0, stats.skylineTop, nsPerInsert);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int displaySize = argc > 1 ? std::stoi(argv[1]) : 100;
+    size_t churnRounds = argc > 2 ? std::stoul(argv[2]) : 2000;
+    std::mt19937 rng(42);
+
+    std::printf("page %dx%d, display size %d px, padding %d px\n", PAGE_SIZE, PAGE_SIZE, displaySize, PADDING);
+    std::printf("%-26s %8s %11s %14s %10s %11s\n", "case", "icons", "occupancy", "fragmentation", "top", "ns/insert");
+
+    for (bool mixed : {false, true}) {
+        SkylinePacker packer(PAGE_SIZE, PAGE_SIZE);
+        std::vector<PackedRect> placed;
+        double nsPerInsert = 0.0;
+        fill(packer, makeIcons(100000, displaySize, mixed, rng), placed, nsPerInsert);
+        printRow(mixed ? "fill, mixed sizes" : "fill, uniform size", packer, nsPerInsert);
+    }
+
+    // Churn: replace a random icon with a random new one, as config edits do. A new icon
+    // first tries the freed rectangles and the skyline; if it doesn't fit and enough of the
+    // page is unusable, the page is repacked with IconAtlas's policy (SkylinePacker::shouldRepack).
+    auto repack = [](SkylinePacker& packer, std::vector<PackedRect>& placed) {
+        std::vector<PackedRect> live = std::move(placed);
+        std::sort(live.begin(), live.end(), SkylinePacker::repackOrder);
+        packer.clear();
+        placed.clear();
+        for (const auto& icon : live) {
+            if (auto rect = packer.insert(icon.width, icon.height)) placed.push_back(*rect);
+        }
+        return live.size() - placed.size(); // Icons that no longer fit
+    };
+
+    SkylinePacker packer(PAGE_SIZE, PAGE_SIZE);
+    std::vector<PackedRect> placed;
+    double nsPerInsert = 0.0;
+    fill(packer, makeIcons(100000, displaySize, true, rng), placed, nsPerInsert);
+    size_t direct = 0, afterRepack = 0, overflowed = 0, repacks = 0, lostInRepack = 0;
+    std::vector<Size> replacements = makeIcons(churnRounds, displaySize, true, rng);
+    size_t rounds = 0;
+    auto churnStart = std::chrono::steady_clock::now();
+    for (const auto& icon : replacements) {
+        ++rounds;
+        size_t victim = rng() % placed.size();
+        packer.release(placed[victim]);
+        placed.erase(placed.begin() + victim);
+        if (auto rect = packer.insert(icon.width, icon.height)) {
+            placed.push_back(*rect);
+            ++direct;
+            continue;
+        }
+        if (packer.shouldRepack()) {
+            ++repacks;
+            lostInRepack += repack(packer, placed);
+            if (auto rect = packer.insert(icon.width, icon.height)) {
+                placed.push_back(*rect);
+                ++afterRepack;
+                continue;
+            }
+        }
+        ++overflowed; // Would go to another page
+        if (placed.empty()) break;
+    }
+    // Per replacement: release, insert and the share of repacks
+    std::chrono::duration<double, std::nano> churnElapsed = std::chrono::steady_clock::now() - churnStart;
+    char label[64];
+    std::snprintf(label, sizeof(label), "after %zu replacements", churnRounds);
+    printRow(label, packer, rounds > 0 ? churnElapsed.count() / static_cast<double>(rounds) : 0.0);
+    std::printf("  placed directly %zu, after a repack %zu, on another page %zu; %zu repacks (%zu icons moved out)\n",
+                direct, afterRepack, overflowed, repacks, lostInRepack);
+    return 0;
+}
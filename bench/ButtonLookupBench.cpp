@@ -0,0 +1,119 @@
+// Button lookup cost as the deck grows. Compares the old linear getButtonById (scan +
+// copy of the whole ButtonConfig) with the hashed lookups ConfigManager has now:
+// getButtonById (hash + copy), ConfigSnapshot::find (hash, no copy), the same with the
+// getSnapshot() the press path pays for, and a miss (what addButton's duplicate check costs).
+//
+// Usage: ButtonLookupBench [max_buttons]
+
+#include "ConfigManager.hpp"
+#include "Utils/Logger.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Verbatim copy of the lookup ConfigManager did before the index existed
+std::optional<ButtonConfig> legacyGetButtonById(const std::vector<ButtonConfig>& buttons, const std::string& id) {
+    for (const auto& button : buttons) {
+        if (button.id == id) {
+            return button;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<ButtonConfig> makeButtons(size_t count) {
+    std::vector<ButtonConfig> buttons;
+    buttons.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string suffix = std::to_string(i);
+        buttons.push_back({"btn_" + suffix, "Button " + suffix, "hotkey", "CTRL+ALT+" + suffix,
+                           "assets/icons/button_" + suffix + ".png"});
+    }
+    return buttons;
+}
+
+// Nanoseconds per call
+template <typename Fn>
+double measure(const std::vector<std::string>& ids, Fn&& lookup) {
+    size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& id : ids) {
+        sink += lookup(id);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    if (sink == 0) std::cerr << "(no lookups succeeded)" << std::endl;
+    return elapsed.count() / static_cast<double>(ids.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t maxButtons = argc > 1 ? std::stoul(argv[1]) : 100000;
+
+    Logger::Init();
+    Logger::SetLevel(Logger::Level::Warn);
+
+    fs::path configPath = fs::temp_directory_path() / "webstreamdeck_lookup_bench.json";
+    fs::path cachePath = configPath; // ConfigBinaryCache's sidecar, written on load and save
+    cachePath += ".cache";
+    std::ofstream(configPath) << R"({"buttons": []})";
+
+    std::printf("%10s %12s %14s %14s %12s %14s %12s %12s\n", "buttons", "replace ms", "legacy ns", "byId ns",
+                "find ns", "snap+find ns", "miss ns", "speedup");
+    std::mt19937 rng(42);
+    for (size_t count = 10; count <= maxButtons; count *= 10) {
+        ConfigManager configManager(configPath.string());
+        auto replaceStart = std::chrono::steady_clock::now();
+        configManager.replaceButtons(makeButtons(count));
+        std::chrono::duration<double, std::milli> replaceMs = std::chrono::steady_clock::now() - replaceStart;
+
+        // Keep the linear scan's total work bounded on large decks
+        size_t lookups = std::max<size_t>(2000, 20000000 / count);
+        std::uniform_int_distribution<size_t> pick(0, count - 1);
+        std::vector<std::string> ids;
+        ids.reserve(lookups);
+        for (size_t i = 0; i < lookups; ++i) ids.push_back("btn_" + std::to_string(pick(rng)));
+        std::vector<std::string> missing(ids.size(), "btn_missing");
+
+        auto snapshot = configManager.getSnapshot();
+        const auto& buttons = snapshot->buttons;
+        double legacy = measure(ids, [&](const std::string& id) -> size_t {
+            auto button = legacyGetButtonById(buttons, id);
+            return button ? button->action_param.size() : 0;
+        });
+        double byId = measure(ids, [&](const std::string& id) -> size_t {
+            auto button = configManager.getButtonById(id);
+            return button ? button->action_param.size() : 0;
+        });
+        double find = measure(ids, [&](const std::string& id) -> size_t {
+            const ButtonConfig* button = snapshot->find(id);
+            return button ? button->action_param.size() : 0;
+        });
+        double snapshotFind = measure(ids, [&](const std::string& id) -> size_t {
+            auto current = configManager.getSnapshot();
+            const ButtonConfig* button = current->find(id);
+            return button ? button->action_param.size() : 0;
+        });
+        double miss = measure(missing, [&](const std::string& id) -> size_t {
+            return snapshot->find(id) ? 0 : 1;
+        });
+
+        std::printf("%10zu %12.2f %14.1f %14.1f %12.1f %14.1f %12.1f %11.1fx\n", count, replaceMs.count(), legacy, byId,
+                    find, snapshotFind, miss, legacy / find);
+    }
+
+    fs::remove(configPath);
+    fs::remove(cachePath);
+    Logger::Shutdown();
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Startup cost of loading config.json for large generated decks.
+//   parse     - what loadConfig did before the sidecar: read, json::parse, get_to
+//   cold      - ConfigManager construction without a sidecar (parse, publish, write the sidecar)
+//   warm      - ConfigManager construction with a valid sidecar (hash the JSON, mmap, decode)
+// Times are the median of several runs; files stay in the OS page cache, so "cold" means
+// "no sidecar", not "nothing cached by the OS".
+//
+// Usage: ConfigStartupBench [max_buttons] [runs]
+
+#include "ConfigManager.hpp"
+#include "Utils/Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace {
+
+std::vector<ButtonConfig> makeButtons(size_t count) {
+    static const char* const ACTION_TYPES[] = {"hotkey", "launch_app", "open_url", "media_play_pause"};
+    std::vector<ButtonConfig> buttons;
+    buttons.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string suffix = std::to_string(i);
+        std::string page = "page_" + std::to_string(i / 32);
+        buttons.push_back({page + "_btn_" + suffix, "Generated button " + suffix, ACTION_TYPES[i % 4],
+                           "CTRL+ALT+SHIFT+" + suffix, "assets/icons/generated/button_" + std::to_string(i % 500) + ".png",
+                           page});
+    }
+    return buttons;
+}
+
+template <typename Fn>
+double medianMs(int runs, Fn&& fn) {
+    std::vector<double> samples;
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t maxButtons = argc > 1 ? std::stoul(argv[1]) : 100000;
+    int runs = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    Logger::Init();
+    Logger::SetLevel(Logger::Level::Warn);
+
+    fs::path directory = fs::temp_directory_path() / "webstreamdeck_startup_bench";
+    fs::create_directories(directory);
+    fs::path configPath = directory / "config.json";
+    fs::path cachePath = configPath;
+    cachePath += ".cache";
+
+    std::printf("%10s %12s %12s %12s %12s %12s %10s\n", "buttons", "json KiB", "cache KiB", "parse ms", "cold ms",
+                "warm ms", "speedup");
+    for (size_t count = 1000; count <= maxButtons; count *= 10) {
+        {
+            json configJson;
+            configJson["buttons"] = makeButtons(count);
+            std::ofstream(configPath, std::ios::binary) << configJson.dump(4);
+        }
+
+        double parseMs = medianMs(runs, [&]() {
+            std::ifstream file(configPath, std::ios::binary);
+            std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            std::vector<ButtonConfig> buttons;
+            json::parse(content).at("buttons").get_to(buttons);
+            if (buttons.size() != count) std::cerr << "parse: wrong button count" << std::endl;
+        });
+
+        std::shared_ptr<const ConfigSnapshot> coldSnapshot;
+        double coldMs = medianMs(runs, [&]() {
+            fs::remove(cachePath);
+            ConfigManager configManager(configPath.string());
+            coldSnapshot = configManager.getSnapshot();
+        });
+
+        std::shared_ptr<const ConfigSnapshot> warmSnapshot;
+        double warmMs = medianMs(runs, [&]() {
+            ConfigManager configManager(configPath.string());
+            warmSnapshot = configManager.getSnapshot();
+        });
+
+        // The sidecar must reproduce exactly what the JSON says
+        bool identical = coldSnapshot->buttons.size() == warmSnapshot->buttons.size();
+        for (size_t i = 0; identical && i < coldSnapshot->buttons.size(); ++i) {
+            const auto& a = coldSnapshot->buttons[i];
+            const auto& b = warmSnapshot->buttons[i];
+            identical = a.id == b.id && a.name == b.name && a.action_type == b.action_type &&
+                        a.action_param == b.action_param && a.icon_path == b.icon_path && a.page == b.page;
+        }
+        identical = identical && coldSnapshot->pages == warmSnapshot->pages;
+        if (!identical) {
+            std::cerr << "Binary cache produced different buttons for " << count << " buttons" << std::endl;
+            return 1;
+        }
+
+        std::printf("%10zu %12.0f %12.0f %12.2f %12.2f %12.2f %9.1fx\n", count, fs::file_size(configPath) / 1024.0,
+                    fs::file_size(cachePath) / 1024.0, parseMs, coldMs, warmMs, coldMs / warmMs);
+    }
+
+    fs::remove_all(directory);
+    Logger::Shutdown();
+    return 0;
+}
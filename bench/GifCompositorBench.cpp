@@ -0,0 +1,166 @@
+// GifCompositor against a straightforward reference compositor, without GL or giflib.
+// Plays a synthetic animation that uses every disposal method, transparency and frames
+// partly outside the canvas, and checks every composited frame against the reference
+// (the golden image). Then reports compositing time and how many bytes the dirty
+// rectangles upload compared to whole frames, and the texture memory of one canvas
+// compared to one texture per frame.
+//
+// Usage: GifCompositorBench [canvas_size] [frames] [loops]
+
+#include "Utils/GifCompositor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Pixel by pixel, whole canvas, no lookup tables: easy to check by eye
+class ReferenceCompositor {
+public:
+    ReferenceCompositor(int width, int height)
+        : m_width(width), m_height(height), m_canvas(static_cast<size_t>(width) * height * 4, 0) {}
+
+    void apply(const GifFrame& frame) {
+        if (m_hasPrevious) {
+            if (m_previous.disposal == GifDisposal::Background) {
+                forEachPixel(m_previous, [&](int x, int y, int, int) { std::memset(pixel(m_canvas, x, y), 0, 4); });
+            } else if (m_previous.disposal == GifDisposal::Previous) {
+                m_canvas = m_beforePrevious;
+            }
+        }
+        m_beforePrevious = m_canvas;
+        forEachPixel(frame, [&](int x, int y, int fx, int fy) {
+            int index = frame.indices[static_cast<size_t>(fy) * frame.width + fx];
+            if (index == frame.transparentIndex || index >= frame.colorCount) return;
+            std::memcpy(pixel(m_canvas, x, y), &frame.palette[index], 4);
+        });
+        m_previous = frame;
+        m_hasPrevious = true;
+    }
+
+    void reset() {
+        std::fill(m_canvas.begin(), m_canvas.end(), uint8_t(0));
+        m_hasPrevious = false;
+    }
+
+    const std::vector<uint8_t>& canvas() const { return m_canvas; }
+
+private:
+    template <typename Fn>
+    void forEachPixel(const GifFrame& frame, Fn fn) const {
+        for (int fy = 0; fy < frame.height; ++fy) {
+            for (int fx = 0; fx < frame.width; ++fx) {
+                int x = frame.left + fx;
+                int y = frame.top + fy;
+                if (x >= 0 && y >= 0 && x < m_width && y < m_height) fn(x, y, fx, fy);
+            }
+        }
+    }
+
+    uint8_t* pixel(std::vector<uint8_t>& canvas, int x, int y) const {
+        return canvas.data() + (static_cast<size_t>(y) * m_width + x) * 4;
+    }
+
+    int m_width;
+    int m_height;
+    std::vector<uint8_t> m_canvas;
+    std::vector<uint8_t> m_beforePrevious;
+    GifFrame m_previous;
+    bool m_hasPrevious = false;
+};
+
+// A sprite-like animation: a full first frame, then small frames moving around, with
+// every disposal method, some transparency, indices past the palette and edge overhangs
+std::vector<GifFrame> makeFrames(int canvasSize, int count, std::mt19937& rng) {
+    std::vector<GifFrame> frames;
+    frames.reserve(count);
+    std::uniform_int_distribution<int> sizeDist(std::max(canvasSize / 16, 1), std::max(canvasSize / 3, 1));
+    std::uniform_int_distribution<int> posDist(-canvasSize / 8, canvasSize - 1);
+    for (int i = 0; i < count; ++i) {
+        GifFrame frame;
+        if (i == 0) {
+            frame.width = frame.height = canvasSize;
+        } else {
+            frame.left = posDist(rng);
+            frame.top = posDist(rng);
+            frame.width = sizeDist(rng);
+            frame.height = sizeDist(rng);
+        }
+        frame.colorCount = 2 + static_cast<int>(rng() % 255);
+        for (int c = 0; c < 256; ++c) {
+            uint8_t rgba[4] = {uint8_t(rng()), uint8_t(rng()), uint8_t(rng()), 255};
+            std::memcpy(&frame.palette[c], rgba, 4);
+        }
+        frame.transparentIndex = (rng() % 3 == 0) ? -1 : static_cast<int>(rng() % frame.colorCount);
+        frame.disposal = static_cast<GifDisposal>(rng() % 4);
+        frame.indices.resize(static_cast<size_t>(frame.width) * frame.height);
+        for (auto& index : frame.indices) {
+            // Mostly valid colours, some transparent, a few past the palette
+            unsigned roll = rng() % 16;
+            if (roll == 0 && frame.transparentIndex >= 0) index = static_cast<uint8_t>(frame.transparentIndex);
+            else if (roll == 1) index = 255;
+            else index = static_cast<uint8_t>(rng() % frame.colorCount);
+        }
+        frames.push_back(std::move(frame));
+    }
+    return frames;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int canvasSize = argc > 1 ? std::stoi(argv[1]) : 256;
+    int frameCount = argc > 2 ? std::stoi(argv[2]) : 200;
+    int loops = argc > 3 ? std::stoi(argv[3]) : 5;
+    std::mt19937 rng(42);
+    std::vector<GifFrame> frames = makeFrames(canvasSize, frameCount, rng);
+
+    // Golden check: every frame of two loops, including the restart
+    GifCompositor compositor(canvasSize, canvasSize);
+    ReferenceCompositor reference(canvasSize, canvasSize);
+    size_t mismatches = 0;
+    for (int loop = 0; loop < 2; ++loop) {
+        if (loop > 0) {
+            compositor.reset();
+            reference.reset();
+        }
+        for (int i = 0; i < frameCount; ++i) {
+            compositor.apply(frames[i]);
+            reference.apply(frames[i]);
+            if (compositor.canvas() != reference.canvas()) {
+                if (mismatches == 0) std::printf("MISMATCH at loop %d frame %d (disposal %d)\n", loop, i, static_cast<int>(frames[i].disposal));
+                ++mismatches;
+            }
+        }
+    }
+    std::printf("golden check: %d frames x 2 loops, %zu mismatches\n", frameCount, mismatches);
+
+    // Timing and upload volume
+    size_t dirtyBytes = 0;
+    size_t fullBytes = 0;
+    size_t frameBytes = static_cast<size_t>(canvasSize) * canvasSize * 4;
+    auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < loops; ++loop) {
+        GifDirtyRect restarted = compositor.reset();
+        for (int i = 0; i < frameCount; ++i) {
+            GifDirtyRect dirty = compositor.apply(frames[i]);
+            if (i == 0) dirty = restarted;
+            dirtyBytes += static_cast<size_t>(dirty.width) * dirty.height * 4;
+            fullBytes += frameBytes;
+        }
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    int applied = loops * frameCount;
+
+    std::printf("canvas %dx%d, %d frames, %d loops\n", canvasSize, canvasSize, frameCount, loops);
+    std::printf("composite: %.2f us/frame\n", elapsed.count() / applied);
+    std::printf("uploaded: %.1f KB/frame dirty rect vs %.1f KB/frame whole canvas (%.1f%%)\n",
+                dirtyBytes / 1024.0 / applied, fullBytes / 1024.0 / applied, 100.0 * dirtyBytes / fullBytes);
+    std::printf("texture memory: %.2f MB one texture per frame vs %.2f MB one canvas texture\n",
+                frameBytes * frameCount / (1024.0 * 1024.0), frameBytes / (1024.0 * 1024.0));
+    return mismatches == 0 ? 0 : 1;
+}
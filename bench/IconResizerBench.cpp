@@ -0,0 +1,149 @@
+// What a web client downloads for its icons with and without "?w=": every icon in the
+// icons directory is shrunk with IconResizer for the sizes a 96 CSS px request asks for at
+// common device pixel ratios, reporting the bytes and the time to encode. Then the same
+// variants go through IconVariantCache twice, into an empty temporary directory, to show
+// the cost of the first request for a variant (encode + write) against every later one
+// (read back from disk). Fails (non-zero exit) if a variant is larger than asked for or
+// doesn't decode.
+//
+// Usage: IconResizerBench [icons_root]
+
+#include "IconVariantCache.hpp"
+#include "Utils/FileUtils.hpp"
+#include "Utils/IconResizer.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <future>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <stb_image.h>
+
+namespace fs = std::filesystem;
+
+#ifndef WEBSTREAMDECK_SOURCE_DIR
+#define WEBSTREAMDECK_SOURCE_DIR "."
+#endif
+
+namespace {
+
+constexpr double CSS_PIXELS = 96.0;
+constexpr double RATIOS[] = {1.0, 2.0, 3.0};
+
+int failures = 0;
+
+// Width and height from the file header
+bool readSize(const IconResizer::Encoded& encoded, int& width, int& height) {
+    const std::string& bytes = encoded.bytes;
+    if (encoded.format == IconResizer::Format::Gif) {
+        if (bytes.size() < 10 || bytes.compare(0, 6, "GIF89a") != 0) return false;
+        width = static_cast<unsigned char>(bytes[6]) | static_cast<unsigned char>(bytes[7]) << 8;
+        height = static_cast<unsigned char>(bytes[8]) | static_cast<unsigned char>(bytes[9]) << 8;
+        return true;
+    }
+    int channels = 0;
+    return stbi_info_from_memory(reinterpret_cast<const stbi_uc*>(bytes.data()), static_cast<int>(bytes.size()), &width,
+                                 &height, &channels) != 0;
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Waits for one variant; returns the milliseconds from request to callback
+double timeRequest(IconVariantCache& cache, const fs::path& path, int size, bool& fromOriginal) {
+    std::promise<IconVariantCache::Variant> done;
+    auto start = std::chrono::steady_clock::now();
+    cache.request(path, size, [&done](IconVariantCache::Variant variant) { done.set_value(std::move(variant)); });
+    IconVariantCache::Variant variant = done.get_future().get();
+    double elapsed = millisecondsSince(start);
+    fromOriginal = variant.useOriginal;
+    if (!variant.ok) {
+        std::printf("  [FAIL] %s at %d px could not be read\n", path.filename().string().c_str(), size);
+        ++failures;
+    }
+    return elapsed;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    fs::path iconsRoot = argc > 1 ? fs::path(argv[1]) : fs::path(WEBSTREAMDECK_SOURCE_DIR) / "assets/icons";
+    std::vector<fs::path> icons;
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(iconsRoot, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        if (it->is_regular_file(ec)) icons.push_back(it->path());
+    }
+    if (icons.empty()) {
+        std::printf("No icons in %s\n", iconsRoot.string().c_str());
+        return 1;
+    }
+
+    std::printf("%-28s %10s", "icon", "original");
+    for (double ratio : RATIOS) std::printf("   %4d px (ms)", IconVariantCache::bucketSize(CSS_PIXELS, ratio));
+    std::printf("\n");
+
+    size_t totalOriginal = 0;
+    size_t totalVariant[std::size(RATIOS)] = {};
+    for (const auto& path : icons) {
+        std::string source, error;
+        if (!FileUtils::ReadWholeFile(path, source, error)) {
+            std::printf("  [FAIL] %s: %s\n", path.string().c_str(), error.c_str());
+            ++failures;
+            continue;
+        }
+        totalOriginal += source.size();
+        std::printf("%-28s %10zu", path.filename().string().c_str(), source.size());
+        for (size_t r = 0; r < std::size(RATIOS); ++r) {
+            int size = IconVariantCache::bucketSize(CSS_PIXELS, RATIOS[r]);
+            auto start = std::chrono::steady_clock::now();
+            auto encoded = IconResizer::shrink(source, size);
+            double elapsed = millisecondsSince(start);
+            if (!encoded) { // The original is sent
+                totalVariant[r] += source.size();
+                std::printf(" %8s %5.1f", "orig", elapsed);
+                continue;
+            }
+            totalVariant[r] += encoded->bytes.size();
+            std::printf(" %8zu %5.1f", encoded->bytes.size(), elapsed);
+            int width = 0, height = 0;
+            if (!readSize(*encoded, width, height) || width != encoded->width || height != encoded->height ||
+                width > size || height > size) {
+                std::printf("\n  [FAIL] %s at %d px: %dx%d\n", path.filename().string().c_str(), size, width, height);
+                ++failures;
+            }
+        }
+        std::printf("\n");
+    }
+    std::printf("%-28s %10zu", "total", totalOriginal);
+    for (size_t r = 0; r < std::size(RATIOS); ++r) {
+        std::printf(" %8zu %4.0f%%", totalVariant[r], 100.0 * totalVariant[r] / static_cast<double>(totalOriginal));
+    }
+    std::printf("\n\n");
+
+    // Cold (encode and write) against warm (read back) through the disk cache
+    fs::path cacheDirectory = fs::temp_directory_path() / "IconResizerBench";
+    fs::remove_all(cacheDirectory, ec);
+    {
+        IconVariantCache cache(cacheDirectory);
+        int size = IconVariantCache::bucketSize(CSS_PIXELS, 2.0);
+        std::printf("IconVariantCache at %d px: %-16s %10s %10s\n", size, "", "first ms", "later ms");
+        for (const auto& path : icons) {
+            bool coldOriginal = false, warmOriginal = false;
+            double cold = timeRequest(cache, path, size, coldOriginal);
+            double warm = timeRequest(cache, path, size, warmOriginal);
+            std::printf("  %-42s %10.2f %10.2f%s\n", path.filename().string().c_str(), cold, warm,
+                        coldOriginal ? "  (original)" : "");
+            if (coldOriginal != warmOriginal) {
+                std::printf("  [FAIL] %s: the cached entry disagrees with the first result\n",
+                            path.filename().string().c_str());
+                ++failures;
+            }
+        }
+    }
+    fs::remove_all(cacheDirectory, ec);
+
+    std::printf("%d check(s) failed\n", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+// Quality and throughput of ImageResampler, without GL or stb_image. The quality checks
+// are pass/fail (non-zero exit on failure):
+//   - a flat colour stays exactly that colour at every size,
+//   - a smooth image matches the same image sampled at the smaller size (PSNR),
+//   - detail too fine for the smaller size averages out instead of aliasing,
+//   - transparent pixels don't darken the colour next to them.
+// The old path (full-size upload, GL_LINEAR minification) is emulated with a bilinear
+// sample per destination pixel for comparison. Throughput is reported per filter for
+// common icon sizes.
+//
+// Usage: ImageResamplerBench [iterations]
+
+#include "Utils/ImageResampler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+using ImageResampler::Filter;
+
+constexpr double PI = 3.14159265358979323846;
+
+struct Image {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+// Opaque grey image from a function of the pixel centre, in source pixel units
+Image makeImage(int width, int height, const std::function<double(double, double)>& value) {
+    Image image{width, height, std::vector<unsigned char>(static_cast<size_t>(width) * height * 4)};
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned char v = static_cast<unsigned char>(std::clamp(value(x + 0.5, y + 0.5), 0.0, 255.0) + 0.5);
+            unsigned char* p = &image.pixels[(static_cast<size_t>(y) * width + x) * 4];
+            p[0] = p[1] = p[2] = v;
+            p[3] = 255;
+        }
+    }
+    return image;
+}
+
+// What GL_LINEAR does when minifying without mipmaps: one bilinear sample per pixel
+Image bilinearMinify(const Image& src, int width, int height) {
+    Image dst{width, height, std::vector<unsigned char>(static_cast<size_t>(width) * height * 4)};
+    for (int y = 0; y < height; ++y) {
+        double sy = std::clamp((y + 0.5) * src.height / height - 0.5, 0.0, src.height - 1.0);
+        int y0 = static_cast<int>(sy);
+        int y1 = std::min(y0 + 1, src.height - 1);
+        double fy = sy - y0;
+        for (int x = 0; x < width; ++x) {
+            double sx = std::clamp((x + 0.5) * src.width / width - 0.5, 0.0, src.width - 1.0);
+            int x0 = static_cast<int>(sx);
+            int x1 = std::min(x0 + 1, src.width - 1);
+            double fx = sx - x0;
+            for (int c = 0; c < 4; ++c) {
+                auto at = [&](int px, int py) { return src.pixels[(static_cast<size_t>(py) * src.width + px) * 4 + c]; };
+                double top = at(x0, y0) * (1 - fx) + at(x1, y0) * fx;
+                double bottom = at(x0, y1) * (1 - fx) + at(x1, y1) * fx;
+                dst.pixels[(static_cast<size_t>(y) * width + x) * 4 + c] =
+                    static_cast<unsigned char>(top * (1 - fy) + bottom * fy + 0.5);
+            }
+        }
+    }
+    return dst;
+}
+
+// Root mean square difference of the colour channels
+double rms(const std::vector<unsigned char>& a, const std::vector<unsigned char>& b) {
+    double sum = 0.0;
+    size_t count = 0;
+    for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        if (i % 4 == 3) continue;
+        double d = static_cast<double>(a[i]) - b[i];
+        sum += d * d;
+        ++count;
+    }
+    return count ? std::sqrt(sum / count) : 0.0;
+}
+
+double psnr(double rmsError) {
+    return rmsError > 0.0 ? 20.0 * std::log10(255.0 / rmsError) : 99.0;
+}
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::printf("  [%s] %s\n", ok ? "ok" : "FAIL", what.c_str());
+    if (!ok) ++failures;
+}
+
+std::string format(const char* fmt, double a, double b = 0.0) {
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), fmt, a, b);
+    return buffer;
+}
+
+void checkQuality() {
+    std::printf("quality\n");
+    const Filter filters[] = {Filter::Box, Filter::Lanczos3};
+    const char* names[] = {"box", "lanczos3"};
+
+    // Flat colour, half transparent, at shrinking and growing ratios
+    Image flat{257, 131, {}};
+    for (int i = 0; i < flat.width * flat.height; ++i) flat.pixels.insert(flat.pixels.end(), {200, 100, 50, 128});
+    for (int f = 0; f < 2; ++f) {
+        bool exact = true;
+        for (int size : {1, 7, 64, 100, 300}) {
+            auto out = ImageResampler::resize(flat.pixels, flat.width, flat.height, size, size / 2 + 1, filters[f]);
+            for (size_t i = 0; i < out.size(); i += 4) {
+                exact &= out[i] == 200 && out[i + 1] == 100 && out[i + 2] == 50 && out[i + 3] == 128;
+            }
+        }
+        check(exact, std::string(names[f]) + ": flat colour unchanged at every size");
+    }
+
+    // Smooth: a sine well below the Nyquist frequency of the 100 px result
+    auto smooth = [](double scale) {
+        return [scale](double x, double y) {
+            return 127.5 + 100.0 * std::sin(2 * PI * x / (40.0 * scale)) * std::cos(2 * PI * y / (55.0 * scale));
+        };
+    };
+    Image smoothSource = makeImage(256, 256, smooth(256.0 / 100.0));
+    Image smoothExpected = makeImage(100, 100, smooth(1.0));
+    double bilinearPsnr = psnr(rms(bilinearMinify(smoothSource, 100, 100).pixels, smoothExpected.pixels));
+    std::printf("  smooth 256 -> 100 px, GL_LINEAR minify: %.1f dB\n", bilinearPsnr);
+    for (int f = 0; f < 2; ++f) {
+        double db = psnr(rms(ImageResampler::resize(smoothSource.pixels, 256, 256, 100, 100, filters[f]), smoothExpected.pixels));
+        check(db > 30.0, format((std::string(names[f]) + ": smooth 256 -> 100 px matches, %.1f dB (> 30)").c_str(), db));
+    }
+
+    // Fine detail: a sine of period 2.3 px can't be shown at 100 px and should become grey
+    Image stripes = makeImage(256, 256, [](double x, double) { return 127.5 + 127.5 * std::sin(2 * PI * x / 2.3); });
+    double mean = 0.0;
+    for (size_t i = 0; i < stripes.pixels.size(); i += 4) mean += stripes.pixels[i];
+    mean /= stripes.pixels.size() / 4;
+    Image grey = makeImage(100, 100, [mean](double, double) { return mean; });
+    double bilinearAlias = rms(bilinearMinify(stripes, 100, 100).pixels, grey.pixels);
+    std::printf("  stripes 256 -> 100 px, GL_LINEAR minify: %.1f RMS from grey\n", bilinearAlias);
+    for (int f = 0; f < 2; ++f) {
+        double alias = rms(ImageResampler::resize(stripes.pixels, 256, 256, 100, 100, filters[f]), grey.pixels);
+        check(alias < 16.0 && alias < bilinearAlias / 4,
+              format((std::string(names[f]) + ": stripes 256 -> 100 px average out, %.1f RMS from grey (< 16)").c_str(), alias));
+    }
+
+    // Transparent neighbours: opaque red next to transparent black stays red
+    Image edge{64, 64, {}};
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            if (x < 29) edge.pixels.insert(edge.pixels.end(), {255, 0, 0, 255});
+            else edge.pixels.insert(edge.pixels.end(), {0, 0, 0, 0});
+        }
+    }
+    for (int f = 0; f < 2; ++f) {
+        auto out = ImageResampler::resize(edge.pixels, 64, 64, 24, 24, filters[f]);
+        bool red = true;
+        for (size_t i = 0; i < out.size(); i += 4) {
+            if (out[i + 3] > 8) red &= out[i] >= 250 && out[i + 1] <= 4 && out[i + 2] <= 4;
+        }
+        check(red, std::string(names[f]) + ": no dark fringe next to transparent pixels");
+    }
+}
+
+void measureThroughput(int iterations) {
+    std::printf("throughput (source Mpixel/s)\n");
+    std::printf("  %-16s %10s %10s\n", "size", "box", "lanczos3");
+    struct Case {
+        int from;
+        int to;
+    };
+    for (Case c : {Case{128, 100}, Case{256, 100}, Case{512, 100}, Case{1024, 96}, Case{256, 200}}) {
+        Image source = makeImage(c.from, c.from, [](double x, double y) { return std::fmod(x * 7 + y * 3, 256.0); });
+        double rates[2];
+        for (int kind = 0; kind < 2; ++kind) {
+            auto start = std::chrono::steady_clock::now();
+            size_t sink = 0;
+            for (int i = 0; i < iterations; ++i) {
+                sink += ImageResampler::resize(source.pixels, c.from, c.from, c.to, c.to,
+                                               kind == 0 ? Filter::Box : Filter::Lanczos3).size();
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            rates[kind] = sink ? static_cast<double>(c.from) * c.from * iterations / elapsed.count() / 1e6 : 0.0;
+        }
+        std::string label = std::to_string(c.from) + " -> " + std::to_string(c.to);
+        std::printf("  %-16s %10.1f %10.1f\n", label.c_str(), rates[0], rates[1]);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : 50;
+    checkQuality();
+    measureThroughput(iterations);
+    std::printf("%d quality check(s) failed\n", failures);
+    return failures == 0 ? 0 : 1;
+}
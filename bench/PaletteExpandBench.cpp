@@ -0,0 +1,128 @@
+// Palette-to-RGBA row kernels, without GL or giflib. First checks that every kernel this
+// CPU supports writes exactly the same bytes as the scalar one (all row lengths up to a
+// few vectors, unaligned rows, transparent and unused palette entries), then measures
+// throughput next to the old per-pixel loop (range check, transparency check and an RGB
+// palette lookup per pixel).
+//
+// Usage: PaletteExpandBench [row_width] [rows]
+
+#include "Utils/PaletteExpand.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using PaletteExpand::Kernel;
+
+const Kernel KERNELS[] = {Kernel::Scalar, Kernel::Sse2, Kernel::Avx2};
+
+struct RgbColor {
+    uint8_t red, green, blue;
+};
+
+// What GifLoader did per pixel before the palette was baked
+void expandLegacy(const uint8_t* indices, size_t count, const RgbColor* colors, int colorCount, int transparentIndex, uint8_t* dst) {
+    for (size_t i = 0; i < count; ++i, dst += 4) {
+        int index = indices[i];
+        if (index >= colorCount) continue;
+        if (index == transparentIndex) continue;
+        const RgbColor& color = colors[index];
+        dst[0] = color.red;
+        dst[1] = color.green;
+        dst[2] = color.blue;
+        dst[3] = 255;
+    }
+}
+
+// A baked palette as GifCompositor makes it: opaque colours, alpha 0 for indices that draw nothing
+std::vector<uint32_t> makePalette(std::mt19937& rng, int colorCount, int transparentIndex) {
+    std::vector<uint32_t> palette(256, 0);
+    for (int i = 0; i < colorCount; ++i) {
+        uint8_t rgba[4] = {uint8_t(rng()), uint8_t(rng()), uint8_t(rng()), 255};
+        std::memcpy(&palette[i], rgba, 4);
+    }
+    if (transparentIndex >= 0) palette[transparentIndex] = 0;
+    return palette;
+}
+
+size_t checkBitExact(std::mt19937& rng) {
+    size_t mismatches = 0;
+    for (int round = 0; round < 200; ++round) {
+        int colorCount = 1 + static_cast<int>(rng() % 256);
+        int transparentIndex = (round % 3 == 0) ? -1 : static_cast<int>(rng() % 256);
+        std::vector<uint32_t> palette = makePalette(rng, colorCount, transparentIndex);
+
+        for (size_t count = 0; count <= 70; ++count) {
+            size_t offset = rng() % 8; // Rows start anywhere in the canvas
+            std::vector<uint8_t> indices(offset + count);
+            for (auto& index : indices) index = static_cast<uint8_t>(rng());
+            std::vector<uint8_t> canvas((offset + count) * 4 + 3);
+            for (auto& byte : canvas) byte = static_cast<uint8_t>(rng());
+
+            std::vector<uint8_t> expected = canvas;
+            PaletteExpand::expandRow(Kernel::Scalar, indices.data() + offset, count, palette.data(), expected.data() + offset * 4 + 1);
+            for (Kernel kernel : KERNELS) {
+                if (kernel == Kernel::Scalar || !PaletteExpand::isSupported(kernel)) continue;
+                std::vector<uint8_t> actual = canvas;
+                PaletteExpand::expandRow(kernel, indices.data() + offset, count, palette.data(), actual.data() + offset * 4 + 1);
+                if (actual != expected) {
+                    if (mismatches == 0) std::printf("MISMATCH: %s, %zu pixels\n", PaletteExpand::kernelName(kernel), count);
+                    ++mismatches;
+                }
+            }
+        }
+    }
+    return mismatches;
+}
+
+template <typename Fn>
+double megapixelsPerSecond(size_t width, size_t rows, Fn expand) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t row = 0; row < rows; ++row) expand(row);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(width * rows) / elapsed.count() / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t width = argc > 1 ? std::stoul(argv[1]) : 256;
+    size_t rows = argc > 2 ? std::stoul(argv[2]) : 200000;
+    std::mt19937 rng(42);
+
+    std::printf("best kernel on this CPU: %s\n", PaletteExpand::kernelName(PaletteExpand::bestKernel()));
+    size_t mismatches = checkBitExact(rng);
+    std::printf("bit-exact check against scalar: %zu mismatches\n", mismatches);
+
+    // 64 rows of indices reused over and over, like a small animation frame
+    constexpr size_t SOURCE_ROWS = 64;
+    const int colorCount = 200;
+    const int transparentIndex = 7;
+    std::vector<uint8_t> indices(width * SOURCE_ROWS);
+    for (auto& index : indices) index = static_cast<uint8_t>(rng() % 256);
+    std::vector<uint32_t> palette = makePalette(rng, colorCount, transparentIndex);
+    std::vector<RgbColor> colors(256);
+    for (int i = 0; i < 256; ++i) std::memcpy(&colors[i], &palette[i], 3);
+    std::vector<uint8_t> canvas(width * SOURCE_ROWS * 4, 0);
+
+    std::printf("%zu px rows x %zu\n", width, rows);
+    std::printf("%-8s %12s\n", "kernel", "Mpixel/s");
+    double legacy = megapixelsPerSecond(width, rows, [&](size_t row) {
+        size_t r = row % SOURCE_ROWS;
+        expandLegacy(indices.data() + r * width, width, colors.data(), colorCount, transparentIndex, canvas.data() + r * width * 4);
+    });
+    std::printf("%-8s %12.0f\n", "legacy", legacy);
+    for (Kernel kernel : KERNELS) {
+        if (!PaletteExpand::isSupported(kernel)) continue;
+        double rate = megapixelsPerSecond(width, rows, [&](size_t row) {
+            size_t r = row % SOURCE_ROWS;
+            PaletteExpand::expandRow(kernel, indices.data() + r * width, width, palette.data(), canvas.data() + r * width * 4);
+        });
+        std::printf("%-8s %12.0f  (%.1fx legacy)\n", PaletteExpand::kernelName(kernel), rate, rate / legacy);
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,510 @@
+// End-to-end press benchmark. Starts CommServer on loopback with a no-op ActionExecutor
+// backend, connects N WebSocket clients (plain POSIX sockets, no GLFW or display needed)
+// and has each of them press its own button at a fixed rate. Reports:
+//   - connection setup cost (TCP connect until initial_config has arrived),
+//   - throughput (presses sent vs. actions executed),
+//   - press -> action latency (client send until the backend runs the action),
+//   - for the binary protocol, press -> ack round trip.
+// A "main loop" thread calls processPendingActions() once per --frame-ms like main.cpp
+// does once per rendered frame. With --executor thread (the default) actions run on
+// ActionExecutor's own thread; --executor frame leaves it stopped so every action
+// waits for the next frame, which is how the app behaved before the executor thread.
+//
+// Usage: PressLatencyBench [--clients N] [--rate presses/s per client] [--duration seconds]
+//                          [--protocol json|binary] [--executor thread|frame] [--frame-ms ms] [--port P]
+
+#include "ActionExecutor.hpp"
+#include "BinaryProtocol.hpp"
+#include "CommServer.hpp"
+#include "ConfigManager.hpp"
+#include "Utils/Logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+struct Options {
+    int clients = 8;
+    double rate = 50.0;      // Presses per second, per client
+    double duration = 5.0;   // Seconds of load
+    bool binary = false;
+    bool executorThread = true;
+    double frameMs = 1000.0 / 60.0;
+    int port = 19002;
+};
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+        if (arg == "--clients" && (value = next())) options.clients = std::max(1, std::atoi(value));
+        else if (arg == "--rate" && (value = next())) options.rate = std::max(0.1, std::atof(value));
+        else if (arg == "--duration" && (value = next())) options.duration = std::max(0.1, std::atof(value));
+        else if (arg == "--protocol" && (value = next())) options.binary = std::string(value) == "binary";
+        else if (arg == "--executor" && (value = next())) options.executorThread = std::string(value) != "frame";
+        else if (arg == "--frame-ms" && (value = next())) options.frameMs = std::max(0.0, std::atof(value));
+        else if (arg == "--port" && (value = next())) options.port = std::atoi(value);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--clients N] [--rate presses/s per client] [--duration s]"
+                      << " [--protocol json|binary] [--executor thread|frame] [--frame-ms ms] [--port P]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// --- Latency statistics ---
+
+struct LatencyStats {
+    std::vector<double> samplesUs;
+
+    void add(int64_t ns) { samplesUs.push_back(static_cast<double>(ns) / 1000.0); }
+    void merge(const LatencyStats& other) {
+        samplesUs.insert(samplesUs.end(), other.samplesUs.begin(), other.samplesUs.end());
+    }
+
+    double percentile(double p) const {
+        if (samplesUs.empty()) return 0.0;
+        size_t index = static_cast<size_t>(std::ceil(p / 100.0 * samplesUs.size()));
+        return samplesUs[std::min(samplesUs.size() - 1, index == 0 ? 0 : index - 1)];
+    }
+
+    void print(const char* title) {
+        std::sort(samplesUs.begin(), samplesUs.end());
+        std::printf("%s (%zu samples)\n", title, samplesUs.size());
+        if (samplesUs.empty()) return;
+        std::printf("  p50 %.1f us  p90 %.1f us  p99 %.1f us  p99.9 %.1f us  max %.1f us\n",
+                    percentile(50), percentile(90), percentile(99), percentile(99.9), samplesUs.back());
+
+        // Power-of-two buckets, printed as a bar chart
+        std::vector<size_t> buckets(32, 0);
+        for (double us : samplesUs) {
+            size_t bucket = us < 1.0 ? 0 : std::min<size_t>(31, static_cast<size_t>(std::log2(us)) + 1);
+            ++buckets[bucket];
+        }
+        size_t peak = *std::max_element(buckets.begin(), buckets.end());
+        for (size_t b = 0; b < buckets.size(); ++b) {
+            if (buckets[b] == 0) continue;
+            double upper = std::ldexp(1.0, static_cast<int>(b));
+            int bar = static_cast<int>(50.0 * buckets[b] / peak);
+            std::printf("  < %10.0f us %8zu %s\n", upper, buckets[b], std::string(std::max(bar, 1), '#').c_str());
+        }
+    }
+};
+
+// --- Minimal blocking WebSocket client (RFC 6455, client side only) ---
+
+struct WsFrame {
+    uint8_t opcode = 0;
+    std::string payload;
+};
+
+class WsClient {
+public:
+    enum class ReadResult { Frame, Timeout, Closed };
+
+    ~WsClient() {
+        if (m_fd >= 0) ::close(m_fd);
+    }
+
+    bool connect(const std::string& host, int port) {
+        m_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (m_fd < 0) return false;
+        int one = 1;
+        ::setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        ::inet_pton(AF_INET, host.c_str(), &address.sin_addr);
+        if (::connect(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) return false;
+
+        std::string request = "GET / HTTP/1.1\r\nHost: " + host + ":" + std::to_string(port) +
+                              "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                              "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+        if (!writeAll(request)) return false;
+
+        // Read the response headers; anything after them already belongs to the first frame
+        auto deadline = Clock::now() + std::chrono::seconds(5);
+        size_t headerEnd;
+        while ((headerEnd = m_buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (Clock::now() > deadline || !receive(100)) return false;
+        }
+        bool upgraded = m_buffer.compare(0, 12, "HTTP/1.1 101") == 0;
+        m_buffer.erase(0, headerEnd + 4);
+        return upgraded;
+    }
+
+    bool send(uint8_t opcode, std::string_view payload) {
+        std::string frame;
+        frame.reserve(payload.size() + 14);
+        frame.push_back(static_cast<char>(0x80 | opcode));
+        if (payload.size() < 126) {
+            frame.push_back(static_cast<char>(0x80 | payload.size()));
+        } else if (payload.size() <= 0xFFFF) {
+            frame.push_back(static_cast<char>(0x80 | 126));
+            frame.push_back(static_cast<char>(payload.size() >> 8));
+            frame.push_back(static_cast<char>(payload.size() & 0xFF));
+        } else {
+            frame.push_back(static_cast<char>(0x80 | 127));
+            for (int shift = 56; shift >= 0; shift -= 8) frame.push_back(static_cast<char>((payload.size() >> shift) & 0xFF));
+        }
+        // Client frames must be masked
+        m_maskState = m_maskState * 1103515245u + 12345u;
+        unsigned char mask[4];
+        std::memcpy(mask, &m_maskState, 4);
+        frame.append(reinterpret_cast<const char*>(mask), 4);
+        for (size_t i = 0; i < payload.size(); ++i) {
+            frame.push_back(static_cast<char>(payload[i] ^ mask[i & 3]));
+        }
+        return writeAll(frame);
+    }
+
+    ReadResult read(WsFrame& frame, int timeoutMs) {
+        auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (true) {
+            if (parseFrame(frame)) {
+                if (frame.opcode == 0x9) { // Ping
+                    send(0xA, frame.payload);
+                    continue;
+                }
+                return frame.opcode == 0x8 ? ReadResult::Closed : ReadResult::Frame;
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+            if (remaining < 0) return ReadResult::Timeout;
+            if (!receive(static_cast<int>(remaining))) {
+                return m_closed ? ReadResult::Closed : ReadResult::Timeout;
+            }
+        }
+    }
+
+private:
+    int m_fd = -1;
+    bool m_closed = false;
+    uint32_t m_maskState = 0x9E3779B9u;
+    std::string m_buffer;
+
+    bool writeAll(std::string_view data) {
+        while (!data.empty()) {
+            ssize_t written = ::send(m_fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (written <= 0) return false;
+            data.remove_prefix(static_cast<size_t>(written));
+        }
+        return true;
+    }
+
+    // Appends whatever arrives within timeoutMs; false on timeout, error or EOF
+    bool receive(int timeoutMs) {
+        pollfd pfd{m_fd, POLLIN, 0};
+        if (::poll(&pfd, 1, timeoutMs) <= 0) return false;
+        char chunk[16384];
+        ssize_t received = ::recv(m_fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            m_closed = true;
+            return false;
+        }
+        m_buffer.append(chunk, static_cast<size_t>(received));
+        return true;
+    }
+
+    bool parseFrame(WsFrame& frame) {
+        if (m_buffer.size() < 2) return false;
+        const auto* bytes = reinterpret_cast<const unsigned char*>(m_buffer.data());
+        size_t header = 2;
+        uint64_t length = bytes[1] & 0x7F;
+        if (length == 126) {
+            if (m_buffer.size() < 4) return false;
+            length = (uint64_t(bytes[2]) << 8) | bytes[3];
+            header = 4;
+        } else if (length == 127) {
+            if (m_buffer.size() < 10) return false;
+            length = 0;
+            for (int i = 0; i < 8; ++i) length = (length << 8) | bytes[2 + i];
+            header = 10;
+        }
+        bool masked = bytes[1] & 0x80;
+        size_t maskOffset = header;
+        if (masked) header += 4;
+        if (m_buffer.size() < header + length) return false;
+
+        frame.opcode = bytes[0] & 0x0F;
+        frame.payload.assign(m_buffer, header, static_cast<size_t>(length));
+        if (masked) {
+            for (size_t i = 0; i < frame.payload.size(); ++i) frame.payload[i] ^= m_buffer[maskOffset + (i & 3)];
+        }
+        m_buffer.erase(0, header + static_cast<size_t>(length));
+        return true;
+    }
+};
+
+// --- Per-client bookkeeping shared between the client thread and the executor ---
+
+struct ClientState {
+    std::string buttonId;
+    std::vector<int64_t> sendTimesNs;  // Indexed by press number, written before `sent` is bumped
+    std::atomic<uint32_t> sent{0};
+    uint32_t executed = 0;             // Only touched by the executor thread
+    LatencyStats pressToAction;        // Only touched by the executor thread
+    LatencyStats pressToAck;           // Only touched by the client thread
+    int64_t setupNs = -1;
+    uint32_t rejectedAcks = 0;
+    bool failed = false;
+};
+
+void writeBenchConfig(const fs::path& path, int buttons) {
+    json config;
+    config["buttons"] = json::array();
+    for (int i = 0; i < buttons; ++i) {
+        config["buttons"].push_back({{"id", "bench_" + std::to_string(i)}, {"name", "Bench " + std::to_string(i)},
+                                     {"action_type", "noop"}, {"action_param", ""}, {"icon_path", ""}});
+    }
+    std::ofstream(path) << config.dump(4);
+}
+
+void runClient(const Options& options, int index, ClientState& state, std::latch& connected, std::latch& go) {
+    WsClient client;
+    WsFrame frame;
+    uint32_t layoutVersion = 0;
+    uint32_t buttonIndex = 0;
+
+    int64_t setupStart = nowNs();
+    bool ok = client.connect("127.0.0.1", options.port);
+    // Setup is complete once the layout has arrived (and, for binary, the hello was answered)
+    bool haveConfig = false;
+    bool haveHello = !options.binary;
+    if (ok && options.binary) {
+        ok = client.send(0x1, R"({"type":"hello","payload":{"binary_protocol":1}})");
+    }
+    while (ok && !(haveConfig && haveHello)) {
+        if (client.read(frame, 5000) != WsClient::ReadResult::Frame) {
+            ok = false;
+            break;
+        }
+        if (frame.opcode != 0x1) continue;
+        json message = json::parse(frame.payload, nullptr, false);
+        if (message.is_discarded()) continue;
+        std::string type = message.value("type", "");
+        if (type == "initial_config") {
+            layoutVersion = static_cast<uint32_t>(message["payload"].value("version", uint64_t{0}));
+            const auto& layout = message["payload"]["layout"];
+            for (size_t i = 0; i < layout.size(); ++i) {
+                if (layout[i].value("id", "") == state.buttonId) buttonIndex = static_cast<uint32_t>(i);
+            }
+            haveConfig = true;
+        } else if (type == "hello") {
+            haveHello = message["payload"].value("binary_protocol", 0) == 1;
+            ok = haveHello;
+        }
+    }
+    state.setupNs = ok ? nowNs() - setupStart : -1;
+    state.failed = !ok;
+    connected.count_down();
+    go.wait();
+    if (!ok) return;
+
+    const std::string jsonPress = R"({"type":"button_press","payload":{"button_id":")" + state.buttonId + R"("}})";
+    const int64_t intervalNs = static_cast<int64_t>(1e9 / options.rate);
+    const uint32_t total = static_cast<uint32_t>(state.sendTimesNs.size());
+    // Stagger clients across one interval so they don't all fire in the same instant
+    const int64_t start = nowNs() + intervalNs * index / options.clients;
+    uint32_t acked = 0;
+
+    auto handleFrame = [&]() {
+        if (frame.opcode != 0x2 || frame.payload.size() != BinaryProtocol::PRESS_ACK_SIZE) return;
+        if (acked < state.sent.load(std::memory_order_relaxed)) {
+            state.pressToAck.add(nowNs() - state.sendTimesNs[acked]);
+        }
+        ++acked;
+        if (static_cast<uint8_t>(frame.payload[1]) != static_cast<uint8_t>(BinaryProtocol::AckStatus::Accepted)) {
+            ++state.rejectedAcks;
+        }
+    };
+
+    for (uint32_t press = 0; press < total; ++press) {
+        int64_t due = start + intervalNs * press;
+        // Read acks (or anything else the server sends) until the next press is due
+        for (int64_t now = nowNs(); now < due; now = nowNs()) {
+            int waitMs = static_cast<int>((due - now) / 1000000);
+            auto result = client.read(frame, waitMs);
+            if (result == WsClient::ReadResult::Frame) handleFrame();
+            else if (result == WsClient::ReadResult::Closed) { state.failed = true; return; }
+            else if (waitMs == 0) std::this_thread::yield();
+        }
+
+        state.sendTimesNs[press] = nowNs();
+        state.sent.store(press + 1, std::memory_order_release);
+        bool sent;
+        if (options.binary) {
+            BinaryProtocol::ButtonPress message;
+            message.sequence = static_cast<uint16_t>(press);
+            message.buttonIndex = buttonIndex;
+            message.layoutVersion = layoutVersion;
+            unsigned char bytes[BinaryProtocol::BUTTON_PRESS_SIZE];
+            BinaryProtocol::encodeButtonPress(message, bytes);
+            sent = client.send(0x2, std::string_view(reinterpret_cast<const char*>(bytes), sizeof(bytes)));
+        } else {
+            sent = client.send(0x1, jsonPress);
+        }
+        if (!sent) {
+            state.failed = true;
+            return;
+        }
+    }
+
+    // Collect the remaining acks
+    auto lingerUntil = Clock::now() + std::chrono::seconds(2);
+    while (options.binary && acked < total && Clock::now() < lingerUntil) {
+        if (client.read(frame, 100) == WsClient::ReadResult::Frame) handleFrame();
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    // Per-press Info logging would otherwise dominate what we measure
+    Logger::Init();
+    Logger::SetLevel(Logger::Level::Warn);
+
+    fs::path configPath = fs::temp_directory_path() / "webstreamdeck_press_bench.json";
+    writeBenchConfig(configPath, options.clients);
+
+    std::vector<std::unique_ptr<ClientState>> clients;
+    std::unordered_map<std::string, ClientState*> clientsByButton;
+    const size_t pressesPerClient = static_cast<size_t>(std::max(1.0, options.rate * options.duration));
+    for (int i = 0; i < options.clients; ++i) {
+        auto state = std::make_unique<ClientState>();
+        state->buttonId = "bench_" + std::to_string(i);
+        state->sendTimesNs.assign(pressesPerClient, 0);
+        clientsByButton[state->buttonId] = state.get();
+        clients.push_back(std::move(state));
+    }
+
+    {
+        ConfigManager configManager(configPath.string());
+        ActionExecutor actionExecutor(configManager);
+        std::atomic<uint64_t> executedTotal{0};
+        actionExecutor.setBackend([&](const ButtonConfig& button) {
+            auto it = clientsByButton.find(button.id);
+            if (it == clientsByButton.end()) return;
+            ClientState& state = *it->second;
+            // Each client presses only its own button and the queue is FIFO, so the
+            // k-th execution for a button belongs to the k-th press of that client
+            uint32_t press = state.executed++;
+            if (press < state.sent.load(std::memory_order_acquire)) {
+                state.pressToAction.add(nowNs() - state.sendTimesNs[press]);
+            }
+            executedTotal.fetch_add(1, std::memory_order_relaxed);
+        });
+
+        CommServer server(configManager);
+        server.set_button_press_handler([&actionExecutor](std::string_view buttonId) {
+            actionExecutor.requestAction(buttonId);
+        });
+        if (!server.start(options.port, "127.0.0.1")) {
+            std::cerr << "Could not start CommServer on 127.0.0.1:" << options.port << std::endl;
+            return 1;
+        }
+
+        if (options.executorThread) actionExecutor.start();
+
+        // Stand-in for the GUI main loop
+        std::atomic<bool> stopMainLoop{false};
+        std::thread mainLoop([&]() {
+            auto frame = std::chrono::duration<double, std::milli>(options.frameMs);
+            while (!stopMainLoop.load(std::memory_order_relaxed)) {
+                actionExecutor.processPendingActions();
+                if (options.frameMs > 0) std::this_thread::sleep_for(frame);
+                else std::this_thread::yield();
+            }
+        });
+
+        std::latch connected(options.clients);
+        std::latch go(1);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < options.clients; ++i) {
+            threads.emplace_back(runClient, std::cref(options), i, std::ref(*clients[i]), std::ref(connected), std::ref(go));
+        }
+        connected.wait();
+        auto loadStart = Clock::now();
+        go.count_down();
+        for (auto& thread : threads) thread.join();
+        std::chrono::duration<double> sendSeconds = Clock::now() - loadStart;
+
+        // Let the executor catch up (bounded, so a hopeless backlog still terminates)
+        uint64_t sentTotal = 0;
+        for (const auto& state : clients) sentTotal += state->sent.load();
+        auto drainUntil = Clock::now() + std::chrono::seconds(10);
+        while (executedTotal.load() < sentTotal && Clock::now() < drainUntil) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        std::chrono::duration<double> totalSeconds = Clock::now() - loadStart;
+        stopMainLoop = true;
+        mainLoop.join();
+        server.stop();
+        actionExecutor.stop();
+
+        LatencyStats setup, pressToAction, pressToAck;
+        int failedClients = 0;
+        uint32_t rejected = 0;
+        for (const auto& state : clients) {
+            if (state->setupNs >= 0) setup.add(state->setupNs);
+            if (state->failed) ++failedClients;
+            pressToAction.merge(state->pressToAction);
+            pressToAck.merge(state->pressToAck);
+            rejected += state->rejectedAcks;
+        }
+
+        std::printf("Clients: %d, protocol: %s, executor: %s, rate: %.1f presses/s per client (%.1f/s total), duration: %.1f s, frame: %.2f ms\n",
+                    options.clients, options.binary ? "binary" : "json", options.executorThread ? "thread" : "frame",
+                    options.rate, options.rate * options.clients, options.duration, options.frameMs);
+        if (failedClients > 0) std::printf("Failed clients: %d\n", failedClients);
+        std::printf("Presses sent: %llu (%.1f/s), actions executed: %llu (%.1f/s), not executed: %llu\n",
+                    static_cast<unsigned long long>(sentTotal), sentTotal / sendSeconds.count(),
+                    static_cast<unsigned long long>(executedTotal.load()), executedTotal.load() / totalSeconds.count(),
+                    static_cast<unsigned long long>(sentTotal - std::min<uint64_t>(sentTotal, executedTotal.load())));
+        if (actionExecutor.droppedCount() > 0) {
+            std::printf("Dropped by the action queue (full): %llu\n", static_cast<unsigned long long>(actionExecutor.droppedCount()));
+        }
+        if (options.binary) std::printf("Rejected acks: %u\n", rejected);
+        setup.print("Connection setup (TCP connect -> initial_config)");
+        pressToAction.print("Press -> action latency");
+        if (options.binary) pressToAck.print("Press -> ack round trip");
+    }
+
+    fs::remove(configPath);
+    Logger::Shutdown();
+    return 0;
+}
@@ -0,0 +1,185 @@
+// How the icon texture budget behaves for a multi-page deck, without a GL context.
+// Pages are visited with a skewed (Zipf) popularity, like a deck with a few busy pages
+// and many rarely opened folders; each visit draws the page for a few frames. For a range
+// of budgets it reports the hit rate, the icon reloads and evictions, and the peak
+// texture memory as allocated. Budget 0 is what the grid did before the budget existed:
+// only the page being shown keeps its icons.
+//
+// GIFs get a canvas texture each. Static icons all have the same size here, so the atlas
+// is modelled as pages of SLOTS_PER_PAGE slots, each costing a full IconAtlas page for as
+// long as one icon is on it, and compacted the way IconAtlas::compact() does.
+//
+// Usage: TextureResidencyBench [pages] [visits]
+
+#include "TextureResidency.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr int ICONS_PER_PAGE = 16;
+constexpr int FRAMES_PER_VISIT = 30;
+constexpr size_t PAGE_BYTES = 1024u * 1024 * 4;  // IconAtlas::PAGE_BYTES
+constexpr int SLOTS_PER_PAGE = (1024 / 102) * (1024 / 102);
+
+struct Icon {
+    std::string path;
+    size_t bytes;
+    bool gif;
+};
+
+// 100 px icons packed with padding, and every eighth one a 256x256 GIF canvas
+std::vector<std::vector<Icon>> makeDeck(int pages) {
+    std::vector<std::vector<Icon>> deck(pages);
+    for (int page = 0; page < pages; ++page) {
+        for (int i = 0; i < ICONS_PER_PAGE; ++i) {
+            bool gif = (page * ICONS_PER_PAGE + i) % 8 == 0;
+            std::string path = "icons/page" + std::to_string(page) + "_" + std::to_string(i) + (gif ? ".gif" : ".png");
+            deck[page].push_back({path, gif ? 256u * 256 * 4 : 102u * 102 * 4, gif});
+        }
+    }
+    return deck;
+}
+
+// Which atlas page each static icon is on; pages are deleted when their last icon goes
+class SlotAtlas {
+public:
+    uint64_t add(const std::string& path) {
+        size_t page = 0;
+        while (page < m_pages.size() && (m_pages[page].icons == 0 || m_pages[page].icons == SLOTS_PER_PAGE)) ++page;
+        if (page == m_pages.size()) {
+            page = std::find_if(m_pages.begin(), m_pages.end(), [](const Page& p) { return p.icons == 0; }) - m_pages.begin();
+            if (page == m_pages.size()) m_pages.emplace_back();
+            m_pages[page].textureId = m_nextTextureId++;
+        }
+        ++m_pages[page].icons;
+        m_iconPage[path] = page;
+        return m_pages[page].textureId;
+    }
+
+    void release(const std::string& path) {
+        auto it = m_iconPage.find(path);
+        if (it == m_iconPage.end()) return;
+        --m_pages[it->second].icons;
+        m_iconPage.erase(it);
+    }
+
+    // Empties the pages under half full into the fullest ones that have room, if all
+    // their icons fit; reports every move to `residency`
+    void compact(TextureResidency& residency) {
+        std::vector<size_t> order;
+        for (size_t page = 0; page < m_pages.size(); ++page) {
+            if (m_pages[page].icons > 0) order.push_back(page);
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return m_pages[a].icons < m_pages[b].icons; });
+        for (size_t n = 0; n + 1 < order.size() && m_pages[order[n]].icons < SLOTS_PER_PAGE / 2; ++n) {
+            size_t source = order[n];
+            int room = 0;
+            for (size_t m = n + 1; m < order.size(); ++m) room += SLOTS_PER_PAGE - m_pages[order[m]].icons;
+            if (room < m_pages[source].icons) continue;
+            for (auto& [path, page] : m_iconPage) {
+                if (page != source) continue;
+                size_t m = order.size() - 1;
+                while (m_pages[order[m]].icons == SLOTS_PER_PAGE) --m;
+                page = order[m];
+                ++m_pages[page].icons;
+                --m_pages[source].icons;
+                residency.move(path, m_pages[page].textureId, PAGE_BYTES);
+            }
+        }
+    }
+
+private:
+    struct Page {
+        uint64_t textureId = 0;
+        int icons = 0;
+    };
+    std::vector<Page> m_pages;
+    std::unordered_map<std::string, size_t> m_iconPage;
+    uint64_t m_nextTextureId = 1;
+};
+
+std::vector<int> makeVisits(int pages, int visits, std::mt19937& rng) {
+    std::vector<double> weights(pages);
+    for (int page = 0; page < pages; ++page) weights[page] = 1.0 / (page + 1); // Zipf, s = 1
+    std::discrete_distribution<int> pick(weights.begin(), weights.end());
+    std::vector<int> order(visits);
+    for (auto& page : order) page = pick(rng);
+    return order;
+}
+
+struct Result {
+    TextureResidency::Stats stats;
+    size_t peakBytes = 0;
+    double nsPerDraw = 0.0;
+};
+
+// Drives TextureResidency the way UIButtonGridWindow does; a missing icon is loaded at once
+Result run(const std::vector<std::vector<Icon>>& deck, const std::vector<int>& visits, size_t budget) {
+    TextureResidency residency(budget);
+    SlotAtlas atlas;
+    uint64_t nextGifTextureId = 1ull << 32; // Apart from the atlas pages
+    Result result;
+    size_t draws = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int page : visits) {
+        for (int frame = 0; frame < FRAMES_PER_VISIT; ++frame) {
+            std::vector<std::string> evicted = residency.evict(); // The grid releases these textures
+            for (const auto& path : evicted) atlas.release(path);
+            if (!evicted.empty() && residency.overBudget()) atlas.compact(residency);
+            residency.beginFrame();
+            for (const Icon& icon : deck[page]) {
+                if (!residency.touch(icon.path)) {
+                    residency.countMiss();
+                    if (icon.gif) {
+                        residency.add(icon.path, nextGifTextureId++, icon.bytes);
+                    } else {
+                        residency.add(icon.path, atlas.add(icon.path), PAGE_BYTES);
+                    }
+                }
+                ++draws;
+            }
+            result.peakBytes = std::max(result.peakBytes, residency.stats().residentBytes);
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    result.nsPerDraw = elapsed.count() / static_cast<double>(draws);
+    result.stats = residency.stats();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int pages = argc > 1 ? std::stoi(argv[1]) : 40;
+    int visitCount = argc > 2 ? std::stoi(argv[2]) : 5000;
+    std::mt19937 rng(42);
+    auto deck = makeDeck(pages);
+    auto visits = makeVisits(pages, visitCount, rng);
+
+    size_t deckBytes = 0;
+    for (const auto& page : deck) {
+        for (const auto& icon : page) deckBytes += icon.bytes;
+    }
+    constexpr double MIB = 1024.0 * 1024.0;
+    std::printf("%d pages x %d icons (%.1f MB of pixels), %d visits of %d frames\n", pages, ICONS_PER_PAGE,
+                deckBytes / MIB, visitCount, FRAMES_PER_VISIT);
+    std::printf("%-12s %9s %10s %10s %10s %10s\n", "budget", "hit rate", "reloads", "evictions", "peak MB", "ns/draw");
+
+    const size_t budgetsMb[] = {0, 4, 8, 16, 32, 64};
+    for (size_t budgetMb : budgetsMb) {
+        Result result = run(deck, visits, budgetMb * 1024 * 1024);
+        std::string label = budgetMb == 0 ? "page only" : std::to_string(budgetMb) + " MB";
+        std::printf("%-12s %8.2f%% %10llu %10llu %10.1f %10.1f\n", label.c_str(), result.stats.hitRate() * 100.0,
+                    static_cast<unsigned long long>(result.stats.misses),
+                    static_cast<unsigned long long>(result.stats.evictions), result.peakBytes / MIB, result.nsPerDraw);
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+# Generates TranslationKeys.hpp from the reference language file (assets/lang/en.json).
+# Every top-level key becomes a TrKey enumerator, so UI code names its strings at
+# compile time and TranslationManager resolves them with an array index.
+#
+# Usage: cmake -DLANG_FILE=<en.json> -DOUTPUT=<TranslationKeys.hpp> -P GenerateTranslationKeys.cmake
+
+cmake_minimum_required(VERSION 3.19) # string(JSON)
+
+if(NOT LANG_FILE OR NOT OUTPUT)
+    message(FATAL_ERROR "GenerateTranslationKeys.cmake needs -DLANG_FILE=... and -DOUTPUT=...")
+endif()
+
+file(READ "${LANG_FILE}" LANG_JSON)
+string(JSON KEY_COUNT ERROR_VARIABLE JSON_ERROR LENGTH "${LANG_JSON}")
+if(JSON_ERROR)
+    message(FATAL_ERROR "Could not parse ${LANG_FILE}: ${JSON_ERROR}")
+endif()
+
+set(KEYS "")
+if(KEY_COUNT GREATER 0)
+    math(EXPR LAST_INDEX "${KEY_COUNT} - 1")
+    foreach(INDEX RANGE ${LAST_INDEX})
+        string(JSON KEY MEMBER "${LANG_JSON}" ${INDEX})
+        if(NOT KEY MATCHES "^[a-z_][a-z0-9_]*$")
+            message(FATAL_ERROR "Translation key '${KEY}' in ${LANG_FILE} is not a valid identifier (use snake_case)")
+        endif()
+        list(APPEND KEYS "${KEY}")
+    endforeach()
+endif()
+# Sorted, so TranslationManager can binary search TR_KEY_NAMES for runtime keys
+list(SORT KEYS)
+list(REMOVE_DUPLICATES KEYS)
+list(LENGTH KEYS KEY_COUNT)
+
+set(ENUMERATORS "")
+set(NAMES "")
+foreach(KEY IN LISTS KEYS)
+    string(APPEND ENUMERATORS "    ${KEY},\n")
+    string(APPEND NAMES "    \"${KEY}\",\n")
+endforeach()
+
+set(CONTENT "// Generated by cmake/GenerateTranslationKeys.cmake from assets/lang/en.json. Do not edit.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+enum class TrKey : uint16_t {
+${ENUMERATORS}};
+
+inline constexpr size_t TR_KEY_COUNT = ${KEY_COUNT};
+
+// Key names, indexed by TrKey and sorted
+inline constexpr std::array<std::string_view, TR_KEY_COUNT> TR_KEY_NAMES = {
+${NAMES}};
+")
+
+# Leave the file (and its timestamp) alone when nothing changed, so editing a translation
+# doesn't rebuild every window
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" EXISTING)
+    if(EXISTING STREQUAL CONTENT)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${CONTENT}")
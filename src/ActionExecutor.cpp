@@ -1,7 +1,9 @@
 #include "ActionExecutor.hpp"
 #include "ConfigManager.hpp"
+#ifdef _WIN32
 #include "InputUtils.hpp" // Needed for SimulateMediaKeyPress and TryCaptureHotkey
-#include <iostream> // For error reporting
+#endif
+#include "Utils/Logger.hpp"
 #include <optional>
 #include <string> // Needed for wstring conversion
 #include <vector> // Needed for wstring conversion buffer & INPUT array
@@ -9,12 +11,15 @@
 #include <sstream>   // For splitting string
 #include <map>       // For key mapping
 #include <mutex>     // For thread safety
+#include <utility>
+#include <chrono>
 
 // Platform specific includes for actions
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <shellapi.h> // For ShellExecute
+#include <objbase.h>  // For CoInitializeEx on the executor thread
 #else
 // Add includes for Linux/macOS process creation and URL opening later if needed
 #include <cstdlib> // For system()
@@ -108,7 +113,7 @@ WORD StringToVkCode(const std::string& keyName) {
     if (upperKeyName == "'" || upperKeyName == "\"") return VK_OEM_7; // Single/double quote
     if (upperKeyName == ";" || upperKeyName == ":") return VK_OEM_1; // Semicolon/colon
 
-    std::cerr << "Warning: Unknown key name '" << keyName << "'" << std::endl;
+    Logger::Warn("Unknown key name '{}'", keyName);
     return 0; // Return 0 for unknown keys
 }
 #endif // _WIN32
@@ -119,68 +124,180 @@ ActionExecutor::ActionExecutor(ConfigManager& configManager)
 {
 }
 
+ActionExecutor::~ActionExecutor()
+{
+    stop();
+}
+
+void ActionExecutor::start()
+{
+    if (m_running.exchange(true)) return;
+    m_stopRequested = false;
+    m_thread = std::thread(&ActionExecutor::executorLoop, this);
+}
+
+void ActionExecutor::stop()
+{
+    if (!m_running.load()) return;
+    m_stopRequested = true;
+    m_queue.wake();
+    if (m_thread.joinable()) m_thread.join();
+    m_running = false;
+}
+
+ActionAffinity ActionExecutor::affinityFor(const std::string& actionType)
+{
+    // The Core Audio endpoint is created in the main thread's COM apartment
+    // (InputUtils::InitializeAudioControl), so it must only be used from there
+    if (actionType == "media_volume_up" || actionType == "media_volume_down" || actionType == "media_mute") {
+        return ActionAffinity::MainThread;
+    }
+    return ActionAffinity::Executor;
+}
+
 // Called from WebSocket thread (or any thread)
-void ActionExecutor::requestAction(const std::string& buttonId)
+bool ActionExecutor::requestAction(std::string_view buttonId)
 {
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-    m_actionQueue.push(buttonId);
-    std::cout << "Queued action request for button ID: " << buttonId << std::endl;
+    // Intern the id now so the queue only carries plain indices; index and
+    // generation come from the same snapshot
+    auto snapshot = m_configManager.getSnapshot();
+    QueuedAction action;
+    action.generation = static_cast<uint32_t>(snapshot->generation);
+    auto index = snapshot->indexOf(buttonId);
+    if (!index) {
+        Logger::Error("Error queueing action: Button with ID '{}' not found.", buttonId);
+        return false;
+    }
+    action.buttonIndex = *index;
+    action.enqueuedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    if (!m_queue.push(action)) {
+        Logger::Warn("Action queue full, dropping press for button ID: {}", buttonId);
+        return false;
+    }
+    Logger::Debug("Queued action request for button ID: {}", buttonId);
+    return true;
 }
 
-// Called from the main thread in the main loop
-void ActionExecutor::processPendingActions()
+void ActionExecutor::setBackend(ActionBackend backend)
+{
+    m_backend = std::move(backend);
+}
+
+void ActionExecutor::setMainThreadWakeup(std::function<void()> wakeup)
+{
+    m_mainThreadWakeup = std::move(wakeup);
+}
+
+void ActionExecutor::executorLoop()
 {
-    std::string buttonIdToProcess;
-    bool actionFound = false;
-
-    // Check queue quickly while locked
-    {
-        std::lock_guard<std::mutex> lock(m_queueMutex);
-        if (!m_actionQueue.empty()) {
-            buttonIdToProcess = m_actionQueue.front();
-            m_actionQueue.pop();
-            actionFound = true;
+#ifdef _WIN32
+    // ShellExecute may use COM (shell extensions), so give this thread its own apartment
+    HRESULT comResult = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
+#endif
+    QueuedAction action;
+    while (!m_stopRequested.load(std::memory_order_acquire)) {
+        // Drain everything queued so far; presses keep arriving while we execute
+        while (!m_stopRequested.load(std::memory_order_relaxed) && m_queue.pop(action)) {
+            dispatchAction(action);
         }
+        if (m_stopRequested.load(std::memory_order_acquire)) break;
+        m_queue.wait();
     }
+#ifdef _WIN32
+    if (SUCCEEDED(comResult)) CoUninitialize();
+#endif
+}
 
-    // Execute action outside the lock
-    if (actionFound) {
-        executeActionInternal(buttonIdToProcess);
+const ButtonConfig* ActionExecutor::resolveAction(const ConfigSnapshot& snapshot, const QueuedAction& action)
+{
+    if (static_cast<uint32_t>(snapshot.generation) != action.generation || action.buttonIndex >= snapshot.buttons.size()) {
+        m_stale.fetch_add(1, std::memory_order_relaxed);
+        Logger::Warn("Skipping action for button #{}: configuration changed after it was pressed.", action.buttonIndex);
+        return nullptr;
     }
+    return &snapshot.buttons[action.buttonIndex];
 }
 
-// Renamed: Contains the original execution logic, called only from main thread
-void ActionExecutor::executeActionInternal(const std::string& buttonId)
+void ActionExecutor::dispatchAction(const QueuedAction& action)
 {
-    auto buttonConfigOpt = m_configManager.getButtonById(buttonId);
-    if (!buttonConfigOpt) {
-        std::cerr << "Error executing action: Button with ID '" << buttonId << "' not found." << std::endl;
+    auto snapshot = m_configManager.getSnapshot();
+    const ButtonConfig* config = resolveAction(*snapshot, action);
+    if (!config) return;
+
+    if (affinityFor(config->action_type) == ActionAffinity::MainThread) {
+        if (!m_mainThreadQueue.push(action)) {
+            Logger::Warn("Main-thread action queue full, dropping action for button ID: {}", config->id);
+            return;
+        }
+        if (m_mainThreadWakeup) m_mainThreadWakeup();
         return;
     }
+    executeActionInternal(*config, action);
+}
 
-    const ButtonConfig& config = *buttonConfigOpt;
+// Called from the main thread in the main loop
+void ActionExecutor::processPendingActions()
+{
+    QueuedAction action;
+    std::shared_ptr<const ConfigSnapshot> snapshot;
+    // Without the executor thread, everything runs here (headless tools, startup)
+    if (!m_running.load(std::memory_order_relaxed)) {
+        while (m_queue.pop(action)) {
+            if (!snapshot) snapshot = m_configManager.getSnapshot();
+            if (const ButtonConfig* config = resolveAction(*snapshot, action)) {
+                executeActionInternal(*config, action);
+            }
+        }
+    }
+
+    while (m_mainThreadQueue.pop(action)) {
+        if (!snapshot) snapshot = m_configManager.getSnapshot();
+        if (const ButtonConfig* config = resolveAction(*snapshot, action)) {
+            executeActionInternal(*config, action);
+        }
+    }
+}
+
+// Runs on the executor thread, or on the main thread for MainThread-affinity actions
+void ActionExecutor::executeActionInternal(const ButtonConfig& config, const QueuedAction& action)
+{
+    const std::string& buttonId = config.id;
     const std::string& actionType = config.action_type;
     const std::string& actionParam = config.action_param;
 
-    std::cout << "Executing action for button '" << buttonId 
-              << "' (on main thread): Type='" << actionType 
-              << "', Param='" << actionParam << "'" << std::endl;
+    int64_t queuedUs = (std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count() - action.enqueuedNs) / 1000;
+    Logger::Debug("Action for button '{}' waited {} us in the queue", buttonId, queuedUs);
+    Logger::Info("Executing action for button '{}': Type='{}', Param='{}'", buttonId, actionType, actionParam);
+
+    if (m_backend) {
+        m_backend(config);
+        return;
+    }
+
+    if (actionType == OPEN_FOLDER_ACTION) {
+        // Navigation only; the web client and the button grid open the page themselves
+        Logger::Debug("Button '{}' opens page '{}'; nothing to execute.", buttonId, actionParam);
+        return;
+    }
 
-    // --- Action Logic (remains largely the same, but now runs on main thread) ---
+    // --- Action Logic ---
+#ifdef _WIN32
     if (actionType == "launch_app") {
         // Using ShellExecute for more flexibility (e.g., opening documents)
         HINSTANCE result = ShellExecuteA(NULL, "open", actionParam.c_str(), NULL, NULL, SW_SHOWNORMAL);
         if ((intptr_t)result <= 32) { // ShellExecute returns value > 32 on success
-            std::cerr << "Error executing launch_app: Failed to launch '" << actionParam << "' (Error code: " << (intptr_t)result << ")" << std::endl;
+            Logger::Error("Error executing launch_app: Failed to launch '{}' (Error code: {})", actionParam, (intptr_t)result);
         }
     } else if (actionType == "open_url") {
         HINSTANCE result = ShellExecuteA(NULL, "open", actionParam.c_str(), NULL, NULL, SW_SHOWNORMAL);
         if ((intptr_t)result <= 32) {
-             std::cerr << "Error executing open_url: Failed to open '" << actionParam << "' (Error code: " << (intptr_t)result << ")" << std::endl;
+             Logger::Error("Error executing open_url: Failed to open '{}' (Error code: {})", actionParam, (intptr_t)result);
         }
     } else if (actionType == "hotkey") {
         // --- ADDED: Hotkey Simulation Logic ---
-#ifdef _WIN32
         std::vector<WORD> modifierCodes;
         WORD mainKeyCode = 0;
 
@@ -196,7 +313,7 @@ void ActionExecutor::executeActionInternal(const std::string& buttonId)
 
             WORD vk = StringToVkCode(segment);
             if (vk == 0) {
-                 std::cerr << "Error: Invalid key name '" << segment << "' in hotkey string: " << actionParam << std::endl;
+                 Logger::Error("Invalid key name '{}' in hotkey string: {}", segment, actionParam);
                  return; // Stop processing this action
             }
 
@@ -211,7 +328,7 @@ void ActionExecutor::executeActionInternal(const std::string& buttonId)
                 if (!found) modifierCodes.push_back(generic_vk);
             } else {
                 if (mainKeyCode != 0) {
-                    std::cerr << "Error: Multiple non-modifier keys specified in hotkey string: " << actionParam << std::endl;
+                    Logger::Error("Multiple non-modifier keys specified in hotkey string: {}", actionParam);
                     return; // Only one main key allowed
                 }
                 mainKeyCode = vk;
@@ -219,7 +336,7 @@ void ActionExecutor::executeActionInternal(const std::string& buttonId)
         }
 
         if (mainKeyCode == 0) {
-            std::cerr << "Error: No main key specified in hotkey string: " << actionParam << std::endl;
+            Logger::Error("No main key specified in hotkey string: {}", actionParam);
             return; // Must have a main key
         }
 
@@ -263,7 +380,7 @@ void ActionExecutor::executeActionInternal(const std::string& buttonId)
         if (inputIndex > 0) {
              UINT sent = SendInput(static_cast<UINT>(inputIndex), inputs.data(), sizeof(INPUT));
              if (sent != inputIndex) {
-                 std::cerr << "Error: SendInput failed to send all key events for hotkey '" << actionParam << "'. Error code: " << GetLastError() << std::endl;
+                 Logger::Error("SendInput failed to send all key events for hotkey '{}'. Error code: {}", actionParam, GetLastError());
                  // Attempt to release keys that might be stuck (best effort)
                  for(size_t i = 0; i < inputIndex; ++i) {
                      if (inputs[i].ki.dwFlags == 0) { // If it was a key down
@@ -272,60 +389,61 @@ void ActionExecutor::executeActionInternal(const std::string& buttonId)
                      }
                  }
              } else {
-                 std::cout << "Executed hotkey: " << actionParam << std::endl;
+                 Logger::Info("Executed hotkey: {}", actionParam);
              }
         } else {
-             std::cerr << "Error: No valid inputs generated for hotkey: " << actionParam << std::endl;
+             Logger::Error("No valid inputs generated for hotkey: {}", actionParam);
         }
-#else
-        std::cerr << "Error: Hotkey action is currently only supported on Windows." << std::endl;
-#endif
         // --- END Hotkey Simulation Logic ---
     } 
-    // --- Handle Media Key Actions (Now running on main thread) ---
+    // --- Volume/mute use Core Audio and run on the main thread (see affinityFor) ---
     else if (actionType == "media_volume_up") {
-        std::cout << "Executing: Media Volume Up (Core Audio) x2" << std::endl;
+        Logger::Info("Executing: Media Volume Up (Core Audio) x2");
         // Call the function twice
         bool success1 = InputUtils::IncreaseMasterVolume();
         bool success2 = InputUtils::IncreaseMasterVolume(); 
         if (!success1 || !success2) { // Log if either call failed
-             std::cerr << "Failed to increase volume (at least one step failed)." << std::endl;
+             Logger::Error("Failed to increase volume (at least one step failed).");
         }
     }
     else if (actionType == "media_volume_down") {
         // Keep volume down as single step unless requested otherwise
-        std::cout << "Executing: Media Volume Down (Core Audio)" << std::endl;
+        Logger::Info("Executing: Media Volume Down (Core Audio)");
         if (!InputUtils::DecreaseMasterVolume()) {
-             std::cerr << "Failed to decrease volume." << std::endl;
+             Logger::Error("Failed to decrease volume.");
         }
     }
     else if (actionType == "media_mute") {
-        std::cout << "Executing: Media Mute Toggle (Core Audio)" << std::endl;
+        Logger::Info("Executing: Media Mute Toggle (Core Audio)");
         if (!InputUtils::ToggleMasterMute()) {
-             std::cerr << "Failed to toggle mute." << std::endl;
+             Logger::Error("Failed to toggle mute.");
         }
     }
-    // --- Media keys using SimulateKeyPress (should be safe on main thread too) ---
+    // --- Media keys using SimulateKeyPress (SendInput works from any thread) ---
     else if (actionType == "media_play_pause") {
-        std::cout << "Executing: Media Play/Pause (Simulate Key)" << std::endl;
+        Logger::Info("Executing: Media Play/Pause (Simulate Key)");
         InputUtils::SimulateMediaKeyPress(VK_MEDIA_PLAY_PAUSE);
     }
     else if (actionType == "media_next_track") {
-        std::cout << "Executing: Media Next Track (Simulate Key)" << std::endl;
+        Logger::Info("Executing: Media Next Track (Simulate Key)");
         InputUtils::SimulateMediaKeyPress(VK_MEDIA_NEXT_TRACK);
     }
     else if (actionType == "media_prev_track") {
-        std::cout << "Executing: Media Previous Track (Simulate Key)" << std::endl;
+        Logger::Info("Executing: Media Previous Track (Simulate Key)");
         InputUtils::SimulateMediaKeyPress(VK_MEDIA_PREV_TRACK);
     }
     else if (actionType == "media_stop") {
-        std::cout << "Executing: Media Stop (Simulate Key)" << std::endl;
+        Logger::Info("Executing: Media Stop (Simulate Key)");
         InputUtils::SimulateMediaKeyPress(VK_MEDIA_STOP);
     }
     // --- END of Media Key Actions ---
     else {
-        std::cerr << "Error: Unknown action type '" << actionType << "' for button ID '" << buttonId << "'" << std::endl;
+        Logger::Error("Unknown action type '{}' for button ID '{}'", actionType, buttonId);
     }
+#else
+    // Launching apps, hotkeys and media keys are implemented with Win32 APIs only
+    Logger::Error("Action type '{}' for button ID '{}' is currently only supported on Windows.", actionType, buttonId);
+#endif
 }
 
 // --- executeHotkey Implementation (if exists) should also be called from Internal ---
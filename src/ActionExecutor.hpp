@@ -1,31 +1,83 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include "ConfigManager.hpp" // Include ConfigManager to access button configs
-#include <queue>      // For std::queue
-#include <mutex>      // For std::mutex
+#include "ActionQueue.hpp"   // Lock-free queue of pending presses
+#include <thread>
+#include <atomic>
+#include <functional> // For std::function
+
+// Replaces the platform actions (launching apps, hotkeys, media keys) when set.
+// Used by the headless benchmarks; runs on whichever thread the action's affinity selects.
+using ActionBackend = std::function<void(const ButtonConfig&)>;
+
+// Where an action type has to run
+enum class ActionAffinity {
+    Executor,   // The executor thread (launching apps, URLs, hotkeys, media keys)
+    MainThread  // The UI/main thread, via processPendingActions()
+};
 
 class ActionExecutor
 {
 public:
     // Constructor takes a reference to ConfigManager
     explicit ActionExecutor(ConfigManager& configManager);
+    ~ActionExecutor();
+
+    // Starts the executor thread. Until then (or without it) every action runs
+    // from processPendingActions().
+    void start();
+    // Stops the executor thread; queued actions that have not started are discarded.
+    void stop();
 
-    // Renamed: Now queues the action request from any thread
-    void requestAction(const std::string& buttonId);
+    // Queues the action request from any thread and wakes the executor. Never blocks
+    // or allocates; returns false if the button is unknown or the queue is full.
+    bool requestAction(std::string_view buttonId);
 
-    // ADDED: Processes pending actions on the calling thread (should be main thread)
+    // Runs the actions that need the main thread (all of them if the executor
+    // thread is not running). Call from the main loop.
     void processPendingActions();
 
+    // Called (from the executor thread) when main-thread work was queued, so an
+    // idle main loop can wake up, e.g. glfwPostEmptyEvent
+    void setMainThreadWakeup(std::function<void()> wakeup);
+
+    static ActionAffinity affinityFor(const std::string& actionType);
+
+    // Presses rejected because the queue was full
+    uint64_t droppedCount() const { return m_queue.dropped(); }
+    // Presses skipped because the configuration changed before they ran
+    uint64_t staleCount() const { return m_stale.load(std::memory_order_relaxed); }
+
+    // Route actions to a custom backend instead of the OS (set before actions are queued)
+    void setBackend(ActionBackend backend);
+
 private:
     ConfigManager& m_configManager; // Store a reference to access config
     
-    // ADDED: Thread-safe queue for action requests
-    std::queue<std::string> m_actionQueue;
-    std::mutex m_queueMutex;
+    // Requests from any thread; consumed by the executor thread (or by
+    // processPendingActions() while the executor is not running)
+    ActionQueue m_queue{1024};
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stopRequested{false};
+    std::atomic<uint64_t> m_stale{0};
+
+    // Actions marshalled back to the main thread (single producer: the executor)
+    ActionQueue m_mainThreadQueue{256};
+    std::function<void()> m_mainThreadWakeup;
+
+    ActionBackend m_backend; // Empty: execute the real platform action
 
-    // ADDED: The actual execution logic, called by processPendingActions
-    void executeActionInternal(const std::string& buttonId);
+    void executorLoop();
+    // Runs or forwards one request depending on its affinity (executor thread)
+    void dispatchAction(const QueuedAction& action);
+    // Resolves a queued press to its button in `snapshot`, nullptr (counted as stale)
+    // if the configuration moved on since the press was queued
+    const ButtonConfig* resolveAction(const ConfigSnapshot& snapshot, const QueuedAction& action);
+    // The actual execution logic
+    void executeActionInternal(const ButtonConfig& config, const QueuedAction& action);
 
     // Private helper methods for specific action types (optional)
     bool executeLaunchApp(const std::string& path);
@@ -0,0 +1,88 @@
+#include "ActionQueue.hpp"
+
+// Each cell's sequence says whose turn it is: == position means free for the producer
+// that claims `position`, == position + 1 means filled and ready for the consumer.
+// (Dmitry Vyukov's bounded queue, with the consumer side simplified for one reader.)
+
+ActionQueue::ActionQueue(size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+    m_mask = size - 1;
+    m_cells = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool ActionQueue::push(const QueuedAction& action)
+{
+    size_t position = m_enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &m_cells[position & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false; // Full: the consumer has not freed this slot yet
+        } else {
+            position = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->action = action;
+    cell->sequence.store(position + 1, std::memory_order_release);
+
+    // Pairs with the fence in wait(): either the consumer sees this item before it
+    // sleeps, or we see that it is sleeping and wake it. Costs no syscall while busy.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_consumerSleeping.load(std::memory_order_relaxed)) {
+        notifyConsumer();
+    }
+    return true;
+}
+
+bool ActionQueue::pop(QueuedAction& action)
+{
+    Cell& cell = m_cells[m_dequeuePos & m_mask];
+    if (cell.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) {
+        return false;
+    }
+    action = cell.action;
+    cell.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+    ++m_dequeuePos;
+    return true;
+}
+
+bool ActionQueue::empty() const
+{
+    const Cell& cell = m_cells[m_dequeuePos & m_mask];
+    return cell.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1;
+}
+
+void ActionQueue::wait()
+{
+    uint32_t seen = m_wakeCounter.load(std::memory_order_acquire);
+    m_consumerSleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // A wake() that landed before `seen` was read is caught by the flag, one after it
+    // by the counter having moved on
+    if (empty() && !m_wakePending.exchange(false, std::memory_order_acq_rel)) {
+        m_wakeCounter.wait(seen, std::memory_order_acquire);
+    }
+    m_consumerSleeping.store(false, std::memory_order_relaxed);
+}
+
+void ActionQueue::wake()
+{
+    m_wakePending.store(true, std::memory_order_release);
+    notifyConsumer();
+}
+
+void ActionQueue::notifyConsumer()
+{
+    m_wakeCounter.fetch_add(1, std::memory_order_release);
+    m_wakeCounter.notify_one();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// One pending press. Plain data so queueing never allocates.
+struct QueuedAction {
+    uint32_t buttonIndex = 0;   // Index into ConfigSnapshot::buttons at `generation`
+    uint32_t generation = 0;    // Low 32 bits of the ConfigSnapshot generation when queued
+    int64_t enqueuedNs = 0;     // steady_clock time of the request
+};
+static_assert(std::is_trivially_copyable_v<QueuedAction>);
+
+// Bounded lock-free multi-producer / single-consumer queue of QueuedAction.
+// Producers (WebSocket thread, UI, anything else) claim a slot with one CAS and never
+// wait for each other or for the consumer; a full queue rejects the push instead.
+// The consumer may block in wait() until something is pushed or wake() is called.
+// Capacity is fixed at construction (rounded up to a power of two).
+class ActionQueue {
+public:
+    explicit ActionQueue(size_t capacity = 1024);
+
+    ActionQueue(const ActionQueue&) = delete;
+    ActionQueue& operator=(const ActionQueue&) = delete;
+
+    // Any thread. Returns false (and counts a drop) if the queue is full.
+    bool push(const QueuedAction& action);
+    // Consumer thread only.
+    bool pop(QueuedAction& action);
+    // Consumer thread only. Blocks until the queue is non-empty or wake() was called.
+    void wait();
+    // Any thread. Releases a consumer blocked in wait() (used for shutdown).
+    void wake();
+
+    // Consumer thread only.
+    bool empty() const;
+    size_t capacity() const { return m_mask + 1; }
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        QueuedAction action;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) size_t m_dequeuePos = 0;  // Consumer only
+    std::atomic<uint32_t> m_wakeCounter{0};
+    std::atomic<bool> m_consumerSleeping{false};
+    std::atomic<bool> m_wakePending{false};
+    std::atomic<uint64_t> m_dropped{0};
+
+    void notifyConsumer();
+};
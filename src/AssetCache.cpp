@@ -0,0 +1,281 @@
+#include "AssetCache.hpp"
+#include "Utils/CompressionUtils.hpp"
+#include "Utils/HashUtils.hpp"
+#include <algorithm>
+#include <fstream>
+#include "Utils/Logger.hpp"
+#include <map>
+#include <optional>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Files smaller than this are not worth a compressed variant
+    constexpr size_t kMinCompressibleSize = 256;
+
+    std::string_view trim(std::string_view value) {
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+        return value;
+    }
+
+    bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) { return ::tolower(x) == ::tolower(y); });
+    }
+
+    // Calls fn(token) for each comma separated element of an HTTP list header
+    template <typename Fn>
+    void forEachListElement(std::string_view header, Fn&& fn) {
+        while (!header.empty()) {
+            size_t comma = header.find(',');
+            std::string_view element = trim(header.substr(0, comma));
+            if (!element.empty() && fn(element)) {
+                return;
+            }
+            if (comma == std::string_view::npos) break;
+            header.remove_prefix(comma + 1);
+        }
+    }
+
+    std::optional<std::string> readWholeFile(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            Logger::Error("[AssetCache] Could not open file: {}", path);
+            return std::nullopt;
+        }
+        std::streamsize size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        std::string content(static_cast<size_t>(size), '\0');
+        if (size > 0 && !file.read(content.data(), size)) {
+            Logger::Error("[AssetCache] Could not read file: {}", path);
+            return std::nullopt;
+        }
+        return content;
+    }
+
+    bool isWithinRoot(const std::string& canonicalPath, const std::string& canonicalRoot) {
+        if (canonicalPath.compare(0, canonicalRoot.size(), canonicalRoot) != 0) {
+            return false;
+        }
+        // Make sure "web2/x" does not pass as being inside "web"
+        if (canonicalPath.size() == canonicalRoot.size()) return true;
+        char next = canonicalPath[canonicalRoot.size()];
+        return next == '/' || next == '\\';
+    }
+} // namespace
+
+void AssetCache::addRoot(const std::string& urlPrefix, const fs::path& directory) {
+    Root root;
+    root.urlPrefix = urlPrefix;
+    root.directory = directory;
+    std::error_code ec;
+    root.canonicalDirectory = fs::weakly_canonical(directory, ec).string();
+    if (ec) {
+        Logger::Error("[AssetCache] Could not resolve root {}: {}", directory, ec.message());
+        root.canonicalDirectory = directory.string();
+    }
+    m_roots.push_back(std::move(root));
+    std::sort(m_roots.begin(), m_roots.end(), [](const Root& a, const Root& b) {
+        return a.urlPrefix.size() > b.urlPrefix.size();
+    });
+}
+
+size_t AssetCache::preload() {
+    size_t loaded = 0;
+    for (const auto& root : m_roots) {
+        std::error_code ec;
+        if (!fs::is_directory(root.directory, ec)) {
+            Logger::Error("[AssetCache] Root directory not found: {}", root.directory);
+            continue;
+        }
+        for (auto it = fs::recursive_directory_iterator(root.directory, fs::directory_options::skip_permission_denied, ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (!it->is_regular_file(ec)) continue;
+
+            std::string urlPath = root.urlPrefix + fs::relative(it->path(), root.directory, ec).generic_string();
+            if (ec || m_assets.find(urlPath) != m_assets.end()) continue; // A more specific root already owns it
+
+            auto content = readWholeFile(it->path());
+            if (!content) continue;
+            m_assets.emplace(std::move(urlPath), buildAsset(it->path(), std::move(*content)));
+            ++loaded;
+        }
+        if (ec) {
+            Logger::Error("[AssetCache] Error while scanning {}: {}", root.directory, ec.message());
+        }
+    }
+    Logger::Info("[AssetCache] Preloaded {} files ({} bytes incl. compressed variants).", loaded, totalBytes());
+    return loaded;
+}
+
+const CachedAsset* AssetCache::find(std::string_view urlPath) {
+    if (urlPath.empty() || urlPath == "/") {
+        urlPath = "/index.html";
+    }
+    auto it = m_assets.find(urlPath);
+    if (it != m_assets.end()) {
+        return &it->second;
+    }
+    return loadAsset(urlPath);
+}
+
+void AssetCache::invalidate(std::string_view urlPath) {
+    auto it = m_assets.find(urlPath);
+    if (it != m_assets.end()) {
+        m_assets.erase(it);
+    }
+}
+
+void AssetCache::clear() {
+    m_assets.clear();
+}
+
+size_t AssetCache::totalBytes() const {
+    size_t total = 0;
+    for (const auto& [url, asset] : m_assets) {
+        total += asset.body.size() + asset.gzipBody.size() + asset.brotliBody.size();
+    }
+    return total;
+}
+
+const AssetCache::Root* AssetCache::resolveRoot(std::string_view urlPath, std::string_view& relativePath) const {
+    for (const auto& root : m_roots) {
+        if (urlPath.compare(0, root.urlPrefix.size(), root.urlPrefix) == 0) {
+            relativePath = urlPath.substr(root.urlPrefix.size());
+            return &root;
+        }
+    }
+    return nullptr;
+}
+
+std::optional<fs::path> AssetCache::resolveFile(std::string_view urlPath) const {
+    std::string_view relativePath;
+    const Root* root = resolveRoot(urlPath, relativePath);
+    if (!root || relativePath.empty()) {
+        return std::nullopt;
+    }
+
+    std::error_code ec;
+    fs::path canonicalPath = fs::weakly_canonical(root->directory / fs::path(relativePath), ec);
+    if (ec || !isWithinRoot(canonicalPath.string(), root->canonicalDirectory)) {
+        Logger::Error("[AssetCache] Attempt to access file outside allowed roots: {}", urlPath);
+        return std::nullopt;
+    }
+    if (!fs::is_regular_file(canonicalPath, ec)) {
+        return std::nullopt;
+    }
+    return canonicalPath;
+}
+
+// Slow path: the file was not there at preload time (e.g. an icon picked after startup)
+const CachedAsset* AssetCache::loadAsset(std::string_view urlPath) {
+    auto filePath = resolveFile(urlPath);
+    if (!filePath) {
+        return nullptr;
+    }
+
+    auto content = readWholeFile(*filePath);
+    if (!content) {
+        return nullptr;
+    }
+    auto [it, inserted] = m_assets.emplace(std::string(urlPath), buildAsset(*filePath, std::move(*content)));
+    return &it->second;
+}
+
+CachedAsset AssetCache::buildAsset(const fs::path& filePath, std::string body) {
+    CachedAsset asset;
+    asset.mimeType = std::string(getMimeType(filePath));
+    asset.etag = "\"" + HashUtils::ToHex(HashUtils::Fnv1a64(body)) + "\"";
+
+    if (body.size() >= kMinCompressibleSize && isCompressible(asset.mimeType)) {
+        if (auto gz = CompressionUtils::GzipCompress(body); gz && gz->size() < body.size()) {
+            asset.gzipBody = std::move(*gz);
+        }
+        if (auto br = CompressionUtils::BrotliCompress(body); br && br->size() < body.size()) {
+            asset.brotliBody = std::move(*br);
+        }
+    }
+    asset.body = std::move(body);
+    return asset;
+}
+
+std::string_view AssetCache::getMimeType(const fs::path& path) {
+    static const std::map<std::string, std::string_view> mimeTypes = {
+        {".html", "text/html; charset=utf-8"},
+        {".htm", "text/html; charset=utf-8"},
+        {".css", "text/css; charset=utf-8"},
+        {".js", "application/javascript; charset=utf-8"},
+        {".json", "application/json; charset=utf-8"},
+        {".png", "image/png"},
+        {".jpg", "image/jpeg"},
+        {".jpeg", "image/jpeg"},
+        {".gif", "image/gif"},
+        {".svg", "image/svg+xml"},
+        {".ico", "image/x-icon"}
+        // Add more types as needed
+    };
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    auto it = mimeTypes.find(ext);
+    if (it != mimeTypes.end()) {
+        return it->second;
+    }
+    return "application/octet-stream"; // Default binary type
+}
+
+bool AssetCache::isCompressible(std::string_view mimeType) {
+    // Raster images are already compressed; text formats usually shrink 3-5x
+    return mimeType.rfind("text/", 0) == 0 ||
+           mimeType.find("javascript") != std::string_view::npos ||
+           mimeType.find("json") != std::string_view::npos ||
+           mimeType.find("svg") != std::string_view::npos;
+}
+
+bool AssetCache::matchesETag(std::string_view ifNoneMatch, std::string_view etag) {
+    ifNoneMatch = trim(ifNoneMatch);
+    if (ifNoneMatch.empty()) return false;
+    if (ifNoneMatch == "*") return true;
+
+    bool matched = false;
+    forEachListElement(ifNoneMatch, [&](std::string_view candidate) {
+        if (candidate.rfind("W/", 0) == 0) candidate.remove_prefix(2);
+        matched = (candidate == etag);
+        return matched;
+    });
+    return matched;
+}
+
+AssetEncoding AssetCache::selectEncoding(std::string_view acceptEncoding, const CachedAsset& asset) {
+    if (asset.gzipBody.empty() && asset.brotliBody.empty()) {
+        return AssetEncoding::Identity;
+    }
+
+    bool acceptsGzip = false;
+    bool acceptsBrotli = false;
+    forEachListElement(acceptEncoding, [&](std::string_view element) {
+        size_t semicolon = element.find(';');
+        std::string_view coding = trim(element.substr(0, semicolon));
+        bool rejected = false;
+        if (semicolon != std::string_view::npos) {
+            std::string_view params = trim(element.substr(semicolon + 1));
+            // "q=0", "q=0.0", "q=0.00" and "q=0.000" all mean "not acceptable"
+            rejected = params.rfind("q=0", 0) == 0 && params.find_first_not_of("q=0.") == std::string_view::npos;
+        }
+        if (equalsIgnoreCase(coding, "br")) acceptsBrotli = !rejected;
+        else if (equalsIgnoreCase(coding, "gzip")) acceptsGzip = !rejected;
+        return false;
+    });
+
+    if (acceptsBrotli && !asset.brotliBody.empty() &&
+        (asset.gzipBody.empty() || asset.brotliBody.size() <= asset.gzipBody.size())) {
+        return AssetEncoding::Brotli;
+    }
+    if (acceptsGzip && !asset.gzipBody.empty()) {
+        return AssetEncoding::Gzip;
+    }
+    if (acceptsBrotli && !asset.brotliBody.empty()) {
+        return AssetEncoding::Brotli;
+    }
+    return AssetEncoding::Identity;
+}
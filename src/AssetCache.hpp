@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include "Utils/HashUtils.hpp"
+
+// A static file held in memory together with its precompressed variants.
+struct CachedAsset {
+    std::string mimeType;
+    std::string etag;       // Strong validator, already quoted for the ETag header
+    std::string body;       // Identity encoding
+    std::string gzipBody;   // Empty when gzip did not make the file smaller
+    std::string brotliBody; // Empty when brotli did not make the file smaller (or is unavailable)
+};
+
+// Which body of a CachedAsset to send for a given Accept-Encoding header
+enum class AssetEncoding {
+    Identity,
+    Gzip,
+    Brotli
+};
+
+// In-memory cache for the files served over HTTP by CommServer.
+// Files below the registered roots are read and compressed once (preload() at server
+// start, or lazily on the first request for a file that appeared later), so serving a
+// request is a hash lookup plus a send.
+// Not thread-safe: only touch it from the uWS event-loop thread.
+class AssetCache {
+public:
+    // Map a URL prefix (e.g. "/assets/icons/") to a directory on disk.
+    // The longest matching prefix wins, so "/" can be used as a catch-all root.
+    void addRoot(const std::string& urlPrefix, const std::filesystem::path& directory);
+
+    // Load every regular file below the registered roots. Returns the number of cached files.
+    size_t preload();
+
+    // Look up an asset by URL path ("/" maps to "/index.html").
+    // Falls back to loading from disk on a miss; returns nullptr if the file does not exist
+    // or resolves outside the registered roots.
+    const CachedAsset* find(std::string_view urlPath);
+
+    // The file on disk behind a URL path, if it exists inside the registered roots.
+    // Hits the file system; for handing the file to another thread, not for serving.
+    std::optional<std::filesystem::path> resolveFile(std::string_view urlPath) const;
+
+    // Drop a cached entry so the next request reloads it from disk.
+    void invalidate(std::string_view urlPath);
+    void clear();
+
+    size_t size() const { return m_assets.size(); }
+    size_t totalBytes() const; // Sum of all stored bodies (identity + compressed)
+
+    // --- HTTP helpers (pure functions, used by CommServer and the benchmark) ---
+    static std::string_view getMimeType(const std::filesystem::path& path);
+    static bool isCompressible(std::string_view mimeType);
+    // True if an If-None-Match header value matches the asset's ETag (weak comparison, RFC 9110 13.1.2)
+    static bool matchesETag(std::string_view ifNoneMatch, std::string_view etag);
+    // Picks the smallest variant the client accepts
+    static AssetEncoding selectEncoding(std::string_view acceptEncoding, const CachedAsset& asset);
+
+private:
+    struct Root {
+        std::string urlPrefix;
+        std::filesystem::path directory;
+        std::string canonicalDirectory; // Resolved once in addRoot for the containment check
+    };
+
+    std::vector<Root> m_roots; // Sorted by descending prefix length
+    // Transparent hash so lookups by std::string_view don't allocate
+    std::unordered_map<std::string, CachedAsset, HashUtils::StringHash, std::equal_to<>> m_assets;
+
+    const Root* resolveRoot(std::string_view urlPath, std::string_view& relativePath) const;
+    const CachedAsset* loadAsset(std::string_view urlPath);
+    static CachedAsset buildAsset(const std::filesystem::path& filePath, std::string body);
+};
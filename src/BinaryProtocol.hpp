@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+// Compact binary WebSocket framing for the press hot path.
+//
+// Negotiation happens over JSON: the client sends
+//   {"type":"hello","payload":{"binary_protocol":<highest version it speaks>}}
+// and the server answers with the version both sides will use (0 = stay on JSON).
+// After that, presses may be sent as binary frames. All integers are little-endian.
+//
+//   ButtonPress (client -> server, 12 bytes)
+//     [0]     opcode = 0x01
+//     [1]     protocol version
+//     [2..3]  sequence number (wraps), echoed in the ack
+//     [4..7]  button index into the layout of the given version
+//     [8..11] layout version (low 32 bits of the initial_config/layout_update "version")
+//
+//   PressAck (server -> client, 4 bytes)
+//     [0]     opcode = 0x81
+//     [1]     AckStatus
+//     [2..3]  sequence number of the press
+namespace BinaryProtocol {
+
+    constexpr uint8_t VERSION = 1;
+
+    enum class Opcode : uint8_t {
+        ButtonPress = 0x01,
+        PressAck = 0x81
+    };
+
+    enum class AckStatus : uint8_t {
+        Accepted = 0,
+        StaleLayout = 1,        // Layout version changed; client should resync and retry
+        UnknownButton = 2,      // Index out of range for that layout
+        Malformed = 3,
+        NotNegotiated = 4       // Binary frame before a successful hello
+    };
+
+    constexpr size_t BUTTON_PRESS_SIZE = 12;
+    constexpr size_t PRESS_ACK_SIZE = 4;
+
+    struct ButtonPress {
+        uint8_t version = VERSION;
+        uint16_t sequence = 0;
+        uint32_t buttonIndex = 0;
+        uint32_t layoutVersion = 0;
+    };
+
+    inline uint16_t readU16(const unsigned char* p) {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    inline uint32_t readU32(const unsigned char* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    inline void writeU16(unsigned char* p, uint16_t value) {
+        p[0] = static_cast<unsigned char>(value & 0xFF);
+        p[1] = static_cast<unsigned char>(value >> 8);
+    }
+
+    inline void writeU32(unsigned char* p, uint32_t value) {
+        for (int i = 0; i < 4; ++i) p[i] = static_cast<unsigned char>((value >> (8 * i)) & 0xFF);
+    }
+
+    // Returns std::nullopt if the frame is not a well-formed ButtonPress
+    inline std::optional<ButtonPress> decodeButtonPress(std::string_view frame) {
+        if (frame.size() != BUTTON_PRESS_SIZE) return std::nullopt;
+        const auto* p = reinterpret_cast<const unsigned char*>(frame.data());
+        if (p[0] != static_cast<uint8_t>(Opcode::ButtonPress)) return std::nullopt;
+        ButtonPress press;
+        press.version = p[1];
+        press.sequence = readU16(p + 2);
+        press.buttonIndex = readU32(p + 4);
+        press.layoutVersion = readU32(p + 8);
+        return press;
+    }
+
+    inline void encodeButtonPress(const ButtonPress& press, unsigned char (&out)[BUTTON_PRESS_SIZE]) {
+        out[0] = static_cast<uint8_t>(Opcode::ButtonPress);
+        out[1] = press.version;
+        writeU16(out + 2, press.sequence);
+        writeU32(out + 4, press.buttonIndex);
+        writeU32(out + 8, press.layoutVersion);
+    }
+
+    inline void encodePressAck(uint16_t sequence, AckStatus status, unsigned char (&out)[PRESS_ACK_SIZE]) {
+        out[0] = static_cast<uint8_t>(Opcode::PressAck);
+        out[1] = static_cast<uint8_t>(status);
+        writeU16(out + 2, sequence);
+    }
+
+} // namespace BinaryProtocol
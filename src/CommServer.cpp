@@ -1,88 +1,146 @@
 #include "CommServer.hpp" // Include the header file
-#include <iostream>
+#include "Utils/Logger.hpp"
 #include <string_view> // For uWS message payload
 #include <chrono>    // For sleep
 #include <stdexcept> // For std::runtime_error (though not currently used)
-#include <fstream>      // For file reading
-#include <sstream>      // For reading file into string
-#include <filesystem>   // For path manipulation and checking file existence (C++17)
-#include <map>          // For MIME types
+#include <filesystem>   // For path manipulation (C++17)
+#include <algorithm>    // For std::clamp
+#include <charconv>     // For std::from_chars
+#include <limits>
 #include "ConfigManager.hpp" // Make sure ConfigManager is included
 
 // Define the root directory for web files relative to the executable
 const std::filesystem::path WEB_ROOT = "web";
 const std::filesystem::path ASSETS_ICONS_ROOT = "assets/icons";
+#ifdef WEBSTREAMDECK_HAS_ICON_VARIANTS
+// Resized icons (IconVariantCache), kept across runs
+const std::filesystem::path ICON_VARIANTS_ROOT = "cache/icons";
+#endif
+constexpr std::string_view ASSETS_ICONS_URL_PREFIX = "/assets/icons/";
 
-// Helper function to determine MIME type from file extension
-std::string getMimeType(const std::filesystem::path& path) {
-    std::string ext = path.extension().string();
-    static const std::map<std::string, std::string> mimeTypes = {
-        {".html", "text/html; charset=utf-8"},
-        {".htm", "text/html; charset=utf-8"},
-        {".css", "text/css; charset=utf-8"},
-        {".js", "application/javascript; charset=utf-8"},
-        {".png", "image/png"},
-        {".jpg", "image/jpeg"},
-        {".jpeg", "image/jpeg"},
-        {".gif", "image/gif"},
-        {".svg", "image/svg+xml"},
-        {".ico", "image/x-icon"}
-        // Add more types as needed
-    };
-    auto it = mimeTypes.find(ext);
-    if (it != mimeTypes.end()) {
-        return it->second;
+// Every client subscribes to the page list and to the one page it is viewing; a change is
+// serialized once and published by uWS to the clients viewing that page only.
+constexpr std::string_view DECK_TOPIC = "deck";
+constexpr std::string_view PAGE_TOPIC_PREFIX = "page/";
+
+// Coalescing keys for messages that carry a whole state; a newer one makes older ones moot
+constexpr std::string_view LAYOUT_STATE_KEY = "layout";
+constexpr std::string_view DECK_STATE_KEY = "deck";
+
+namespace {
+    std::string pageTopic(std::string_view pageId) {
+        std::string topic(PAGE_TOPIC_PREFIX);
+        topic += pageId;
+        return topic;
     }
-    return "application/octet-stream"; // Default binary type
-}
 
-// Helper function to read file content
-std::optional<std::string> readFile(const std::filesystem::path& path) {
-    // Security check: Ensure the path is within allowed roots
-    // Use weakly_canonical to resolve symlinks etc. before checking
-    auto canonicalPath = std::filesystem::weakly_canonical(path);
-    auto webRootCanonical = std::filesystem::weakly_canonical(WEB_ROOT);
-    auto iconsRootCanonical = std::filesystem::weakly_canonical(ASSETS_ICONS_ROOT);
-
-    // Check if the canonical path starts with either allowed root's canonical path
-    bool isInWebRoot = (canonicalPath.string().find(webRootCanonical.string()) == 0);
-    bool isInIconsRoot = (canonicalPath.string().find(iconsRootCanonical.string()) == 0);
-
-    if (!isInWebRoot && !isInIconsRoot) {
-         std::cerr << "Attempt to access file outside allowed roots: " << path << " (Canonical: " << canonicalPath << ")" << std::endl;
-         return std::nullopt;
-     }
-
-    // Check if file exists and is a regular file after security check
-    if (!std::filesystem::exists(canonicalPath) || !std::filesystem::is_regular_file(canonicalPath)) {
-         std::cerr << "File does not exist or is not a regular file: " << canonicalPath << std::endl;
-        return std::nullopt;
-    }
-    
-    std::ifstream file(canonicalPath, std::ios::binary);
-    if (!file.is_open()) {
-         std::cerr << "Could not open file: " << canonicalPath << std::endl;
-        return std::nullopt;
-    }
-    
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
-}
+#ifdef WEBSTREAMDECK_HAS_ICON_VARIANTS
+    double parseNumber(std::string_view text) {
+        double value = 0.0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size() ? value : 0.0;
+    }
+
+    // Pixel size asked for by "?w=<CSS px>[&dpr=<device pixel ratio>]"; 0 without (or with a bad) "w"
+    int requestedIconSize(uWS::HttpRequest* req) {
+        auto width = req->getQuery("w");
+        if (!width || width->empty()) return 0;
+        auto ratio = req->getQuery("dpr");
+        return IconVariantCache::bucketSize(parseNumber(*width), ratio && !ratio->empty() ? parseNumber(*ratio) : 1.0);
+    }
+
+    // Raster formats IconResizer can shrink
+    bool isResizableImage(std::string_view mimeType) {
+        return mimeType == "image/png" || mimeType == "image/jpeg" || mimeType == "image/gif";
+    }
+#endif
+} // namespace
 
 // Constructor now takes ConfigManager reference
 CommServer::CommServer(ConfigManager& configManager)
     : m_configManager(configManager) // Initialize reference member
 {
-    m_loop = uWS::Loop::get();
+    // Icons are matched first (longest prefix), everything else comes from the web root
+    m_assetCache.addRoot(std::string(ASSETS_ICONS_URL_PREFIX), ASSETS_ICONS_ROOT);
+    m_assetCache.addRoot("/", WEB_ROOT);
+
+    m_configListenerId = m_configManager.addChangeListener(
+        [this](const std::shared_ptr<const LayoutSnapshot>& snapshot) { publish_layout_update(snapshot); });
 }
 
 CommServer::~CommServer() {
+    m_configManager.removeChangeListener(m_configListenerId);
     stop(); // Ensure server is stopped on destruction
 }
 
+bool CommServer::defer_to_loop(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(m_loopMutex);
+    if (!m_loop || !m_running) {
+        return false;
+    }
+    m_loop->defer(std::move(task));
+    return true;
+}
+
+void CommServer::invalidate_assets(std::vector<std::string> urlPaths) {
+    if (urlPaths.empty()) {
+        return;
+    }
+    // AssetCache belongs to the server thread; dropped if the server is not running
+    defer_to_loop([this, urlPaths = std::move(urlPaths)]() {
+        for (const auto& urlPath : urlPaths) {
+            m_assetCache.invalidate(urlPath);
+#ifdef WEBSTREAMDECK_HAS_ICON_VARIANTS
+            m_iconVariants.erase(urlPath);
+            // A worker may have read the old file already
+            for (auto pending = m_pendingIconVariants.lower_bound({urlPath, std::numeric_limits<int>::min()});
+                 pending != m_pendingIconVariants.end() && pending->first.first == urlPath; ++pending) {
+                pending->second.stale = true;
+            }
+#endif
+        }
+        Logger::Debug("[CommServer] Invalidated {} cached assets.", urlPaths.size());
+    });
+}
+
+void CommServer::publish_layout_update(const std::shared_ptr<const LayoutSnapshot>& snapshot) {
+    if (!snapshot) {
+        return;
+    }
+    // uWS is single-threaded; hop to the server thread and publish once per changed page
+    defer_to_loop([this, snapshot]() {
+        if (!m_app) return;
+        // Clients that are behind skip the deltas; their queued snapshot is replaced
+        // with this one instead, so a stalled client holds at most one layout
+        std::vector<uWS::WebSocket<false, true, PerSocketData>*> onRemovedPage;
+        for (auto* ws : m_clients) {
+            PerSocketData* data = ws->getUserData();
+            if (data->needsResync) {
+                queue_layout_snapshot(ws, snapshot);
+            } else if (ws->getBufferedAmount() >= m_backpressure.highWatermark) {
+                mark_congested(ws);
+            } else if (!snapshot->findPage(data->pageId)) {
+                onRemovedPage.push_back(ws);
+            }
+        }
+        if (snapshot->deckChanged) {
+            m_app->publish(DECK_TOPIC, snapshot->deckMessage, uWS::OpCode::TEXT);
+        }
+        for (const auto& page : snapshot->changedPages) {
+            // Pages new in this version have no delta and no viewers yet
+            if (page->layoutUpdateMessage.empty()) continue;
+            m_app->publish(pageTopic(page->pageId), page->layoutUpdateMessage, uWS::OpCode::TEXT);
+            Logger::Info("[WS] Published layout_update for page '{}' v{} -> v{}", page->pageId, page->baseVersion, page->version);
+        }
+        // The page they were viewing is gone; they continue on the root page
+        for (auto* ws : onRemovedPage) {
+            open_page(ws, "");
+        }
+    });
+}
+
 // Configure the uWebSockets application behavior (WebSocket AND HTTP)
-void CommServer::configure_app(int port) {
+void CommServer::configure_app(int port, const std::string& host) {
     m_app = std::make_unique<uWS::App>();
 
     // Configure WebSocket behavior
@@ -91,100 +149,62 @@ void CommServer::configure_app(int port) {
         .compression = uWS::SHARED_COMPRESSOR,
         .maxPayloadLength = 16 * 1024 * 1024, // 16MB max payload
         .idleTimeout = 600, // Timeout in seconds (e.g., 10 minutes)
+        // Hard cap inside uWS; our own queue keeps clients well below it
+        .maxBackpressure = static_cast<unsigned int>(m_backpressure.highWatermark + m_backpressure.maxQueuedBytes),
+        .closeOnBackpressureLimit = false,
 
         /* Handlers */
         .open = [this](uWS::WebSocket<false, true, PerSocketData> *ws) {
-            std::cout << "[WS] Client connected. Address: " << ws->getRemoteAddressAsText() << std::endl;
-            
-            // --- Send initial configuration --- 
-            try {
-                const auto& buttons = m_configManager.getButtons();
-                json layout = json::array();
-                for (const auto& btn : buttons) {
-                    std::string webIconPath = ""; // Default to empty string
-                    if (!btn.icon_path.empty()) {
-                        // --- Convert file path to URL path ---
-                        std::filesystem::path fsPath(btn.icon_path);
-                        std::string pathStr = btn.icon_path; // Use a copy for manipulation
-
-                        // Normalize separators first
-                        std::replace(pathStr.begin(), pathStr.end(), '\\', '/');
-
-                        // Define the expected relative prefix
-                        std::string expectedPrefix = ASSETS_ICONS_ROOT.string();
-                        std::replace(expectedPrefix.begin(), expectedPrefix.end(), '\\', '/');
-
-                        // Check if the path starts with the expected relative prefix
-                        if (pathStr.rfind(expectedPrefix, 0) == 0) {
-                             // If it starts with "assets/icons", use it directly
-                             webIconPath = "/" + pathStr;
-                        } else {
-                             // Check if it looks like just a filename (no slashes)
-                             if (pathStr.find('/') == std::string::npos) {
-                                  std::cout << "[INFO] Button icon path '" << btn.icon_path 
-                                            << "' looks like a filename. Assuming it's in assets/icons/." << std::endl;
-                                  webIconPath = "/" + expectedPrefix + "/" + pathStr; 
-                             } else {
-                                 // If it's an absolute path or unexpected relative path, log a warning.
-                                 // Ideally, configuration should store correct relative paths.
-                                 std::cerr << "[WARN] Button icon path '" << btn.icon_path 
-                                           << "' is not a standard relative path starting with '" << expectedPrefix 
-                                           << "'. Icon might not load correctly in web UI." << std::endl;
-                                 // As a basic fallback, try using the original path, hoping it might work
-                                 // or at least trigger a 404 if server is configured for it.
-                                 // A truly robust solution needs consistent relative paths in config.
-                                 webIconPath = "/" + pathStr; // Best guess fallback
-                             }
-                        }
-                        // Ensure no double slashes at the beginning (e.g., if pathStr started with /)
-                        if (webIconPath.length() > 1 && webIconPath[0] == '/' && webIconPath[1] == '/') {
-                            webIconPath = webIconPath.substr(1);
-                        }
-                        // -----------------------------------------
-                    }
+            Logger::Info("[WS] Client connected. Address: {}", ws->getRemoteAddressAsText());
+            m_clients.insert(ws);
 
-                    layout.push_back({
-                        {"id", btn.id},
-                        {"name", btn.name},
-                        {"icon_path", webIconPath} // Send the calculated web path
-                    });
-                }
-                json configMsg = {
-                    {"type", "initial_config"},
-                    {"payload", {{"layout", layout}}}
-                };
-                ws->send(configMsg.dump(), uWS::OpCode::TEXT);
-                std::cout << "[WS] Sent initial config to client (with processed icon paths)." << std::endl; // Added log
-            } catch (const std::exception& e) {
-                std::cerr << "[WS] Error sending initial config: " << e.what() << std::endl;
+            // --- Send initial configuration --- 
+            // The page list and the root page; other pages are sent when the client
+            // opens them. Everything is serialized by ConfigManager at most once per
+            // change, so a connect only costs an atomic load and a send.
+            auto snapshot = m_configManager.getLayoutSnapshot();
+            if (snapshot) {
+                send_to_client(ws, snapshot->deckMessage, uWS::OpCode::TEXT, DECK_STATE_KEY);
+                // Publishes also run on this thread, so no update can slip in between
+                // the snapshot and the subscription.
+                ws->subscribe(DECK_TOPIC);
+                open_page(ws, "");
+                Logger::Info("[WS] Sent deck v{} ({} pages) to client.", snapshot->deckVersion, snapshot->pages.size());
+            } else {
+                Logger::Error("[WS] No layout snapshot available to send.");
             }
-            // -------------------------------------
         },
         .message = [this](uWS::WebSocket<false, true, PerSocketData> *ws, std::string_view message, uWS::OpCode opCode) {
             if (opCode == uWS::OpCode::TEXT) {
-                std::cout << "[WS] Received message: " << message << std::endl;
-                if (m_message_handler) {
-                    try {
-                        json payload_json = json::parse(message);
+                Logger::Debug("[WS] Received message: {}", message);
+                try {
+                    json payload_json = json::parse(message);
+                    if (handle_control_message(ws, payload_json)) {
+                        return;
+                    }
+                    if (m_message_handler) {
                         // Pass the ActionExecutor reference to the handler if needed
                         // Or, preferably, the handler captures it if defined as lambda in main.
                         m_message_handler(ws, payload_json, false);
                     }
-                    catch (const json::parse_error& e) {
-                        std::cerr << "[WS] Failed to parse JSON message: " << e.what() << std::endl;
-                        ws->send("{\"error\": \"Invalid JSON format\"}", uWS::OpCode::TEXT);
-                    }
-                     catch (const std::exception& e) {
-                        std::cerr << "[WS] Error processing message: " << e.what() << std::endl;
-                        ws->send("{\"error\": \"Internal server error\"}", uWS::OpCode::TEXT);
-                    }
+                }
+                catch (const json::parse_error& e) {
+                    Logger::Error("[WS] Failed to parse JSON message: {}", e.what());
+                    send_to_client(ws, "{\"error\": \"Invalid JSON format\"}", uWS::OpCode::TEXT);
+                }
+                 catch (const std::exception& e) {
+                    Logger::Error("[WS] Error processing message: {}", e.what());
+                    send_to_client(ws, "{\"error\": \"Internal server error\"}", uWS::OpCode::TEXT);
                 }
             } else if (opCode == uWS::OpCode::BINARY) {
-                std::cout << "[WS] Received binary message of size: " << message.length() << std::endl;
+                handle_binary_message(ws, message);
             }
         },
-        .drain = [](uWS::WebSocket<false, true, PerSocketData> *ws) {
-            // Can check ws->getBufferedAmount() and potentially send more data
+        .drain = [this](uWS::WebSocket<false, true, PerSocketData> *ws) {
+            // uWS flushed part of its buffer; refill from our queue once below the low watermark
+            if (ws->getBufferedAmount() <= m_backpressure.lowWatermark) {
+                flush_client(ws);
+            }
         },
         .ping = [](uWS::WebSocket<false, true, PerSocketData> *ws, std::string_view) {
             // Pong is sent automatically by uWS
@@ -192,87 +212,201 @@ void CommServer::configure_app(int port) {
         .pong = [](uWS::WebSocket<false, true, PerSocketData> *ws, std::string_view) {
             // Received pong from client
         },
-        .close = [](uWS::WebSocket<false, true, PerSocketData> *ws, int code, std::string_view message) {
-             std::cout << "[WS] Client disconnected. Code: " << code << ", Message: " << message << std::endl;
+        .close = [this](uWS::WebSocket<false, true, PerSocketData> *ws, int code, std::string_view message) {
+             Logger::Info("[WS] Client disconnected. Code: {}, Message: {}", code, message);
+             const auto& outbound = ws->getUserData()->outbound;
+             if (outbound.dropped() > 0 || outbound.coalesced() > 0) {
+                 Logger::Info("[WS] Client send stats: {} dropped, {} coalesced.", outbound.dropped(), outbound.coalesced());
+             }
+             m_clients.erase(ws);
         }
-    })
-    .listen(port, [this, port](us_listen_socket_t *token) {
+    });
+
+    auto onListen = [this, port](us_listen_socket_t *token) {
         // This callback runs when listening starts (or fails)
         if (token) {
-            std::cout << "HTTP/WebSocket Server listening on port " << port << std::endl;
+            Logger::Info("HTTP/WebSocket Server listening on port {}", port);
             m_listen_socket = token; // Store the listen socket
             m_running = true; // Set running state
         } else {
-            std::cerr << "Failed to listen on port " << port << std::endl;
+            Logger::Error("Failed to listen on port {}", port);
             m_running = false;
             m_should_stop = true; // Signal loop to stop if listen failed
         }
-    });
+        if (m_status_listener) m_status_listener();
+    };
+    if (host.empty()) {
+        m_app->listen(port, onListen);
+    } else {
+        m_app->listen(host, port, onListen);
+    }
 
     // --- HTTP Configuration --- 
+    // Read every servable file once up front; requests are then answered from memory
+    m_assetCache.preload();
+
     m_app->get("/*", [this](uWS::HttpResponse<false> *res, uWS::HttpRequest *req) {
         std::string_view url = req->getUrl();
-        std::filesystem::path basePath;
-        std::string_view relativeUrl;
 
-        constexpr std::string_view iconsPrefix = "/assets/icons/";
-        if (url.rfind(iconsPrefix, 0) == 0) {
-            basePath = ASSETS_ICONS_ROOT;
-            relativeUrl = url.substr(iconsPrefix.length());
-        } else {
-            basePath = WEB_ROOT;
-            relativeUrl = (url == "/" || url.empty()) ? "index.html" : (url[0] == '/' ? url.substr(1) : url);
-            if (relativeUrl.empty() || relativeUrl == "/") {
-                 relativeUrl = "index.html";
-            }
-        }
-
-        std::string relativeUrlStr = std::string(relativeUrl);
-        if (relativeUrlStr.find("..") != std::string::npos || 
-            (relativeUrlStr.length() > 0 && relativeUrlStr[0] == '.')) 
-        {
-             std::cerr << "[HTTP] Invalid path requested: " << url << std::endl;
+        if (url.find("..") != std::string_view::npos || url.find("/.") != std::string_view::npos) {
+             Logger::Error("[HTTP] Invalid path requested: {}", url);
              res->writeStatus("400 Bad Request");
              res->end("Invalid path");
              return;
         }
 
-        std::filesystem::path requestedPath = basePath / relativeUrlStr;
-
-        std::cout << "[HTTP] Request for URL: " << url << " mapped to: " << requestedPath << std::endl;
-
-        auto fileContent = readFile(requestedPath);
-
-        if (fileContent) {
-            res->writeHeader("Content-Type", getMimeType(requestedPath));
-            res->end(*fileContent);
-        } else {
+        const CachedAsset* asset = m_assetCache.find(url);
+        if (!asset) {
+            Logger::Warn("[HTTP] 404 for URL: {}", url);
             res->writeStatus("404 Not Found");
             res->end("File not found");
+            return;
+        }
+
+#ifdef WEBSTREAMDECK_HAS_ICON_VARIANTS
+        if (int size = requestedIconSize(req); size > 0 && url.rfind(ASSETS_ICONS_URL_PREFIX, 0) == 0 &&
+                                               isResizableImage(asset->mimeType)) {
+            if (serve_icon_variant(res, req, url, size)) return;
         }
+#endif
+        write_asset(res, *asset, req->getHeader("if-none-match"), req->getHeader("accept-encoding"));
     });
 }
 
+void CommServer::write_asset(uWS::HttpResponse<false>* res, const CachedAsset& asset, std::string_view ifNoneMatch,
+                             std::string_view acceptEncoding) {
+    // Conditional request: the client already has this exact content
+    if (AssetCache::matchesETag(ifNoneMatch, asset.etag)) {
+        res->writeStatus("304 Not Modified");
+        res->writeHeader("ETag", asset.etag);
+        res->writeHeader("Cache-Control", "no-cache");
+        res->end();
+        return;
+    }
+
+    const std::string* body = &asset.body;
+    AssetEncoding encoding = AssetCache::selectEncoding(acceptEncoding, asset);
+    res->writeHeader("Content-Type", asset.mimeType);
+    res->writeHeader("ETag", asset.etag);
+    // Always revalidate; with the ETag that costs a 304 and no body
+    res->writeHeader("Cache-Control", "no-cache");
+    if (!asset.gzipBody.empty() || !asset.brotliBody.empty()) {
+        res->writeHeader("Vary", "Accept-Encoding");
+    }
+    if (encoding == AssetEncoding::Brotli) {
+        res->writeHeader("Content-Encoding", "br");
+        body = &asset.brotliBody;
+    } else if (encoding == AssetEncoding::Gzip) {
+        res->writeHeader("Content-Encoding", "gzip");
+        body = &asset.gzipBody;
+    }
+    res->end(*body);
+}
+
+#ifdef WEBSTREAMDECK_HAS_ICON_VARIANTS
+bool CommServer::serve_icon_variant(uWS::HttpResponse<false>* res, uWS::HttpRequest* req, std::string_view url,
+                                    int size) {
+    auto icon = m_iconVariants.find(url);
+    if (icon != m_iconVariants.end()) {
+        auto variant = icon->second.find(size);
+        if (variant != icon->second.end()) {
+            if (!variant->second) return false; // The original is as small as it gets
+            write_asset(res, *variant->second, req->getHeader("if-none-match"), req->getHeader("accept-encoding"));
+            return true;
+        }
+    }
+
+    // Not made yet: a worker reads, resizes (or loads from disk) and hands it back to this
+    // thread. The response stays open until then.
+    std::pair<std::string, int> key(url, size);
+    auto pending = m_pendingIconVariants.find(key);
+    if (pending == m_pendingIconVariants.end()) {
+        auto sourcePath = m_assetCache.resolveFile(url);
+        if (!sourcePath) return false;
+        pending = m_pendingIconVariants.emplace(key, PendingIconVariant{}).first;
+        if (!m_iconVariantCache) {
+            m_iconVariantCache = std::make_unique<IconVariantCache>(ICON_VARIANTS_ROOT);
+        }
+        m_iconVariantCache->request(std::move(*sourcePath), size, [this, key](IconVariantCache::Variant variant) {
+            // Dropped if the server stopped meanwhile; its connections are gone too
+            defer_to_loop([this, key, variant = std::move(variant)]() mutable {
+                finish_icon_variant(key.first, key.second, std::move(variant));
+            });
+        });
+    }
+
+    auto aborted = std::make_shared<bool>(false);
+    res->onAborted([aborted]() { *aborted = true; });
+    pending->second.responses.push_back({res, aborted, std::string(req->getHeader("if-none-match")),
+                                         std::string(req->getHeader("accept-encoding"))});
+    return true;
+}
+
+void CommServer::finish_icon_variant(const std::string& url, int size, IconVariantCache::Variant variant) {
+    auto pending = m_pendingIconVariants.extract(std::make_pair(url, size));
+    if (pending.empty()) return;
+
+    std::optional<CachedAsset> resized;
+    if (variant.ok && !variant.useOriginal) {
+        resized.emplace();
+        resized->mimeType = std::move(variant.mimeType);
+        resized->etag = std::move(variant.etag);
+        resized->body = std::move(variant.body);
+    }
+    if (variant.ok && !pending.mapped().stale) {
+        m_iconVariants[url][size] = resized; // A failed read is retried by the next request
+    }
+
+    const CachedAsset* asset = resized ? &*resized : m_assetCache.find(url);
+    for (const auto& waiting : pending.mapped().responses) {
+        if (*waiting.aborted) continue;
+        waiting.res->cork([&]() {
+            if (asset) {
+                write_asset(waiting.res, *asset, waiting.ifNoneMatch, waiting.acceptEncoding);
+            } else {
+                waiting.res->writeStatus("404 Not Found");
+                waiting.res->end("File not found");
+            }
+        });
+    }
+}
+#endif
+
 // Start the server
-bool CommServer::start(int port) {
+bool CommServer::start(int port, const std::string& host) {
     if (m_running) {
-        std::cerr << "Server is already running." << std::endl;
+        Logger::Error("Server is already running.");
         return false;
     }
     m_should_stop = false; // Reset stop flag
 
     // Run the event loop in a new thread
-    m_server_thread = std::thread([this, port]() {
+    m_server_thread = std::thread([this, port, host]() {
+        {
+            std::lock_guard<std::mutex> lock(m_loopMutex);
+            m_loop = uWS::Loop::get(); // The loop belonging to this thread
+        }
         // App and event loop must be created and run in the same thread
-        configure_app(port);
+        configure_app(port, host);
         if (m_running) { // Only run loop if listening succeeded
            m_app->run(); // This blocks until the App stops
         }
         // Cleanup after run() returns
+        {
+            std::lock_guard<std::mutex> lock(m_loopMutex);
+            m_loop = nullptr;
+        }
         m_app.reset();
+        m_clients.clear();
+#ifdef WEBSTREAMDECK_HAS_ICON_VARIANTS
+        m_pendingIconVariants.clear(); // Their connections closed with the app
+        // Joins the workers; a callback still running finds m_loop cleared and drops its result
+        m_iconVariantCache.reset();
+#endif
         m_listen_socket.reset();
         m_running = false;
-        std::cout << "Server thread finished." << std::endl;
+        if (m_status_listener) m_status_listener();
+        Logger::Info("Server thread finished.");
     });
 
     // Wait briefly to allow the thread to start and set the running state
@@ -289,28 +423,28 @@ void CommServer::stop() {
     m_should_stop = true;
 
     // Ensure operations that interact with the loop happen on the loop's thread
-    if (m_loop && m_listen_socket) {
-        m_loop->defer([this]() {
-            if (m_listen_socket) {
-                // Close the listening socket to prevent new connections
-                us_listen_socket_close(0, *m_listen_socket);
-                m_listen_socket.reset();
-                std::cout << "Listen socket closed." << std::endl;
-            }
-            // Closing the listen socket should eventually cause m_app->run() to return.
-            // uWS doesn't have an explicit app->stop().
-             std::cout << "Requesting server loop to stop." << std::endl;
-            // Optionally, you could try to close all existing connections here,
-            // but uWS might handle this when the loop ends.
-            // For clean shutdown, iterating ws->close() might be needed.
-        });
-    }
+    defer_to_loop([this]() {
+        if (m_listen_socket) {
+            // Close the listening socket to prevent new connections
+            us_listen_socket_close(0, *m_listen_socket);
+            m_listen_socket.reset();
+            Logger::Info("Listen socket closed.");
+        }
+        // Closing the listen socket and every client lets m_app->run() return.
+        // uWS doesn't have an explicit app->stop().
+         Logger::Info("Requesting server loop to stop.");
+        // close() fires the close handler, which erases from m_clients
+        auto clients = m_clients;
+        for (auto* ws : clients) {
+            ws->close();
+        }
+    });
 
     // Wait for the server thread to finish
     if (m_server_thread.joinable()) {
         m_server_thread.join();
     }
-    std::cout << "WebSocket Server stopped." << std::endl;
+    Logger::Info("WebSocket Server stopped.");
 }
 
 // Set the external message handler
@@ -318,7 +452,221 @@ void CommServer::set_message_handler(MessageHandler handler) {
     m_message_handler = handler;
 }
 
-// Check if the server is running
-bool CommServer::is_running() const {
-    return m_running;
-} 
\ No newline at end of file
+void CommServer::set_button_press_handler(ButtonPressHandler handler) {
+    m_button_press_handler = handler;
+}
+
+void CommServer::set_status_listener(std::function<void()> listener) {
+    m_status_listener = std::move(listener);
+}
+
+bool CommServer::handle_control_message(uWS::WebSocket<false, true, PerSocketData>* ws, const json& message) {
+    if (!message.contains("type") || !message["type"].is_string()) {
+        return false;
+    }
+    const auto& type = message["type"].get_ref<const std::string&>();
+
+    if (type == "hello") {
+        // Agree on the highest binary protocol version both sides speak
+        int requested = 0;
+        if (message.contains("payload") && message["payload"].is_object()) {
+            requested = message["payload"].value("binary_protocol", 0);
+        }
+        uint8_t agreed = static_cast<uint8_t>(std::clamp(requested, 0, static_cast<int>(BinaryProtocol::VERSION)));
+        ws->getUserData()->binaryProtocolVersion = agreed;
+        json reply = {
+            {"type", "hello"},
+            {"payload", {{"binary_protocol", agreed}}}
+        };
+        send_to_client(ws, reply.dump(), uWS::OpCode::TEXT);
+        Logger::Info("[WS] Client negotiated binary protocol v{}", static_cast<int>(agreed));
+        return true;
+    }
+
+    if (type == "button_press") {
+        // { "type": "button_press", "payload": { "button_id": "..." } }
+        // Goes through the same handler as binary presses
+        const auto payload = message.find("payload");
+        if (payload == message.end() || !payload->is_object()) {
+            Logger::Error("[WS] button_press: Missing or invalid 'payload' object.");
+            return true;
+        }
+        const auto buttonId = payload->find("button_id");
+        if (buttonId == payload->end() || !buttonId->is_string()) {
+            Logger::Error("[WS] button_press: Missing or invalid 'button_id' in payload.");
+            return true;
+        }
+        if (m_button_press_handler) {
+            m_button_press_handler(buttonId->get_ref<const std::string&>());
+        }
+        return true;
+    }
+
+    if (type == "view_page") {
+        // { "type": "view_page", "payload": { "page_id": "..." } }
+        const auto payload = message.find("payload");
+        if (payload == message.end() || !payload->is_object()) {
+            Logger::Error("[WS] view_page: Missing or invalid 'payload' object.");
+            return true;
+        }
+        const auto pageId = payload->find("page_id");
+        if (pageId == payload->end() || !pageId->is_string()) {
+            Logger::Error("[WS] view_page: Missing or invalid 'page_id' in payload.");
+            return true;
+        }
+        open_page(ws, pageId->get_ref<const std::string&>());
+        return true;
+    }
+
+    if (type == "get_config") {
+        // Resync request from a client that missed a layout_update
+        if (auto snapshot = m_configManager.getLayoutSnapshot()) {
+            send_to_client(ws, snapshot->deckMessage, uWS::OpCode::TEXT, DECK_STATE_KEY);
+            open_page(ws, ws->getUserData()->pageId);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+// Hot path for presses: no JSON parsing and no allocation beyond what the handler does
+void CommServer::handle_binary_message(uWS::WebSocket<false, true, PerSocketData>* ws, std::string_view message) {
+    using namespace BinaryProtocol;
+
+    auto press = decodeButtonPress(message);
+    AckStatus status = AckStatus::Accepted;
+    uint16_t sequence = press ? press->sequence : 0;
+
+    if (!press) {
+        status = AckStatus::Malformed;
+    } else if (ws->getUserData()->binaryProtocolVersion == 0 ||
+               press->version != ws->getUserData()->binaryProtocolVersion) {
+        status = AckStatus::NotNegotiated;
+    } else {
+        // Indices are into the page the client is viewing. Page versions are unique, so a
+        // press made on a page the client has just left can't match the new one.
+        auto snapshot = m_configManager.getLayoutSnapshot();
+        const PageLayout* page = snapshot ? snapshot->findPage(ws->getUserData()->pageId) : nullptr;
+        if (!page || static_cast<uint32_t>(page->version) != press->layoutVersion) {
+            status = AckStatus::StaleLayout; // Indices may have shifted; client resyncs
+        } else if (press->buttonIndex >= page->layout.size()) {
+            status = AckStatus::UnknownButton;
+        } else if (m_button_press_handler) {
+            m_button_press_handler(page->layout[press->buttonIndex].id);
+        }
+    }
+
+    if (status != AckStatus::Accepted) {
+        Logger::Warn("[WS] Rejected binary press (status {}, {} bytes)", static_cast<int>(status), message.size());
+    }
+
+    unsigned char ack[PRESS_ACK_SIZE];
+    encodePressAck(sequence, status, ack);
+    send_to_client(ws, std::string_view(reinterpret_cast<const char*>(ack), sizeof(ack)), uWS::OpCode::BINARY);
+}
+
+void CommServer::set_backpressure_limits(const BackpressureLimits& limits) {
+    m_backpressure = limits;
+    if (m_backpressure.lowWatermark > m_backpressure.highWatermark) {
+        m_backpressure.lowWatermark = m_backpressure.highWatermark;
+    }
+}
+
+void CommServer::send_to_client(uWS::WebSocket<false, true, PerSocketData>* ws, std::string_view payload,
+                                uWS::OpCode opCode, std::string_view key) {
+    PerSocketData* data = ws->getUserData();
+    // Fast path: nothing queued and the socket keeps up, so ordering is preserved
+    if (data->outbound.empty() && ws->getBufferedAmount() < m_backpressure.highWatermark) {
+        if (ws->send(payload, opCode) == uWS::WebSocket<false, true, PerSocketData>::DROPPED) {
+            data->outbound.countDropped();
+            mark_congested(ws);
+        }
+        return;
+    }
+
+    if (!data->outbound.push(payload, opCode == uWS::OpCode::BINARY, key, m_backpressure.maxQueuedBytes)) {
+        // The layout state may have gone with the dropped messages
+        mark_congested(ws);
+    }
+}
+
+void CommServer::open_page(uWS::WebSocket<false, true, PerSocketData>* ws, std::string_view pageId) {
+    auto snapshot = m_configManager.getLayoutSnapshot();
+    if (!snapshot) return;
+    const PageLayout* page = snapshot->findPage(pageId);
+    if (!page) {
+        Logger::Warn("[WS] Client asked for unknown page '{}'; sending the root page.", pageId);
+        page = snapshot->findPage("");
+        if (!page) return;
+    }
+
+    PerSocketData* data = ws->getUserData();
+    // A congested client is resubscribed to its current page once it drains
+    if (!data->needsResync) {
+        ws->unsubscribe(pageTopic(data->pageId));
+        ws->subscribe(pageTopic(page->pageId));
+    }
+    data->pageId = page->pageId;
+    // Replaces the previous page if it is still waiting in the queue
+    send_to_client(ws, page->initialConfigMessage(), uWS::OpCode::TEXT, LAYOUT_STATE_KEY);
+    Logger::Debug("[WS] Sent page '{}' v{} ({} buttons) to client.", page->pageId, page->version, page->layout.size());
+}
+
+void CommServer::subscribe_client(uWS::WebSocket<false, true, PerSocketData>* ws) {
+    ws->subscribe(DECK_TOPIC);
+    ws->subscribe(pageTopic(ws->getUserData()->pageId));
+}
+
+void CommServer::unsubscribe_client(uWS::WebSocket<false, true, PerSocketData>* ws) {
+    ws->unsubscribe(DECK_TOPIC);
+    ws->unsubscribe(pageTopic(ws->getUserData()->pageId));
+}
+
+void CommServer::queue_layout_snapshot(uWS::WebSocket<false, true, PerSocketData>* ws,
+                                       const std::shared_ptr<const LayoutSnapshot>& snapshot) {
+    if (!snapshot) return;
+    PerSocketData* data = ws->getUserData();
+    const PageLayout* page = snapshot->findPage(data->pageId);
+    if (!page) {
+        page = snapshot->findPage(""); // The page was removed while the client was behind
+        if (!page) return;
+        data->pageId = page->pageId;
+    }
+    // Both replace any older copy still waiting in the queue
+    bool fits = data->outbound.push(snapshot->deckMessage, false, DECK_STATE_KEY, m_backpressure.maxQueuedBytes);
+    fits = data->outbound.push(page->initialConfigMessage(), false, LAYOUT_STATE_KEY, m_backpressure.maxQueuedBytes) && fits;
+    if (!fits) {
+        Logger::Warn("[WS] Layout snapshot does not fit the client send queue ({} bytes).", m_backpressure.maxQueuedBytes);
+    }
+}
+
+void CommServer::flush_client(uWS::WebSocket<false, true, PerSocketData>* ws) {
+    PerSocketData* data = ws->getUserData();
+    while (!data->outbound.empty() && ws->getBufferedAmount() < m_backpressure.highWatermark) {
+        const OutboundMessage& message = data->outbound.front();
+        auto status = ws->send(message.payload, message.binary ? uWS::OpCode::BINARY : uWS::OpCode::TEXT);
+        if (status == uWS::WebSocket<false, true, PerSocketData>::DROPPED) {
+            data->outbound.countDropped();
+        }
+        data->outbound.pop();
+    }
+
+    if (data->outbound.empty() && data->needsResync) {
+        // The queue ended with the latest full snapshot, so deltas apply again from here
+        subscribe_client(ws);
+        data->needsResync = false;
+        Logger::Info("[WS] Client drained, resumed layout updates.");
+    }
+}
+
+void CommServer::mark_congested(uWS::WebSocket<false, true, PerSocketData>* ws) {
+    PerSocketData* data = ws->getUserData();
+    if (!data->needsResync) {
+        data->needsResync = true;
+        unsubscribe_client(ws);
+        Logger::Warn("[WS] Client send buffer above {} bytes, pausing layout updates until it drains.", m_backpressure.highWatermark);
+    }
+    // Instead of a backlog of deltas the client gets one full snapshot when it catches up
+    queue_layout_snapshot(ws, m_configManager.getLayoutSnapshot());
+}
@@ -8,27 +8,62 @@
 #include <memory>
 #include <atomic>
 #include <optional> // For optional us_listen_socket_t
+#include <mutex>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "ConfigManager.hpp" // Include ConfigManager header
+#include "AssetCache.hpp"    // In-memory static file cache for the HTTP side
+#ifdef WEBSTREAMDECK_HAS_ICON_VARIANTS
+#include "IconVariantCache.hpp" // Icons resized for the client ("?w=96")
+#include "Utils/HashUtils.hpp"
+#endif
+#include "BinaryProtocol.hpp" // Compact binary framing for button presses
+#include "OutboundQueue.hpp"  // Per-client send queue used under backpressure
 
 // Use nlohmann/json
 using json = nlohmann::json;
 
-// Define an empty struct as user data type for each WebSocket
-// to avoid using void, which can cause issues with some compilers/standards.
-struct PerSocketData {};
+// Per-connection state stored by uWS alongside each WebSocket
+struct PerSocketData {
+    // Binary protocol version agreed in the "hello" handshake (0 = JSON only)
+    uint8_t binaryProtocolVersion = 0;
+
+    // Page the client is viewing; it is subscribed to that page's updates only
+    std::string pageId;
+
+    // Messages held back while the socket is above the high watermark
+    OutboundQueue outbound;
+    // Unsubscribed from layout updates because the socket backed up; the latest deck and
+    // initial_config wait in the queue and the socket is resubscribed once it drains
+    bool needsResync = false;
+};
+
+// Send-side flow control limits, in bytes of data buffered for one client
+struct BackpressureLimits {
+    size_t highWatermark = 256 * 1024;  // Stop handing data to uWS above this
+    size_t lowWatermark = 64 * 1024;    // Resume flushing the queue below this
+    size_t maxQueuedBytes = 1024 * 1024; // Cap for the per-client OutboundQueue
+};
 
 // Define the message handler callback function type
 // Parameters: WebSocket connection pointer (with PerSocketData), received JSON object, isBinary flag
 using MessageHandler = std::function<void(uWS::WebSocket<false, true, PerSocketData>*, const json&, bool)>;
 
+// Called on the server thread for every accepted button press, JSON or binary
+// (for binary presses the button id is resolved from the index in the client's page)
+using ButtonPressHandler = std::function<void(std::string_view buttonId)>;
+
 class CommServer {
 public:
     // Modify constructor to accept ConfigManager reference
     explicit CommServer(ConfigManager& configManager);
     ~CommServer();
 
-    // Start the server (synchronous call, but runs the event loop in a separate thread)
-    bool start(int port);
+    // Start the server (synchronous call, but runs the event loop in a separate thread).
+    // An empty host listens on all interfaces; "127.0.0.1" keeps it on loopback.
+    bool start(int port, const std::string& host = "");
 
     // Stop the server
     void stop();
@@ -36,11 +71,52 @@ public:
     // Set the message handler callback
     void set_message_handler(MessageHandler handler);
 
+    // Set the handler for button presses (both the JSON and the binary protocol)
+    void set_button_press_handler(ButtonPressHandler handler);
+
+    // Called on the server thread whenever is_running() changes, e.g. to wake an idle UI
+    // that shows the server state. Set it before start().
+    void set_status_listener(std::function<void()> listener);
+
+    // Configure per-client send limits. Takes effect on the next start().
+    void set_backpressure_limits(const BackpressureLimits& limits);
+
+    // Drop these URL paths from the HTTP asset cache (e.g. icons of buttons that were
+    // edited on disk) so the next request reads them again. Safe from any thread.
+    void invalidate_assets(std::vector<std::string> urlPaths);
+
     // Get the server running state
     bool is_running() const;
 
 private:
     ConfigManager& m_configManager; // Store reference to ConfigManager
+    // Static web files and icons, only accessed from the server thread
+    AssetCache m_assetCache;
+
+#ifdef WEBSTREAMDECK_HAS_ICON_VARIANTS
+    // A response waiting for an icon variant that a worker is still making
+    struct PendingIconResponse {
+        uWS::HttpResponse<false>* res;
+        std::shared_ptr<bool> aborted; // Set by onAborted; res is gone then
+        std::string ifNoneMatch;
+        std::string acceptEncoding;
+    };
+    // Resized icons by URL and size; nullopt when the original is sent instead.
+    // Server thread only, like m_assetCache.
+    std::unordered_map<std::string, std::map<int, std::optional<CachedAsset>>, HashUtils::StringHash, std::equal_to<>>
+        m_iconVariants;
+    // A variant still being made, with the requests waiting for it
+    struct PendingIconVariant {
+        std::vector<PendingIconResponse> responses;
+        bool stale = false; // The icon changed meanwhile; answer the waiting requests but don't keep it
+    };
+    // By URL and size; one job per variant
+    std::map<std::pair<std::string, int>, PendingIconVariant> m_pendingIconVariants;
+    // Makes icon variants on worker threads. Created by the first "?w=" request that misses,
+    // so a server that never gets one never starts the workers; reset by the server thread
+    // when it exits, which joins them while everything their callbacks touch is alive.
+    std::unique_ptr<IconVariantCache> m_iconVariantCache;
+#endif
     // uWebSockets application (event loop)
     // Needs to be a pointer because App is non-copyable/movable
     // and needs to be created/run within the server thread.
@@ -52,15 +128,74 @@ private:
     // Listening socket (for closing)
     // Optional because it's only valid after successful listening.
     std::optional<us_listen_socket_t*> m_listen_socket;
-    // uWS::Loop::defer needs a loop pointer, obtained in constructor.
+    // uWS::Loop::defer needs the server thread's loop. It is set by the server thread
+    // and cleared before that thread exits; m_loopMutex keeps other threads from
+    // deferring onto a loop that is being torn down.
     uWS::Loop* m_loop = nullptr;
+    std::mutex m_loopMutex;
+
+    // Connected clients, only accessed from the server thread
+    std::unordered_set<uWS::WebSocket<false, true, PerSocketData>*> m_clients;
+    BackpressureLimits m_backpressure;
+
+    // ConfigManager listener that publishes layout deltas to connected clients
+    size_t m_configListenerId = 0;
 
     // Message handler function object
     MessageHandler m_message_handler;
+    ButtonPressHandler m_button_press_handler;
+    std::function<void()> m_status_listener;
 
     // Event handling logic setup
-    void configure_app(int port);
+    void configure_app(int port, const std::string& host);
 
     // Server run function (executed in the separate thread)
     void run_loop();
+
+    // Queue a task on the server thread. Returns false if the server is not running.
+    bool defer_to_loop(std::function<void()> task);
+
+    // Writes an asset (or a 304 for a matching If-None-Match), picking the encoding
+    void write_asset(uWS::HttpResponse<false>* res, const CachedAsset& asset, std::string_view ifNoneMatch,
+                     std::string_view acceptEncoding);
+
+#ifdef WEBSTREAMDECK_HAS_ICON_VARIANTS
+    // Answers an "/assets/icons/...?w=" request with the icon resized to `size` pixels.
+    // Returns false if the original should be sent instead.
+    bool serve_icon_variant(uWS::HttpResponse<false>* res, uWS::HttpRequest* req, std::string_view url, int size);
+
+    // Stores a variant made by m_iconVariantCache and answers the requests waiting for it
+    void finish_icon_variant(const std::string& url, int size, IconVariantCache::Variant variant);
+#endif
+
+    // Handles protocol-level JSON messages (hello, get_config, view_page, button_press). Returns true if consumed.
+    bool handle_control_message(uWS::WebSocket<false, true, PerSocketData>* ws, const json& message);
+
+    // Decodes a binary frame, dispatches the press and sends the ack
+    void handle_binary_message(uWS::WebSocket<false, true, PerSocketData>* ws, std::string_view message);
+
+    // Send now if the client keeps up, otherwise queue (coalescing by key when given)
+    void send_to_client(uWS::WebSocket<false, true, PerSocketData>* ws, std::string_view payload,
+                        uWS::OpCode opCode, std::string_view key = {});
+
+    // Hand queued messages to uWS until the high watermark; resync the client once empty
+    void flush_client(uWS::WebSocket<false, true, PerSocketData>* ws);
+
+    // Stop publishing to a backed-up client until it drains
+    void mark_congested(uWS::WebSocket<false, true, PerSocketData>* ws);
+
+    // Switch a client to a page (the root page if it doesn't exist): move its subscription
+    // to that page's topic and send the page in full
+    void open_page(uWS::WebSocket<false, true, PerSocketData>* ws, std::string_view pageId);
+
+    // Subscribe to / unsubscribe from the deck and the client's current page
+    void subscribe_client(uWS::WebSocket<false, true, PerSocketData>* ws);
+    void unsubscribe_client(uWS::WebSocket<false, true, PerSocketData>* ws);
+
+    // Queue (or coalesce) the deck and the client's page in full, for a client that is being resynced
+    void queue_layout_snapshot(uWS::WebSocket<false, true, PerSocketData>* ws,
+                               const std::shared_ptr<const LayoutSnapshot>& snapshot);
+
+    // Publish a config change once to every subscribed client (called on the writer's thread)
+    void publish_layout_update(const std::shared_ptr<const LayoutSnapshot>& snapshot);
 }; 
\ No newline at end of file
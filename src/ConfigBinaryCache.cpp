@@ -0,0 +1,251 @@
+#include "ConfigBinaryCache.hpp"
+#include "ConfigManager.hpp"
+#include "Utils/FileUtils.hpp"
+#include "Utils/HashUtils.hpp"
+#include "Utils/Logger.hpp"
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char CACHE_MAGIC[8] = {'W', 'S', 'D', 'C', 'F', 'G', 'B', '\0'};
+    constexpr uint32_t CACHE_FORMAT_VERSION = 2; // 2: pages
+    constexpr uint32_t BYTE_ORDER_MARK = 0x01020304; // Reads back differently on the other endianness
+
+    struct Header {
+        char magic[8];
+        uint32_t formatVersion;
+        uint32_t byteOrderMark;
+        uint32_t recordSize;
+        uint32_t buttonCount;
+        uint32_t pageCount;
+        uint32_t pageRecordSize;
+        uint64_t sourceSize;
+        int64_t sourceModified;
+        uint64_t sourceHash;
+        uint64_t stringTableSize;
+    };
+
+    struct StringRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    // One ButtonConfig; the field order here is the on-disk order
+    struct Record {
+        StringRef id;
+        StringRef name;
+        StringRef actionType;
+        StringRef actionParam;
+        StringRef iconPath;
+        StringRef page;
+    };
+
+    // One PageConfig
+    struct PageRecord {
+        StringRef id;
+        StringRef name;
+        uint32_t flags;
+        uint32_t reserved;
+    };
+    constexpr uint32_t PAGE_FLAG_FOLDER = 1;
+
+    static_assert(std::is_trivially_copyable_v<Header> && std::is_trivially_copyable_v<Record> &&
+                  std::is_trivially_copyable_v<PageRecord>);
+    static_assert(sizeof(Header) % alignof(Record) == 0, "records must start aligned after the header");
+    static_assert(sizeof(Record) % alignof(PageRecord) == 0, "page records must start aligned after the records");
+    static_assert(sizeof(Record) == 48 && sizeof(PageRecord) == 24);
+
+    // Appends strings to the table once each; repeated values (action types, shared
+    // icons) are stored a single time
+    class StringTableBuilder {
+    public:
+        bool add(const std::string& value, StringRef& ref) {
+            auto it = m_offsets.find(value);
+            if (it != m_offsets.end()) {
+                ref = {it->second, static_cast<uint32_t>(value.size())};
+                return true;
+            }
+            if (m_table.size() + value.size() > std::numeric_limits<uint32_t>::max()) {
+                return false;
+            }
+            ref = {static_cast<uint32_t>(m_table.size()), static_cast<uint32_t>(value.size())};
+            m_offsets.emplace(value, ref.offset);
+            m_table.append(value);
+            return true;
+        }
+        const std::string& table() const { return m_table; }
+
+    private:
+        std::string m_table;
+        std::unordered_map<std::string, uint32_t, HashUtils::StringHash, std::equal_to<>> m_offsets;
+    };
+} // namespace
+
+ConfigBinaryCache::ConfigBinaryCache(fs::path configPath)
+    : m_configPath(std::move(configPath))
+{
+    m_path = m_configPath;
+    m_path += ".cache";
+}
+
+std::optional<ConfigBinaryCache::SourceStamp> ConfigBinaryCache::stampFor(uint64_t contentSize, uint64_t contentHash) const
+{
+    std::error_code ec;
+    auto size = fs::file_size(m_configPath, ec);
+    if (ec || size != contentSize) {
+        return std::nullopt; // Changed again since it was read; don't cache it
+    }
+    auto modified = fs::last_write_time(m_configPath, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    SourceStamp stamp;
+    stamp.size = size;
+    stamp.modified = static_cast<int64_t>(modified.time_since_epoch().count());
+    stamp.contentHash = contentHash;
+    return stamp;
+}
+
+bool ConfigBinaryCache::load(const SourceStamp& source, std::vector<ButtonConfig>& buttons,
+                             std::vector<PageConfig>& pages) const
+{
+    buttons.clear();
+    pages.clear();
+    FileUtils::MappedFile file;
+    std::string error;
+    if (!file.open(m_path, error)) {
+        Logger::Debug("[ConfigCache] No usable cache at {} ({})", m_path, error);
+        return false;
+    }
+    std::string_view data = file.view();
+
+    Header header;
+    if (data.size() < sizeof(header)) {
+        Logger::Warn("[ConfigCache] {} is truncated; ignoring it.", m_path);
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.formatVersion != CACHE_FORMAT_VERSION || header.byteOrderMark != BYTE_ORDER_MARK ||
+        header.recordSize != sizeof(Record) || header.pageRecordSize != sizeof(PageRecord)) {
+        Logger::Info("[ConfigCache] {} has an unknown format; it will be rebuilt.", m_path);
+        return false;
+    }
+    SourceStamp cached{header.sourceSize, header.sourceModified, header.sourceHash};
+    if (!(cached == source)) {
+        Logger::Debug("[ConfigCache] {} is stale; it will be rebuilt.", m_path);
+        return false;
+    }
+    uint64_t recordsBytes = uint64_t(header.buttonCount) * sizeof(Record);
+    uint64_t pageRecordsBytes = uint64_t(header.pageCount) * sizeof(PageRecord);
+    if (uint64_t(data.size()) != sizeof(Header) + recordsBytes + pageRecordsBytes + header.stringTableSize) {
+        Logger::Warn("[ConfigCache] {} has an inconsistent size; ignoring it.", m_path);
+        return false;
+    }
+
+    // Records are read straight out of the mapping; only the final strings are allocated
+    const auto* records = reinterpret_cast<const Record*>(data.data() + sizeof(Header));
+    const auto* pageRecords = reinterpret_cast<const PageRecord*>(data.data() + sizeof(Header) + recordsBytes);
+    std::string_view strings = data.substr(sizeof(Header) + recordsBytes + pageRecordsBytes);
+    bool valid = true;
+    auto text = [&](const StringRef& ref) -> std::string_view {
+        if (uint64_t(ref.offset) + ref.length > strings.size()) {
+            valid = false;
+            return {};
+        }
+        return strings.substr(ref.offset, ref.length);
+    };
+
+    buttons.reserve(header.buttonCount);
+    for (uint32_t i = 0; i < header.buttonCount && valid; ++i) {
+        const Record& record = records[i];
+        ButtonConfig& button = buttons.emplace_back();
+        button.id = text(record.id);
+        button.name = text(record.name);
+        button.action_type = text(record.actionType);
+        button.action_param = text(record.actionParam);
+        button.icon_path = text(record.iconPath);
+        button.page = text(record.page);
+    }
+    pages.reserve(header.pageCount);
+    for (uint32_t i = 0; i < header.pageCount && valid; ++i) {
+        const PageRecord& record = pageRecords[i];
+        PageConfig& page = pages.emplace_back();
+        page.id = text(record.id);
+        page.name = text(record.name);
+        page.folder = (record.flags & PAGE_FLAG_FOLDER) != 0;
+    }
+    if (!valid) {
+        Logger::Warn("[ConfigCache] {} references strings out of range; ignoring it.", m_path);
+        buttons.clear();
+        pages.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ConfigBinaryCache::store(const std::vector<ButtonConfig>& buttons, const std::vector<PageConfig>& pages,
+                              const SourceStamp& source) const
+{
+    if (buttons.size() > std::numeric_limits<uint32_t>::max() || pages.size() > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    StringTableBuilder strings;
+    std::vector<Record> records(buttons.size());
+    for (size_t i = 0; i < buttons.size(); ++i) {
+        const ButtonConfig& button = buttons[i];
+        Record& record = records[i];
+        if (!strings.add(button.id, record.id) || !strings.add(button.name, record.name) ||
+            !strings.add(button.action_type, record.actionType) ||
+            !strings.add(button.action_param, record.actionParam) ||
+            !strings.add(button.icon_path, record.iconPath) || !strings.add(button.page, record.page)) {
+            Logger::Warn("[ConfigCache] Configuration too large for {}; not caching it.", m_path);
+            return false;
+        }
+    }
+    std::vector<PageRecord> pageRecords(pages.size());
+    for (size_t i = 0; i < pages.size(); ++i) {
+        const PageConfig& page = pages[i];
+        PageRecord& record = pageRecords[i];
+        record.flags = page.folder ? PAGE_FLAG_FOLDER : 0;
+        if (!strings.add(page.id, record.id) || !strings.add(page.name, record.name)) {
+            Logger::Warn("[ConfigCache] Configuration too large for {}; not caching it.", m_path);
+            return false;
+        }
+    }
+
+    Header header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.formatVersion = CACHE_FORMAT_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.recordSize = sizeof(Record);
+    header.buttonCount = static_cast<uint32_t>(buttons.size());
+    header.pageCount = static_cast<uint32_t>(pages.size());
+    header.pageRecordSize = sizeof(PageRecord);
+    header.sourceSize = source.size;
+    header.sourceModified = source.modified;
+    header.sourceHash = source.contentHash;
+    header.stringTableSize = strings.table().size();
+
+    std::string content;
+    content.reserve(sizeof(Header) + records.size() * sizeof(Record) + pageRecords.size() * sizeof(PageRecord) +
+                    strings.table().size());
+    content.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    content.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+    content.append(reinterpret_cast<const char*>(pageRecords.data()), pageRecords.size() * sizeof(PageRecord));
+    content.append(strings.table());
+
+    std::string error;
+    std::lock_guard<std::mutex> lock(m_storeMutex);
+    if (!FileUtils::WriteFileAtomically(m_path, content, error)) {
+        Logger::Warn("[ConfigCache] Could not write {}: {}", m_path, error);
+        return false;
+    }
+    Logger::Debug("[ConfigCache] Wrote {} ({} buttons, {} pages, {} bytes)", m_path, buttons.size(), pages.size(),
+                  content.size());
+    return true;
+}
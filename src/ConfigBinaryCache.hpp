@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct ButtonConfig;
+struct PageConfig;
+
+// Binary sidecar of config.json ("config.json.cache") so large decks load without a
+// JSON parse. Layout, native endianness:
+//
+//   Header | Record[buttonCount] | PageRecord[pageCount] | string table
+//
+// Each record holds (offset, length) pairs into the string table for the string fields
+// of a ButtonConfig or PageConfig. The header records the size, modification time and content
+// hash of the JSON it was built from; load() only accepts a sidecar whose stamp matches
+// the JSON on disk exactly, so the JSON stays the single source of truth.
+class ConfigBinaryCache {
+public:
+    // Identifies one version of the JSON file
+    struct SourceStamp {
+        uint64_t size = 0;
+        int64_t modified = 0;     // last_write_time, in file clock ticks
+        uint64_t contentHash = 0; // HashUtils::XxHash64 of the file contents
+
+        bool operator==(const SourceStamp&) const = default;
+    };
+
+    explicit ConfigBinaryCache(std::filesystem::path configPath);
+
+    // Stamp for contents of `contentSize` bytes hashing to `contentHash` that were just
+    // read from (or written to) the JSON file. Nullopt if the file can't be stat'ed or
+    // no longer has that size.
+    std::optional<SourceStamp> stampFor(uint64_t contentSize, uint64_t contentHash) const;
+
+    // Maps the sidecar and decodes its records if it was built from `source`.
+    // Returns false (leaving the outputs empty) if it is missing, stale or malformed.
+    bool load(const SourceStamp& source, std::vector<ButtonConfig>& buttons, std::vector<PageConfig>& pages) const;
+
+    // Rewrites the sidecar (atomically) for `buttons` and `pages` as parsed from `source`.
+    // Safe to call from several threads (saves and hot reloads).
+    bool store(const std::vector<ButtonConfig>& buttons, const std::vector<PageConfig>& pages,
+               const SourceStamp& source) const;
+
+    const std::filesystem::path& path() const { return m_path; }
+
+private:
+    std::filesystem::path m_configPath;
+    std::filesystem::path m_path;
+    mutable std::mutex m_storeMutex; // Writers share the temp file
+};
@@ -1,145 +1,561 @@
 #include "ConfigManager.hpp"
-#include <fstream>
-#include <iostream> // For error reporting, consider a proper logger later
+#include "Utils/FileUtils.hpp"
+#include "Utils/Logger.hpp"
 #include <filesystem> // For checking if file exists
+#include <algorithm>  // For std::replace, std::remove_if
+#include <unordered_map>
+#include <unordered_set>
+#include <string_view>
+#include <mutex>
 
 namespace fs = std::filesystem;
 using json = nlohmann::json;
 
-ConfigManager::ConfigManager(const std::string& filename) : m_configFilePath(filename)
+namespace {
+    // Icons are served by CommServer from this directory under the same URL path
+    const std::string ASSETS_ICONS_PREFIX = "assets/icons";
+
+    // Paths already warned about by toWebIconPath(); snapshots are rebuilt on every edit and reload
+    std::mutex warnedIconPathsMutex;
+    std::unordered_set<std::string> warnedIconPaths;
+
+    // Converts a configured icon file path to the URL path the web UI should request
+    std::string toWebIconPath(const std::string& iconPath) {
+        if (iconPath.empty()) {
+            return "";
+        }
+
+        std::string pathStr = iconPath;
+        // Normalize separators first
+        std::replace(pathStr.begin(), pathStr.end(), '\\', '/');
+
+        std::string webIconPath;
+        if (pathStr.rfind(ASSETS_ICONS_PREFIX, 0) == 0) {
+            // If it starts with "assets/icons", use it directly
+            webIconPath = "/" + pathStr;
+        } else if (pathStr.find('/') == std::string::npos) {
+            // Looks like just a filename; assume it lives in assets/icons/
+            Logger::Debug("Button icon path '{}' looks like a filename. Assuming it's in assets/icons/.", iconPath);
+            webIconPath = "/" + ASSETS_ICONS_PREFIX + "/" + pathStr;
+        } else {
+            // Absolute or unexpected relative path. A truly robust solution needs
+            // consistent relative paths in config; best guess fallback for now.
+            bool firstTime;
+            {
+                std::lock_guard<std::mutex> lock(warnedIconPathsMutex);
+                firstTime = warnedIconPaths.insert(iconPath).second;
+            }
+            if (firstTime) {
+                Logger::Warn("Button icon path '{}' is not a standard relative path starting with '{}'. Icon might not load correctly in web UI.", iconPath, ASSETS_ICONS_PREFIX);
+            }
+            webIconPath = "/" + pathStr;
+        }
+        // Ensure no double slashes at the beginning (e.g., if pathStr started with /)
+        if (webIconPath.length() > 1 && webIconPath[0] == '/' && webIconPath[1] == '/') {
+            webIconPath = webIconPath.substr(1);
+        }
+        return webIconPath;
+    }
+
+    // config.json contents for a snapshot: a "buttons" array and, if any are configured,
+    // a "pages" array, pretty-printed
+    std::string serializeConfig(const ConfigSnapshot& snapshot) {
+        json configJson;
+        configJson["buttons"] = snapshot.buttons;
+        if (!snapshot.pages.empty()) {
+            configJson["pages"] = snapshot.pages;
+        }
+        // Use 4 spaces for indentation; replace invalid UTF-8 rather than failing the save
+        return configJson.dump(4, ' ', false, json::error_handler_t::replace);
+    }
+
+    // Appends `value` as a JSON string literal, byte for byte what
+    // json::dump(-1, ' ', false, json::error_handler_t::replace) produces for it
+    void appendJsonString(std::string& out, std::string_view value) {
+        bool ascii = std::all_of(value.begin(), value.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+        if (!ascii) {
+            // Let nlohmann validate the UTF-8 (and replace invalid sequences)
+            out += json(std::string(value)).dump(-1, ' ', false, json::error_handler_t::replace);
+            return;
+        }
+        out += '"';
+        for (char c : value) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        static const char HEX[] = "0123456789abcdef";
+                        out += "\\u00";
+                        out += HEX[(c >> 4) & 0xF];
+                        out += HEX[c & 0xF];
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+    }
+
+    // The {"type":"initial_config",...} frame for one page. Written directly instead of
+    // through a json DOM: with tens of thousands of buttons, building, dumping and
+    // freeing the DOM was most of the startup time. Same bytes as the DOM would produce
+    // (nlohmann orders object keys alphabetically).
+    std::string serializeInitialConfig(std::string_view pageId, uint64_t version, const std::vector<WebLayoutEntry>& layout) {
+        std::string out;
+        size_t estimate = 80 + pageId.size();
+        for (const auto& entry : layout) {
+            estimate += 40 + entry.id.size() + entry.name.size() + entry.icon_path.size();
+            if (!entry.folder.empty()) estimate += 12 + entry.folder.size();
+        }
+        out.reserve(estimate);
+        out += "{\"payload\":{\"layout\":[";
+        for (size_t i = 0; i < layout.size(); ++i) {
+            if (i > 0) out += ',';
+            out += '{';
+            if (!layout[i].folder.empty()) {
+                out += "\"folder\":";
+                appendJsonString(out, layout[i].folder);
+                out += ',';
+            }
+            out += "\"icon_path\":";
+            appendJsonString(out, layout[i].icon_path);
+            out += ",\"id\":";
+            appendJsonString(out, layout[i].id);
+            out += ",\"name\":";
+            appendJsonString(out, layout[i].name);
+            out += '}';
+        }
+        out += "],\"page\":";
+        appendJsonString(out, pageId);
+        out += ",\"version\":";
+        out += std::to_string(version);
+        out += "},\"type\":\"initial_config\"}";
+        return out;
+    }
+
+    // The {"type":"deck",...} frame: every page a client can open
+    std::string serializeDeck(uint64_t version, const std::vector<PageConfig>& pages) {
+        json deckMsg = {
+            {"type", "deck"},
+            {"payload", {{"pages", pages}, {"version", version}}}
+        };
+        return deckMsg.dump(-1, ' ', false, json::error_handler_t::replace);
+    }
+
+    // Fills snapshot.deck (see ConfigSnapshot) from its buttons and pages
+    void buildDeck(ConfigSnapshot& snapshot, bool warnOnDuplicates) {
+        auto addPage = [&snapshot](PageConfig page) {
+            snapshot.deckIndexById.emplace(page.id, static_cast<uint32_t>(snapshot.deck.size()));
+            snapshot.deck.push_back({std::move(page), {}});
+        };
+
+        // The root page always comes first and can't be a folder
+        PageConfig root;
+        for (const auto& page : snapshot.pages) {
+            if (page.id.empty()) {
+                root = page;
+                break;
+            }
+        }
+        root.folder = false;
+        addPage(std::move(root));
+        for (const auto& page : snapshot.pages) {
+            if (snapshot.deckIndexById.count(page.id)) {
+                if (warnOnDuplicates && !page.id.empty()) {
+                    Logger::Warn("Duplicate page ID '{}' in configuration; only the first one is used.", page.id);
+                }
+                continue;
+            }
+            addPage(page);
+        }
+
+        // Pages only buttons name are folders if something opens them, top-level pages otherwise
+        std::unordered_set<std::string_view> folderTargets;
+        for (const auto& button : snapshot.buttons) {
+            if (button.action_type == OPEN_FOLDER_ACTION) folderTargets.insert(button.action_param);
+        }
+        for (size_t i = 0; i < snapshot.buttons.size(); ++i) {
+            const std::string& pageId = snapshot.buttons[i].page;
+            auto it = snapshot.deckIndexById.find(pageId);
+            if (it == snapshot.deckIndexById.end()) {
+                addPage({pageId, pageId, folderTargets.count(pageId) > 0});
+                it = snapshot.deckIndexById.find(pageId);
+            }
+            snapshot.deck[it->second].buttons.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    bool sameButton(const ButtonConfig& a, const ButtonConfig& b) {
+        return a.name == b.name && a.action_type == b.action_type && a.action_param == b.action_param &&
+               a.icon_path == b.icon_path && a.page == b.page;
+    }
+
+    // Compares a freshly loaded button list with the current snapshot by id. With
+    // duplicate ids only the first one counts, as it does for lookups.
+    ConfigDiff diffButtons(const ConfigSnapshot& previous, const std::vector<ButtonConfig>& buttons,
+                           const std::vector<PageConfig>& pages) {
+        ConfigDiff diff;
+        diff.pagesChanged = previous.pages != pages;
+        std::unordered_set<std::string> staleIcons;
+        auto markStale = [&](const std::string& iconPath, std::string iconUrl) {
+            if (iconPath.empty() || !staleIcons.insert(iconPath).second) return;
+            diff.staleIconPaths.push_back(iconPath);
+            diff.staleIconUrls.push_back(std::move(iconUrl));
+        };
+        auto previousIconUrl = [&](uint32_t index) { return toWebIconPath(previous.buttons[index].icon_path); };
+
+        std::unordered_map<std::string_view, size_t> currentById;
+        currentById.reserve(buttons.size());
+        std::vector<std::string_view> survivingCurrentOrder;
+        for (size_t i = 0; i < buttons.size(); ++i) {
+            const ButtonConfig& button = buttons[i];
+            if (!currentById.try_emplace(button.id, i).second) continue;
+            auto previousIndex = previous.indexOf(button.id);
+            if (!previousIndex) {
+                diff.added.push_back(button.id);
+                markStale(button.icon_path, toWebIconPath(button.icon_path));
+                continue;
+            }
+            survivingCurrentOrder.push_back(button.id);
+            const ButtonConfig& old = previous.buttons[*previousIndex];
+            if (sameButton(old, button)) continue;
+            diff.changed.push_back(button.id);
+            if (old.icon_path != button.icon_path) {
+                markStale(old.icon_path, previousIconUrl(*previousIndex));
+                markStale(button.icon_path, toWebIconPath(button.icon_path));
+            }
+        }
+
+        std::vector<std::string_view> survivingPreviousOrder;
+        for (size_t i = 0; i < previous.buttons.size(); ++i) {
+            const ButtonConfig& old = previous.buttons[i];
+            auto firstIndex = previous.indexOf(old.id);
+            if (!firstIndex || *firstIndex != i) continue; // Shadowed duplicate
+            if (currentById.find(old.id) == currentById.end()) {
+                diff.removed.push_back(old.id);
+                markStale(old.icon_path, previousIconUrl(static_cast<uint32_t>(i)));
+            } else {
+                survivingPreviousOrder.push_back(old.id);
+            }
+        }
+        diff.reordered = survivingPreviousOrder != survivingCurrentOrder;
+        return diff;
+    }
+
+    // Reads the "buttons" array and, if present, the "pages" array of config.json.
+    // Returns false if there is no "buttons" array; throws json::exception on bad fields.
+    bool readConfigLists(const json& configJson, std::vector<ButtonConfig>& buttons, std::vector<PageConfig>& pages) {
+        if (!configJson.contains("buttons") || !configJson["buttons"].is_array()) {
+            return false;
+        }
+        configJson.at("buttons").get_to(buttons);
+        if (configJson.contains("pages") && configJson["pages"].is_array()) {
+            configJson.at("pages").get_to(pages);
+        }
+        return true;
+    }
+
+    json layoutEntryToJson(const WebLayoutEntry& entry) {
+        json item = {
+            {"id", entry.id},
+            {"name", entry.name},
+            {"icon_path", entry.icon_path}
+        };
+        if (!entry.folder.empty()) {
+            item["folder"] = entry.folder;
+        }
+        return item;
+    }
+
+    // Builds the layout_update payload turning `previous` into `current`.
+    // Clients apply it as: drop "removed", patch "changed" in place, insert "added" at
+    // their "index" (ascending), then reorder by "order" if present.
+    // Returns false if the two layouts are identical.
+    bool buildLayoutDelta(const std::vector<WebLayoutEntry>& previous,
+                          const std::vector<WebLayoutEntry>& current,
+                          json& delta) {
+        std::unordered_map<std::string_view, const WebLayoutEntry*> previousById;
+        previousById.reserve(previous.size());
+        for (const auto& entry : previous) {
+            previousById.emplace(entry.id, &entry);
+        }
+        std::unordered_map<std::string_view, size_t> currentById;
+        currentById.reserve(current.size());
+        for (size_t i = 0; i < current.size(); ++i) {
+            currentById.emplace(current[i].id, i);
+        }
+
+        json added = json::array();
+        json changed = json::array();
+        json removed = json::array();
+        std::vector<std::string_view> survivingCurrentOrder;
+
+        for (size_t i = 0; i < current.size(); ++i) {
+            const auto& entry = current[i];
+            auto it = previousById.find(entry.id);
+            if (it == previousById.end()) {
+                json item = layoutEntryToJson(entry);
+                item["index"] = i;
+                added.push_back(std::move(item));
+                continue;
+            }
+            survivingCurrentOrder.push_back(entry.id);
+            if (!(*it->second == entry)) {
+                changed.push_back(layoutEntryToJson(entry));
+            }
+        }
+
+        std::vector<std::string_view> survivingPreviousOrder;
+        for (const auto& entry : previous) {
+            if (currentById.find(entry.id) == currentById.end()) {
+                removed.push_back(entry.id);
+            } else {
+                survivingPreviousOrder.push_back(entry.id);
+            }
+        }
+
+        bool reordered = (survivingPreviousOrder != survivingCurrentOrder);
+        if (added.empty() && changed.empty() && removed.empty() && !reordered) {
+            return false;
+        }
+
+        delta["added"] = std::move(added);
+        delta["changed"] = std::move(changed);
+        delta["removed"] = std::move(removed);
+        if (reordered) {
+            json order = json::array();
+            for (const auto& entry : current) order.push_back(entry.id);
+            delta["order"] = std::move(order);
+        }
+        return true;
+    }
+} // namespace
+
+ConfigManager::ConfigManager(const std::string& filename) : m_configFilePath(filename), m_binaryCache(filename)
 {
+    // Start from an empty generation 0 so getSnapshot() is never null
+    m_snapshot.store(std::make_shared<const ConfigSnapshot>(), std::memory_order_release);
+    m_persister = std::make_unique<ConfigPersister>(m_configFilePath, serializeConfig);
+    // Keep the sidecar in step with what we save, so the next launch can skip the parse
+    m_persister->setWrittenCallback([this](const ConfigSnapshot& snapshot, std::string_view content, uint64_t contentHash) {
+        if (auto stamp = m_binaryCache.stampFor(content.size(), contentHash)) {
+            m_binaryCache.store(snapshot.buttons, snapshot.pages, *stamp);
+        }
+    });
+
     if (!loadConfig()) {
-        std::cerr << "Warning: Failed to load configuration from " << m_configFilePath 
-                  << ". Attempting to load/create default configuration." << std::endl;
+        Logger::Warn("Failed to load configuration from {}. Attempting to load/create default configuration.", m_configFilePath);
         loadDefaultConfig();
-        std::cout << "Attempting to save default configuration..." << std::endl;
-        saveConfig(); 
+        Logger::Info("Attempting to save default configuration...");
+        scheduleSave();
     }
 }
 
 bool ConfigManager::loadConfig()
 {
     if (!fs::exists(m_configFilePath)) {
-         std::cerr << "Info: Configuration file not found: " << m_configFilePath << std::endl;
+         Logger::Info("Configuration file not found: {}", m_configFilePath);
          return false; // Indicate failure so constructor loads default
     }
 
-    std::ifstream configFile(m_configFilePath);
-    if (!configFile.is_open()) {
-        std::cerr << "Error: Could not open configuration file: " << m_configFilePath << std::endl;
+    std::string content;
+    std::string readError;
+    if (!FileUtils::ReadWholeFile(m_configFilePath, content, readError)) {
+        Logger::Error("Could not read configuration file {}: {}", m_configFilePath, readError);
         return false;
     }
 
+    // The JSON is hashed either way: it validates the binary sidecar, and it is what
+    // is on disk now, so saving it unchanged costs nothing
+    uint64_t contentHash = HashUtils::XxHash64(content);
+    auto stamp = m_binaryCache.stampFor(content.size(), contentHash);
+    if (stamp) {
+        std::vector<ButtonConfig> cachedButtons;
+        std::vector<PageConfig> cachedPages;
+        if (m_binaryCache.load(*stamp, cachedButtons, cachedPages)) {
+            size_t count = cachedButtons.size();
+            size_t pageCount = cachedPages.size();
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            publishLocked(std::move(cachedButtons), std::move(cachedPages), true);
+            m_persister->setBaseline(contentHash);
+            Logger::Info("Configuration loaded from {} ({} buttons, {} pages, binary cache)", m_configFilePath, count, pageCount);
+            return true;
+        }
+    }
+
+    // A failed load leaves no buttons behind, as before
+    auto discardButtons = [this]() {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        auto current = getSnapshot();
+        if (!current->buttons.empty() || !current->pages.empty()) publishLocked({}, {});
+    };
+
     try {
-        json configJson;
-        configFile >> configJson;
-        configFile.close(); // Close file after reading
+        json configJson = json::parse(content);
 
-        // Expecting a top-level key, e.g., "buttons", containing an array
-        if (configJson.contains("buttons") && configJson["buttons"].is_array()) {
-             // Use the safe get_to method for better error handling with the macro
-            configJson.at("buttons").get_to(m_buttons);
+        // Expecting a top-level key, e.g., "buttons", containing an array (and optionally "pages")
+        std::vector<ButtonConfig> buttons;
+        std::vector<PageConfig> pages;
+        if (readConfigLists(configJson, buttons, pages)) {
+            std::shared_ptr<const ConfigSnapshot> loaded;
+            {
+                std::lock_guard<std::mutex> lock(m_writeMutex);
+                publishLocked(std::move(buttons), std::move(pages), true);
+                m_persister->setBaseline(contentHash);
+                loaded = getSnapshot();
+            }
+            if (stamp) {
+                m_binaryCache.store(loaded->buttons, loaded->pages, *stamp);
+            }
         } else {
-            std::cerr << "Error: Configuration file " << m_configFilePath << " does not contain a 'buttons' array." << std::endl;
-            m_buttons.clear(); 
+            Logger::Error("Configuration file {} does not contain a 'buttons' array.", m_configFilePath);
+            discardButtons();
             return false;
         }
 
-        std::cout << "Configuration loaded successfully from " << m_configFilePath << std::endl;
+        Logger::Info("Configuration loaded successfully from {}", m_configFilePath);
         return true;
 
     } catch (json::parse_error& e) {
-        std::cerr << "Error parsing configuration file: " << m_configFilePath 
-                  << "\nMessage: " << e.what() 
-                  << "\nException id: " << e.id 
-                  << "\nByte position of error: " << e.byte << std::endl;
-        m_buttons.clear(); 
+        Logger::Error("Error parsing configuration file: {}\nMessage: {}\nException id: {}\nByte position of error: {}", m_configFilePath, e.what(), e.id, e.byte);
+        discardButtons();
         return false;
     } catch (json::exception& e) { // Catch other json exceptions (like type errors)
-        std::cerr << "Error processing JSON configuration in " << m_configFilePath << ": " << e.what() << std::endl;
-        m_buttons.clear();
+        Logger::Error("Error processing JSON configuration in {}: {}", m_configFilePath, e.what());
+        discardButtons();
         return false;
     } catch (const std::exception& e) {
-        std::cerr << "An unknown error occurred while loading the configuration file " << m_configFilePath << ": " << e.what() << std::endl;
-        m_buttons.clear();
+        Logger::Error("An unknown error occurred while loading the configuration file {}: {}", m_configFilePath, e.what());
+        discardButtons();
         return false;
     }
 }
 
 
-bool ConfigManager::saveConfig()
+std::optional<ConfigDiff> ConfigManager::reloadFromDisk()
 {
-    std::ofstream configFile(m_configFilePath);
-    if (!configFile.is_open()) {
-        std::cerr << "Error: Could not open configuration file for writing: " << m_configFilePath << std::endl;
-        return false;
+    std::string content;
+    std::string readError;
+    if (!FileUtils::ReadWholeFile(m_configFilePath, content, readError)) {
+        Logger::Warn("[Config] Could not read {} for reloading ({}); keeping the current configuration.",
+                     m_configFilePath, readError);
+        return std::nullopt;
+    }
+
+    uint64_t contentHash = HashUtils::XxHash64(content);
+    if (m_persister->matchesBaseline(contentHash)) {
+        Logger::Debug("[Config] {} matches what was last loaded or saved; nothing to reload.", m_configFilePath);
+        return std::nullopt;
     }
 
+    // Unlike loadConfig, a broken file (often one caught half-written) keeps what we have
+    std::vector<ButtonConfig> buttons;
+    std::vector<PageConfig> pages;
     try {
-        // Create a JSON object with a "buttons" key holding the array
-        json configJson;
-        configJson["buttons"] = m_buttons;
+        json configJson = json::parse(content);
+        if (!readConfigLists(configJson, buttons, pages)) {
+            Logger::Error("[Config] {} does not contain a 'buttons' array; keeping the current configuration.", m_configFilePath);
+            return std::nullopt;
+        }
+    } catch (const json::exception& e) {
+        Logger::Error("[Config] Could not reload {}: {}. Keeping the current configuration.", m_configFilePath, e.what());
+        return std::nullopt;
+    }
 
-        // Write to file with pretty printing (indentation)
-        configFile << configJson.dump(4); // Use 4 spaces for indentation
-        configFile.close(); // Close file after writing
-        
-        std::cout << "Configuration saved successfully to " << m_configFilePath << std::endl;
-        return true;
+    // The sidecar describes the file, whatever the diff turns out to be
+    if (auto stamp = m_binaryCache.stampFor(content.size(), contentHash)) {
+        m_binaryCache.store(buttons, pages, *stamp);
+    }
 
-    } catch (json::exception& e) {
-        std::cerr << "Error creating JSON or writing configuration file " << m_configFilePath << ": " << e.what() << std::endl;
-        return false;
-    } catch (const std::exception& e) {
-         std::cerr << "An unknown error occurred while saving the configuration file " << m_configFilePath << ": " << e.what() << std::endl;
-        return false;
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    ConfigDiff diff = diffButtons(*getSnapshot(), buttons, pages);
+    // The file is now the newest state; a save still waiting to run would overwrite it
+    m_persister->discardPending();
+    m_persister->setBaseline(contentHash);
+    if (diff.empty()) {
+        Logger::Info("[Config] {} changed on disk without changing any buttons or pages.", m_configFilePath);
+        return std::nullopt;
     }
+    publishLocked(std::move(buttons), std::move(pages), true);
+    Logger::Info("[Config] Reloaded {}: {} added, {} removed, {} changed{}{}, {} stale icons.", m_configFilePath,
+                 diff.added.size(), diff.removed.size(), diff.changed.size(), diff.reordered ? ", reordered" : "",
+                 diff.pagesChanged ? ", pages changed" : "", diff.staleIconPaths.size());
+    return diff;
+}
+
+void ConfigManager::scheduleSave()
+{
+    m_persister->save(getSnapshot());
 }
 
-const std::vector<ButtonConfig>& ConfigManager::getButtons() const
+bool ConfigManager::flushPendingSave()
 {
-    return m_buttons;
+    return m_persister->flush();
 }
 
+ConfigPersister::Stats ConfigManager::getSaveStats() const
+{
+    return m_persister->getStats();
+}
+
+std::shared_ptr<const ConfigSnapshot> ConfigManager::getSnapshot() const
+{
+    return m_snapshot.load(std::memory_order_acquire);
+}
 
 std::optional<ButtonConfig> ConfigManager::getButtonById(const std::string& id) const
 {
-    for (const auto& button : m_buttons) {
-        if (button.id == id) {
-            return button;
-        }
+    auto snapshot = getSnapshot();
+    if (const ButtonConfig* button = snapshot->find(id)) {
+        return *button;
     }
     return std::nullopt;
 }
 
+uint64_t ConfigManager::getGeneration() const
+{
+    return getSnapshot()->generation;
+}
+
 void ConfigManager::loadDefaultConfig()
 {
-    std::cout << "Loading default button configuration." << std::endl;
-    m_buttons = {
+    Logger::Info("Loading default button configuration.");
+    std::vector<ButtonConfig> buttons = {
         {"btn_notepad", "Notepad", "launch_app", "notepad.exe", ""},
         {"btn_calc", "Calculator", "launch_app", "calc.exe", ""},
         {"btn_google", "Google", "open_url", "https://google.com", ""},
         // Add more default buttons as needed
     };
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    publishLocked(std::move(buttons), {});
 }
 
 // --- Implementations for modifying methods --- 
-// Uncomment and adjust addButton
+// Each one edits a copy of the current buttons under m_writeMutex and publishes it;
+// readers keep using the snapshot they already hold.
 bool ConfigManager::addButton(const ButtonConfig& button)
 {
     // Basic validation: Check for empty ID or Name
     if (button.id.empty() || button.name.empty()) {
-        std::cerr << "Error: Cannot add button with empty ID or Name." << std::endl;
+        Logger::Error("Cannot add button with empty ID or Name.");
         return false;
     }
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto current = getSnapshot();
     // Check for duplicate ID
-    for (const auto& existingButton : m_buttons) {
-        if (existingButton.id == button.id) {
-             std::cerr << "Error: Button with ID '" << button.id << "' already exists." << std::endl;
-            return false;
-        }
+    if (current->find(button.id)) {
+        Logger::Error("Button with ID '{}' already exists.", button.id);
+        return false;
     }
-    m_buttons.push_back(button);
+    std::vector<ButtonConfig> buttons = current->buttons;
+    buttons.push_back(button);
+    publishLocked(std::move(buttons), current->pages);
     // return saveConfig(); // REMOVED: Do not save immediately
     return true; // Indicate success
 }
@@ -149,39 +565,242 @@ bool ConfigManager::updateButton(const std::string& id, const ButtonConfig& upda
 {
     // Basic validation for updated button
     if (updatedButton.name.empty()) {
-        std::cerr << "Error: Updated button name cannot be empty." << std::endl;
+        Logger::Error("Updated button name cannot be empty.");
         return false;
     }
     // ID check: Ensure the ID in the updatedButton matches the target id (optional but good practice)
     if (updatedButton.id != id) {
-         std::cerr << "Error: Mismatched ID during update attempt (Target: " << id << ", Provided: " << updatedButton.id << "). ID cannot be changed." << std::endl;
+         Logger::Error("Mismatched ID during update attempt (Target: {}, Provided: {}). ID cannot be changed.", id, updatedButton.id);
          return false;
     }
 
-    for (auto& button : m_buttons) {
-        if (button.id == id) {
-            // Update fields (except ID)
-            button.name = updatedButton.name;
-            button.action_type = updatedButton.action_type;
-            button.action_param = updatedButton.action_param;
-            button.icon_path = updatedButton.icon_path; // UNCOMMENTED: If using icons
-            
-            // REMOVED: Do not save immediately
-            // return saveConfig(); 
-            return true; // Indicate success
-        }
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto current = getSnapshot();
+    auto index = current->indexOf(id);
+    if (!index) {
+        Logger::Error("Button with ID '{}' not found for update.", id);
+        return false; // Button not found
     }
-    std::cerr << "Error: Button with ID '" << id << "' not found for update." << std::endl;
-    return false; // Button not found
+    std::vector<ButtonConfig> buttons = current->buttons;
+    ButtonConfig& button = buttons[*index];
+    // Update fields (except ID)
+    button.name = updatedButton.name;
+    button.action_type = updatedButton.action_type;
+    button.action_param = updatedButton.action_param;
+    button.icon_path = updatedButton.icon_path; // UNCOMMENTED: If using icons
+    button.page = updatedButton.page;
+    publishLocked(std::move(buttons), current->pages);
+
+    // REMOVED: Do not save immediately
+    // return saveConfig(); 
+    return true; // Indicate success
 }
 
 bool ConfigManager::removeButton(const std::string& id)
 {
-    auto it = std::remove_if(m_buttons.begin(), m_buttons.end(), 
-                             [&id](const ButtonConfig& b){ return b.id == id; });
-    if (it != m_buttons.end()) {
-        m_buttons.erase(it, m_buttons.end());
-        return true; // Indicate success
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto current = getSnapshot();
+    auto index = current->indexOf(id);
+    if (!index) {
+        return false; // Button not found
+    }
+    std::vector<ButtonConfig> buttons = current->buttons;
+    buttons.erase(buttons.begin() + *index);
+    publishLocked(std::move(buttons), current->pages);
+    return true; // Indicate success
+}
+
+bool ConfigManager::replaceButtons(std::vector<ButtonConfig> buttons)
+{
+    std::unordered_map<std::string_view, size_t> seen;
+    seen.reserve(buttons.size());
+    for (size_t i = 0; i < buttons.size(); ++i) {
+        if (buttons[i].id.empty()) {
+            Logger::Error("Cannot replace buttons: button #{} has an empty ID.", i);
+            return false;
+        }
+        if (!seen.emplace(buttons[i].id, i).second) {
+            Logger::Error("Cannot replace buttons: ID '{}' appears more than once.", buttons[i].id);
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    publishLocked(std::move(buttons), getSnapshot()->pages);
+    return true;
+}
+
+bool ConfigManager::replacePages(std::vector<PageConfig> pages)
+{
+    std::unordered_set<std::string_view> seen;
+    for (const auto& page : pages) {
+        if (!seen.insert(page.id).second) {
+            Logger::Error("Cannot replace pages: page ID '{}' appears more than once.", page.id);
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    publishLocked(getSnapshot()->buttons, std::move(pages));
+    return true;
+}
+
+std::shared_ptr<const LayoutSnapshot> ConfigManager::getLayoutSnapshot() const
+{
+    return getSnapshot()->layout;
+}
+
+uint64_t ConfigManager::getConfigVersion() const
+{
+    auto snapshot = getLayoutSnapshot();
+    return snapshot ? snapshot->version : 0;
+}
+
+size_t ConfigManager::addChangeListener(ConfigChangeListener listener)
+{
+    std::lock_guard<std::mutex> lock(m_listenersMutex);
+    size_t id = m_nextListenerId++;
+    m_changeListeners.emplace_back(id, std::move(listener));
+    return id;
+}
+
+void ConfigManager::removeChangeListener(size_t listenerId)
+{
+    std::lock_guard<std::mutex> lock(m_listenersMutex);
+    m_changeListeners.erase(std::remove_if(m_changeListeners.begin(), m_changeListeners.end(),
+                                           [listenerId](const auto& entry) { return entry.first == listenerId; }),
+                            m_changeListeners.end());
+}
+
+// Called by every writer with the complete new lists of buttons and pages. Builds the
+// whole next generation off to the side, then publishes it with a single atomic store.
+void ConfigManager::publishLocked(std::vector<ButtonConfig> buttons, std::vector<PageConfig> pages, bool warnOnDuplicates)
+{
+    auto previous = getSnapshot();
+
+    auto snapshot = std::make_shared<ConfigSnapshot>();
+    snapshot->generation = m_nextGeneration++;
+    snapshot->buttons = std::move(buttons);
+    snapshot->pages = std::move(pages);
+    snapshot->indexById.reserve(snapshot->buttons.size());
+    for (size_t i = 0; i < snapshot->buttons.size(); ++i) {
+        const auto& id = snapshot->buttons[i].id;
+        // Duplicate id in a loaded file: lookups keep finding the first one
+        if (!snapshot->indexById.try_emplace(id, static_cast<uint32_t>(i)).second && warnOnDuplicates) {
+            Logger::Warn("Duplicate button ID '{}' in configuration; only the first one can be pressed.", id);
+        }
     }
-    return false; // Button not found
-} 
\ No newline at end of file
+    buildDeck(*snapshot, warnOnDuplicates);
+    snapshot->layout = buildLayoutSnapshot(*snapshot, previous->layout);
+    bool layoutChanged = snapshot->layout != previous->layout;
+
+    std::shared_ptr<const ConfigSnapshot> published = std::move(snapshot);
+    m_snapshot.store(published, std::memory_order_release);
+
+    // Still under m_writeMutex, so listeners see layout versions strictly in order
+    if (layoutChanged) {
+        notifyListeners(published->layout);
+    }
+}
+
+void ConfigManager::notifyListeners(const std::shared_ptr<const LayoutSnapshot>& layout)
+{
+    std::vector<ConfigChangeListener> listeners;
+    {
+        std::lock_guard<std::mutex> lock(m_listenersMutex);
+        for (const auto& entry : m_changeListeners) listeners.push_back(entry.second);
+    }
+    for (const auto& listener : listeners) {
+        listener(layout);
+    }
+}
+
+const std::string& PageLayout::initialConfigMessage() const
+{
+    std::call_once(m_serializeOnce, [this]() { m_initialConfigMessage = serializeInitialConfig(pageId, version, layout); });
+    return m_initialConfigMessage;
+}
+
+// Connections only ever send the cached strings, so this is the one place the layout
+// gets serialized: the page list (deck), each page that changed as a delta against its
+// previous version (layout_update), and, lazily, pages in full (initial_config).
+std::shared_ptr<const LayoutSnapshot> ConfigManager::buildLayoutSnapshot(const ConfigSnapshot& config,
+                                                                         const std::shared_ptr<const LayoutSnapshot>& previous)
+{
+    auto snapshot = std::make_shared<LayoutSnapshot>();
+    snapshot->pages.reserve(config.deck.size());
+    snapshot->pageLayouts.reserve(config.deck.size());
+
+    // Pages whose web view is unchanged keep their PageLayout (and with it their version
+    // and any serialized message); only the others are rebuilt
+    std::vector<std::shared_ptr<PageLayout>> rebuilt;
+    std::vector<const PageLayout*> rebuiltPrevious;
+    for (const auto& contents : config.deck) {
+        snapshot->pages.push_back(contents.page);
+
+        std::vector<WebLayoutEntry> entries;
+        entries.reserve(contents.buttons.size());
+        for (uint32_t index : contents.buttons) {
+            const ButtonConfig& btn = config.buttons[index];
+            WebLayoutEntry& entry = entries.emplace_back();
+            entry.id = btn.id;
+            entry.name = btn.name;
+            entry.icon_path = toWebIconPath(btn.icon_path);
+            if (btn.action_type == OPEN_FOLDER_ACTION && config.findPage(btn.action_param)) {
+                entry.folder = btn.action_param;
+            }
+        }
+
+        const PageLayout* previousPage = previous ? previous->findPage(contents.page.id) : nullptr;
+        if (previousPage && previousPage->layout == entries) {
+            snapshot->pageLayouts.emplace(contents.page.id, previous->pageLayouts.find(contents.page.id)->second);
+            continue;
+        }
+        auto page = std::make_shared<PageLayout>();
+        page->pageId = contents.page.id;
+        page->layout = std::move(entries);
+        snapshot->pageLayouts.emplace(contents.page.id, page);
+        rebuilt.push_back(std::move(page));
+        rebuiltPrevious.push_back(previousPage);
+    }
+    if (previous) {
+        for (const auto& [pageId, page] : previous->pageLayouts) {
+            if (!snapshot->findPage(pageId)) snapshot->removedPages.push_back(pageId);
+        }
+    }
+    snapshot->deckChanged = !previous || previous->pages != snapshot->pages;
+
+    if (previous && rebuilt.empty() && snapshot->removedPages.empty() && !snapshot->deckChanged) {
+        return previous; // Nothing visible to web clients changed; keep the current version
+    }
+
+    // Every rebuilt page gets a version of its own, so a page version never matches
+    // another page's; the snapshot's version is the newest one handed out
+    if (snapshot->deckChanged) {
+        snapshot->deckVersion = m_nextVersion++;
+        snapshot->deckMessage = serializeDeck(snapshot->deckVersion, snapshot->pages);
+    } else {
+        snapshot->deckVersion = previous->deckVersion;
+        snapshot->deckMessage = previous->deckMessage;
+    }
+
+    for (size_t i = 0; i < rebuilt.size(); ++i) {
+        PageLayout& page = *rebuilt[i];
+        page.version = m_nextVersion++;
+        // A page that is new in this version has no delta; clients open it in full
+        if (const PageLayout* previousPage = rebuiltPrevious[i]) {
+            json delta = json::object();
+            buildLayoutDelta(previousPage->layout, page.layout, delta);
+            page.baseVersion = previousPage->version;
+            delta["page"] = page.pageId;
+            delta["version"] = page.version;
+            delta["base_version"] = page.baseVersion;
+            json updateMsg = {
+                {"type", "layout_update"},
+                {"payload", std::move(delta)}
+            };
+            page.layoutUpdateMessage = updateMsg.dump(-1, ' ', false, json::error_handler_t::replace);
+        }
+        snapshot->changedPages.push_back(std::move(rebuilt[i]));
+    }
+    snapshot->version = m_nextVersion - 1;
+    return snapshot;
+}
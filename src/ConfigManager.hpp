@@ -3,7 +3,17 @@
 #include <string>
 #include <vector>
 #include <optional> // Include for optional return type
+#include <memory>   // For shared snapshot ownership
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
+#include "Utils/HashUtils.hpp"
+#include "ConfigPersister.hpp" // Debounced, atomic background saves
+#include "ConfigBinaryCache.hpp" // Binary sidecar for fast startup
 
 // Define structure for a single button configuration
 struct ButtonConfig {
@@ -12,12 +22,145 @@ struct ButtonConfig {
     std::string action_type = ""; // e.g., "launch_app", "hotkey", "open_url"
     std::string action_param = ""; // e.g., "notepad.exe", "CTRL+ALT+T", "https://google.com"
     std::string icon_path = ""; // Optional path to an icon file
+    std::string page = ""; // Id of the page the button is on; empty for the root page
 
     // Add functions for JSON serialization/deserialization (using nlohmann/json)
     // Using NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT for robustness against missing fields
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(ButtonConfig, id, name, action_type, action_param, icon_path);
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(ButtonConfig, id, name, action_type, action_param, icon_path, page);
 };
 
+// Action type of buttons that open another page (action_param = page id). Handled by
+// whoever shows the button (web client, button grid), never by ActionExecutor.
+inline constexpr std::string_view OPEN_FOLDER_ACTION = "open_folder";
+
+// A page of buttons. Top-level pages are listed side by side; folders are not listed,
+// they are opened by an open_folder button and closed back to the page they were opened
+// from. The root page has the empty id and exists even if it isn't configured.
+struct PageConfig {
+    std::string id = "";
+    std::string name = "";
+    bool folder = false;
+
+    bool operator==(const PageConfig&) const = default;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(PageConfig, id, name, folder);
+};
+
+// A button as web clients see it: icon path already rewritten to a URL path
+struct WebLayoutEntry {
+    std::string id;
+    std::string name;
+    std::string icon_path;
+    std::string folder; // Page an open_folder button opens; empty for other buttons
+
+    bool operator==(const WebLayoutEntry&) const = default;
+};
+
+// Immutable, pre-serialized web layout of one page. Pages that did not change are
+// shared (same object, same version) between consecutive LayoutSnapshots.
+struct PageLayout {
+    std::string pageId;
+    // Layout version in which this page last changed. Versions are never shared between
+    // pages, so the version a client saw also identifies the page it saw.
+    uint64_t version = 0;
+    std::vector<WebLayoutEntry> layout;
+    // Ready-to-send {"type":"layout_update",...} frame holding only the added/removed/changed
+    // buttons relative to baseVersion. Empty for a page that is new in this version.
+    uint64_t baseVersion = 0;
+    std::string layoutUpdateMessage;
+
+    // Ready-to-send {"type":"initial_config",...} text frame for this page. Serialized the
+    // first time a client opens the page, so pages nobody views are never serialized.
+    const std::string& initialConfigMessage() const;
+
+private:
+    mutable std::once_flag m_serializeOnce;
+    mutable std::string m_initialConfigMessage;
+};
+
+// Immutable view of the layout for web clients, split into pages. Rebuilt once per
+// configuration change (reusing every page that didn't change), then shared by every
+// connection. Clients get the page list and only the page they are viewing.
+struct LayoutSnapshot {
+    uint64_t version = 0;                // Monotonically increasing: the newest page or deck version
+    // Every page clients can open, in display order, and the ready-to-send
+    // {"type":"deck",...} frame listing them
+    std::vector<PageConfig> pages;
+    uint64_t deckVersion = 0;            // Version in which the page list last changed
+    std::string deckMessage;
+    std::unordered_map<std::string, std::shared_ptr<const PageLayout>, HashUtils::StringHash, std::equal_to<>> pageLayouts;
+
+    // What this version changed relative to the previous snapshot, for publishing
+    bool deckChanged = false;
+    std::vector<std::shared_ptr<const PageLayout>> changedPages;
+    std::vector<std::string> removedPages;
+
+    const PageLayout* findPage(std::string_view pageId) const {
+        auto it = pageLayouts.find(pageId);
+        return it != pageLayouts.end() ? it->second.get() : nullptr;
+    }
+};
+
+// A page and the buttons on it, as positions in ConfigSnapshot::buttons
+struct PageContents {
+    PageConfig page;
+    std::vector<uint32_t> buttons;
+};
+
+// Immutable view of the whole configuration at one generation. ConfigManager swaps in
+// a new one on every change; readers on any thread hold on to the shared_ptr for as long
+// as they need a consistent set of buttons, without taking a lock.
+struct ConfigSnapshot {
+    uint64_t generation = 0;             // Bumped on every change, including ones web clients can't see
+    std::vector<ButtonConfig> buttons;
+    std::vector<PageConfig> pages;       // As configured; saved back unchanged
+    // id -> position in buttons (ids are interned here; presses are queued as positions)
+    std::unordered_map<std::string, uint32_t, HashUtils::StringHash, std::equal_to<>> indexById;
+    // Every page that can be shown, in display order: the root page, the configured
+    // pages, then pages only named by buttons
+    std::vector<PageContents> deck;
+    std::unordered_map<std::string, uint32_t, HashUtils::StringHash, std::equal_to<>> deckIndexById;
+    // Web view; shared with the previous generation if nothing visible changed
+    std::shared_ptr<const LayoutSnapshot> layout;
+
+    // O(1), no copy. Valid for as long as the snapshot is held.
+    const ButtonConfig* find(std::string_view id) const {
+        auto it = indexById.find(id);
+        return it != indexById.end() ? &buttons[it->second] : nullptr;
+    }
+    std::optional<uint32_t> indexOf(std::string_view id) const {
+        auto it = indexById.find(id);
+        if (it == indexById.end()) return std::nullopt;
+        return it->second;
+    }
+    const PageContents* findPage(std::string_view pageId) const {
+        auto it = deckIndexById.find(pageId);
+        return it != deckIndexById.end() ? &deck[it->second] : nullptr;
+    }
+};
+
+// What an external edit of the configuration file changed, by button id
+struct ConfigDiff {
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    std::vector<std::string> changed;   // Same id, any field different
+    bool reordered = false;             // Surviving buttons are in a different order
+    bool pagesChanged = false;          // The configured page list differs
+    // Icons whose cached copies are stale: those of removed buttons, plus the old and the
+    // new icon of every added button or button whose icon changed. As configured (for
+    // textures) and as the URL path the HTTP asset cache knows them by.
+    std::vector<std::string> staleIconPaths;
+    std::vector<std::string> staleIconUrls;
+
+    bool empty() const { return added.empty() && removed.empty() && changed.empty() && !reordered && !pagesChanged; }
+};
+
+// Invoked on the thread that changed the configuration, after the new snapshot is
+// published, in version order. Must not modify the configuration itself.
+using ConfigChangeListener = std::function<void(const std::shared_ptr<const LayoutSnapshot>&)>;
+
+// Owns the button configuration. Reads go through getSnapshot() and are safe from any
+// thread; modifications are serialized with each other and publish a new snapshot.
 class ConfigManager
 {
 public:
@@ -26,24 +169,81 @@ public:
     // Load configuration from the specified file
     bool loadConfig();
 
-    // Save current configuration to the specified file
-    bool saveConfig();
+    // Re-read the configuration file after it was edited externally and apply what
+    // changed. Returns nullopt if the file is unreadable, invalid (the current
+    // configuration is kept), identical to what we last saved, or has no button or page changes.
+    // Listeners are notified as for any other change; web clients get a layout delta.
+    std::optional<ConfigDiff> reloadFromDisk();
+
+    const std::string& getConfigFilePath() const { return m_configFilePath; }
 
-    // Get all button configurations
-    const std::vector<ButtonConfig>& getButtons() const;
+    // Schedule the current configuration to be saved. Returns immediately; bursts of
+    // edits are coalesced into one write on a background thread (see ConfigPersister).
+    // A failed write is logged and reported by getSaveStats().
+    void scheduleSave();
+    // Write any scheduled save now and wait for it (e.g. before exiting).
+    // Returns false if the write failed.
+    bool flushPendingSave();
+    ConfigPersister::Stats getSaveStats() const;
 
-    // Get a specific button configuration by ID
+    // Current configuration. Never null.
+    std::shared_ptr<const ConfigSnapshot> getSnapshot() const;
+
+    // Get a specific button configuration by ID (a copy; prefer getSnapshot()->find)
     std::optional<ButtonConfig> getButtonById(const std::string& id) const;
 
+    // Generation of the current snapshot
+    uint64_t getGeneration() const;
+
     // --- Methods to modify configuration (needed later by UI) ---
     bool addButton(const ButtonConfig& button);
     bool updateButton(const std::string& id, const ButtonConfig& button);
     bool removeButton(const std::string& id);
+    // Replace every button at once (one snapshot rebuild instead of one per button).
+    // Fails without changing anything if an id is empty or duplicated.
+    bool replaceButtons(std::vector<ButtonConfig> buttons);
+    // Replace the configured page list. Fails without changing anything if a page id is
+    // duplicated.
+    bool replacePages(std::vector<PageConfig> pages);
+
+    // Current web layout snapshot. Safe to call from any thread; the returned
+    // snapshot stays valid (and unchanged) for as long as the caller holds it.
+    std::shared_ptr<const LayoutSnapshot> getLayoutSnapshot() const;
+
+    // Version of the current snapshot
+    uint64_t getConfigVersion() const;
+
+    // Register for snapshot changes. Returns an id for removeChangeListener.
+    size_t addChangeListener(ConfigChangeListener listener);
+    void removeChangeListener(size_t listenerId);
 
 private:
-    std::vector<ButtonConfig> m_buttons;
     std::string m_configFilePath;
 
+    std::atomic<std::shared_ptr<const ConfigSnapshot>> m_snapshot;
+    // Serializes writers: each one copies the current buttons, edits the copy and
+    // publishes it. Readers never take it.
+    mutable std::mutex m_writeMutex;
+    uint64_t m_nextGeneration = 1;       // Guarded by m_writeMutex
+    uint64_t m_nextVersion = 1;          // Guarded by m_writeMutex
+
+    // Declared before m_persister: the persister thread refreshes it after every save
+    ConfigBinaryCache m_binaryCache;
+    std::unique_ptr<ConfigPersister> m_persister;
+
+    std::mutex m_listenersMutex;
+    std::vector<std::pair<size_t, ConfigChangeListener>> m_changeListeners;
+    size_t m_nextListenerId = 1;
+
+    // Builds the next snapshot from `buttons` and `pages` (indexes, deck, web layout),
+    // swaps it in and notifies listeners if the web layout changed. Call with m_writeMutex held.
+    void publishLocked(std::vector<ButtonConfig> buttons, std::vector<PageConfig> pages, bool warnOnDuplicates = false);
+    // Rebuilds the web layout of the pages that differ from `previous`; returns `previous`
+    // if nothing visible changed
+    std::shared_ptr<const LayoutSnapshot> buildLayoutSnapshot(const ConfigSnapshot& config,
+                                                              const std::shared_ptr<const LayoutSnapshot>& previous);
+    void notifyListeners(const std::shared_ptr<const LayoutSnapshot>& layout);
+
     // Optional: Helper to load default config if file doesn't exist or is invalid
     void loadDefaultConfig(); 
 }; 
\ No newline at end of file
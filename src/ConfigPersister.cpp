@@ -0,0 +1,150 @@
+#include "ConfigPersister.hpp"
+#include "ConfigManager.hpp"
+#include "Utils/FileUtils.hpp"
+#include "Utils/HashUtils.hpp"
+#include "Utils/Logger.hpp"
+#include <algorithm>
+
+ConfigPersister::ConfigPersister(std::filesystem::path path, Serializer serializer,
+                                 std::chrono::milliseconds debounce, std::chrono::milliseconds maxDelay)
+    : m_path(std::move(path)), m_serializer(std::move(serializer)), m_debounce(debounce), m_maxDelay(maxDelay)
+{
+    m_thread = std::thread(&ConfigPersister::run, this);
+}
+
+ConfigPersister::~ConfigPersister()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void ConfigPersister::save(std::shared_ptr<const ConfigSnapshot> snapshot)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = Clock::now();
+        if (!m_pending) m_firstRequest = now;
+        m_lastRequest = now;
+        m_pending = std::move(snapshot); // Only the newest one matters
+        ++m_stats.requests;
+    }
+    m_condition.notify_one();
+}
+
+bool ConfigPersister::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_pending) {
+        m_flushRequested = true;
+        m_condition.notify_one();
+    }
+    m_idleCondition.wait(lock, [this] { return !m_pending && !m_writing; });
+    return m_lastWriteOk;
+}
+
+void ConfigPersister::setBaseline(uint64_t contentHash)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastHash = contentHash;
+    m_hasBaseline = true;
+}
+
+bool ConfigPersister::matchesBaseline(uint64_t contentHash) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (m_hasBaseline && contentHash == m_lastHash) || (m_writing && contentHash == m_inFlightHash);
+}
+
+void ConfigPersister::discardPending()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_pending) return;
+        m_pending.reset();
+        m_flushRequested = false;
+    }
+    m_idleCondition.notify_all();
+}
+
+ConfigPersister::Stats ConfigPersister::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void ConfigPersister::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_condition.wait(lock, [this] { return m_stopping || m_pending; });
+        if (!m_pending) break; // Stopping with nothing left to write
+
+        // Debounce: wait for a quiet period, bounded by maxDelay after the first request
+        while (!m_flushRequested && !m_stopping) {
+            auto deadline = std::min(m_lastRequest + m_debounce, m_firstRequest + m_maxDelay);
+            if (Clock::now() >= deadline) break;
+            m_condition.wait_until(lock, deadline);
+        }
+        if (!m_pending) continue; // Discarded while we were waiting
+
+        std::shared_ptr<const ConfigSnapshot> snapshot = std::move(m_pending);
+        m_pending.reset();
+        m_flushRequested = false;
+        m_writing = true;
+
+        lock.unlock();
+        bool ok = write(*snapshot);
+        lock.lock();
+
+        m_writing = false;
+        m_lastWriteOk = ok;
+        m_idleCondition.notify_all();
+    }
+}
+
+bool ConfigPersister::write(const ConfigSnapshot& snapshot)
+{
+    auto start = Clock::now();
+    std::string content = m_serializer(snapshot);
+    uint64_t hash = HashUtils::XxHash64(content);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_hasBaseline && hash == m_lastHash) {
+            ++m_stats.skippedUnchanged;
+            Logger::Debug("[Config] {} is already up to date, skipping write.", m_path);
+            return true;
+        }
+        // The rename may be seen by a file watcher before we record the new hash below
+        m_inFlightHash = hash;
+    }
+
+    std::string error;
+    bool ok = FileUtils::WriteFileAtomically(m_path, content, error);
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!ok) {
+        ++m_stats.failures;
+        m_stats.lastError = error;
+        Logger::Error("[Config] Could not save configuration to {}: {}", m_path, error);
+        return false;
+    }
+    m_lastHash = hash;
+    m_hasBaseline = true;
+    ++m_stats.writes;
+    m_stats.lastError.clear();
+    m_stats.bytesWritten += content.size();
+    m_stats.lastBytes = content.size();
+    m_stats.lastLatency = latency;
+    m_stats.maxLatency = std::max(m_stats.maxLatency, latency);
+    Logger::Info("[Config] Saved {} ({} bytes in {} us, generation {})", m_path, content.size(),
+                 static_cast<int64_t>(latency.count()), snapshot.generation);
+    lock.unlock();
+
+    if (m_onWritten) m_onWritten(snapshot, content, hash);
+    return true;
+}
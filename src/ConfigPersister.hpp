@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+struct ConfigSnapshot;
+
+// Writes configuration snapshots to disk on a background thread.
+// Saves requested in quick succession are coalesced: the thread waits until no new
+// request arrived for `debounce` (but never longer than `maxDelay` after the first one)
+// and writes only the newest snapshot. The file is replaced atomically (temp file,
+// fsync, rename), and the write is skipped when the serialized content is identical
+// to what is already on disk.
+class ConfigPersister {
+public:
+    struct Stats {
+        uint64_t requests = 0;        // save() calls
+        uint64_t writes = 0;          // Files actually written
+        uint64_t skippedUnchanged = 0;
+        uint64_t failures = 0;
+        uint64_t bytesWritten = 0;    // Total over all writes
+        uint64_t lastBytes = 0;
+        std::chrono::microseconds lastLatency{0};   // Serialize + write + fsync + rename
+        std::chrono::microseconds maxLatency{0};
+        std::string lastError;        // Why the latest write failed; empty once one succeeds
+    };
+
+    // Turns a snapshot into the file contents (pretty-printed JSON for config.json)
+    using Serializer = std::function<std::string(const ConfigSnapshot&)>;
+    // Called on the writer thread after `content` (hashing to `contentHash`) replaced the file
+    using WrittenCallback = std::function<void(const ConfigSnapshot&, std::string_view content, uint64_t contentHash)>;
+
+    ConfigPersister(std::filesystem::path path, Serializer serializer,
+                    std::chrono::milliseconds debounce = std::chrono::milliseconds(300),
+                    std::chrono::milliseconds maxDelay = std::chrono::milliseconds(2000));
+    ~ConfigPersister(); // Writes anything still pending
+
+    ConfigPersister(const ConfigPersister&) = delete;
+    ConfigPersister& operator=(const ConfigPersister&) = delete;
+
+    // Schedule `snapshot` to be written. Never blocks on I/O.
+    void save(std::shared_ptr<const ConfigSnapshot> snapshot);
+    // Write the pending snapshot now (if any) and wait for it. Returns false if that write failed.
+    bool flush();
+
+    // Hash (HashUtils::XxHash64) of the content currently on disk, e.g. right after
+    // loading it, so an unchanged configuration is not rewritten
+    void setBaseline(uint64_t contentHash);
+    // True if content hashing to `contentHash` is what this persister last wrote (or is
+    // writing right now), so a file watcher can tell our own saves apart from external edits
+    bool matchesBaseline(uint64_t contentHash) const;
+    // Drop a scheduled save that has not started yet, e.g. because the file was edited
+    // externally and reloaded; writing the older in-memory state would undo that edit
+    void discardPending();
+
+    // Set before the first save()
+    void setWrittenCallback(WrittenCallback callback) { m_onWritten = std::move(callback); }
+
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::filesystem::path m_path;
+    Serializer m_serializer;
+    WrittenCallback m_onWritten;
+    std::chrono::milliseconds m_debounce;
+    std::chrono::milliseconds m_maxDelay;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;     // Wakes the writer thread
+    std::condition_variable m_idleCondition; // Signals flush() callers
+    std::shared_ptr<const ConfigSnapshot> m_pending;
+    Clock::time_point m_firstRequest;
+    Clock::time_point m_lastRequest;
+    bool m_flushRequested = false;
+    bool m_writing = false;
+    bool m_lastWriteOk = true;
+    bool m_stopping = false;
+    uint64_t m_lastHash = 0;
+    bool m_hasBaseline = false;
+    uint64_t m_inFlightHash = 0;             // Content being written while m_writing
+    Stats m_stats;
+    std::thread m_thread;
+
+    void run();
+    // Serializes and writes one snapshot; called without m_mutex held
+    bool write(const ConfigSnapshot& snapshot);
+};
@@ -0,0 +1,209 @@
+#include "ConfigWatcher.hpp"
+#include "Utils/Logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <system_error>
+#include <tuple>
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    // What the polling fallback compares between checks
+    struct FileSignature {
+        bool exists = false;
+        fs::file_time_type modified{};
+        uintmax_t size = 0;
+
+        bool operator==(const FileSignature& other) const {
+            return std::tie(exists, modified, size) == std::tie(other.exists, other.modified, other.size);
+        }
+    };
+
+    FileSignature readSignature(const fs::path& path) {
+        FileSignature signature;
+        std::error_code ec;
+        signature.modified = fs::last_write_time(path, ec);
+        if (ec) return signature;
+        signature.size = fs::file_size(path, ec);
+        if (ec) return signature;
+        signature.exists = true;
+        return signature;
+    }
+} // namespace
+
+ConfigWatcher::ConfigWatcher(fs::path path, ChangeCallback onChange,
+                             std::chrono::milliseconds debounce, std::chrono::milliseconds pollInterval)
+    : m_path(std::move(path)), m_onChange(std::move(onChange)), m_debounce(debounce), m_pollInterval(pollInterval)
+{
+}
+
+ConfigWatcher::~ConfigWatcher()
+{
+    stop();
+}
+
+void ConfigWatcher::start()
+{
+    if (m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_stopRequested = false;
+    }
+#ifdef __linux__
+    m_usingInotify.store(openInotify(), std::memory_order_relaxed);
+#endif
+    Logger::Info("[ConfigWatcher] Watching {} ({})", m_path, usingInotify() ? "inotify" : "polling");
+    m_thread = std::thread(&ConfigWatcher::run, this);
+}
+
+void ConfigWatcher::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_stopRequested = true;
+    }
+    m_stopCondition.notify_all();
+#ifdef __linux__
+    if (m_stopEventFd >= 0) {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t ignored = ::write(m_stopEventFd, &one, sizeof(one));
+    }
+#endif
+    if (m_thread.joinable()) m_thread.join();
+#ifdef __linux__
+    closeInotify();
+#endif
+    m_usingInotify.store(false, std::memory_order_relaxed);
+}
+
+void ConfigWatcher::run()
+{
+#ifdef __linux__
+    if (usingInotify()) {
+        runInotify();
+        return;
+    }
+#endif
+    runPolling();
+}
+
+#ifdef __linux__
+
+bool ConfigWatcher::openInotify()
+{
+    m_inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        Logger::Warn("[ConfigWatcher] inotify_init1 failed: {}. Falling back to polling.", std::strerror(errno));
+        return false;
+    }
+    // Watch the directory, not the file: an atomic save replaces the inode we would be watching
+    fs::path directory = m_path.has_parent_path() ? m_path.parent_path() : fs::path(".");
+    if (::inotify_add_watch(m_inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        Logger::Warn("[ConfigWatcher] Cannot watch {}: {}. Falling back to polling.", directory, std::strerror(errno));
+        closeInotify();
+        return false;
+    }
+    m_stopEventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_stopEventFd < 0) {
+        Logger::Warn("[ConfigWatcher] eventfd failed: {}. Falling back to polling.", std::strerror(errno));
+        closeInotify();
+        return false;
+    }
+    return true;
+}
+
+void ConfigWatcher::closeInotify()
+{
+    if (m_inotifyFd >= 0) ::close(m_inotifyFd);
+    if (m_stopEventFd >= 0) ::close(m_stopEventFd);
+    m_inotifyFd = -1;
+    m_stopEventFd = -1;
+}
+
+void ConfigWatcher::runInotify()
+{
+    const std::string fileName = m_path.filename().string();
+    alignas(inotify_event) char buffer[4096];
+    std::optional<Clock::time_point> deadline; // Set while a change waits out the debounce
+
+    pollfd fds[2] = {{m_inotifyFd, POLLIN, 0}, {m_stopEventFd, POLLIN, 0}};
+    while (true) {
+        int timeoutMs = -1;
+        if (deadline) {
+            auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*deadline - Clock::now());
+            timeoutMs = static_cast<int>(std::max<int64_t>(0, remaining.count()));
+        }
+        int ready = ::poll(fds, 2, timeoutMs);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            Logger::Error("[ConfigWatcher] poll failed: {}. Falling back to polling.", std::strerror(errno));
+            m_usingInotify.store(false, std::memory_order_relaxed);
+            runPolling();
+            return;
+        }
+        if (fds[1].revents & POLLIN) break; // stop()
+
+        if (fds[0].revents & POLLIN) {
+            bool relevant = false;
+            bool watchLost = false;
+            while (true) {
+                ssize_t length = ::read(m_inotifyFd, buffer, sizeof(buffer));
+                if (length <= 0) break; // EAGAIN: drained
+                for (char* cursor = buffer; cursor < buffer + length;) {
+                    auto* event = reinterpret_cast<inotify_event*>(cursor);
+                    if (event->mask & IN_Q_OVERFLOW) relevant = true; // Lost events; assume the worst
+                    if (event->mask & IN_IGNORED) watchLost = true;   // Directory went away
+                    if (event->len > 0 && fileName == event->name) relevant = true;
+                    cursor += sizeof(inotify_event) + event->len;
+                }
+            }
+            if (watchLost) {
+                Logger::Warn("[ConfigWatcher] Lost the inotify watch on {}. Falling back to polling.", m_path);
+                m_usingInotify.store(false, std::memory_order_relaxed);
+                runPolling();
+                return;
+            }
+            if (relevant) deadline = Clock::now() + m_debounce;
+        }
+
+        if (deadline && Clock::now() >= *deadline) {
+            deadline.reset();
+            m_onChange();
+        }
+    }
+}
+
+#endif
+
+void ConfigWatcher::runPolling()
+{
+    FileSignature last = readSignature(m_path);
+    bool pending = false; // Changed at the last check; fire once it holds still
+
+    std::unique_lock<std::mutex> lock(m_stopMutex);
+    while (true) {
+        auto wait = pending ? m_debounce : m_pollInterval;
+        if (m_stopCondition.wait_for(lock, wait, [this] { return m_stopRequested; })) break;
+        lock.unlock();
+
+        FileSignature current = readSignature(m_path);
+        if (!(current == last)) {
+            last = current;
+            pending = true;
+        } else if (pending) {
+            pending = false;
+            m_onChange();
+        }
+
+        lock.lock();
+    }
+}
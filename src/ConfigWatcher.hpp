@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Watches one file (config.json) and calls back on its own thread once the file has
+// changed and then stayed quiet for `debounce`, so editors and scripts that write in
+// several steps cause one reload. Uses inotify on Linux, watching the parent directory
+// so atomic replace-by-rename is seen too; elsewhere, or if inotify is unavailable, it
+// polls the file's modification time and size every `pollInterval`.
+class ConfigWatcher {
+public:
+    using ChangeCallback = std::function<void()>;
+
+    ConfigWatcher(std::filesystem::path path, ChangeCallback onChange,
+                  std::chrono::milliseconds debounce = std::chrono::milliseconds(100),
+                  std::chrono::milliseconds pollInterval = std::chrono::milliseconds(1000));
+    ~ConfigWatcher(); // Calls stop()
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    void start();
+    // Waits for a callback that is already running to return
+    void stop();
+
+    // False until start() has picked a mechanism, and when it fell back to polling
+    bool usingInotify() const { return m_usingInotify.load(std::memory_order_relaxed); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::filesystem::path m_path;
+    ChangeCallback m_onChange;
+    std::chrono::milliseconds m_debounce;
+    std::chrono::milliseconds m_pollInterval;
+
+    std::thread m_thread;
+    std::atomic<bool> m_usingInotify{false};
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCondition; // Wakes the polling loop
+    bool m_stopRequested = false;            // Guarded by m_stopMutex
+#ifdef __linux__
+    int m_inotifyFd = -1;
+    int m_stopEventFd = -1;                  // Wakes the inotify loop
+#endif
+
+    void run();
+#ifdef __linux__
+    bool openInotify();
+    void closeInotify();
+    void runInotify();
+#endif
+    void runPolling();
+};
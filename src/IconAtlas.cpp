@@ -0,0 +1,261 @@
+#include "IconAtlas.hpp"
+#include "Utils/ImageResampler.hpp"
+#include "Utils/Logger.hpp"
+#include <algorithm>
+#include <utility> // For std::exchange
+
+namespace {
+    // Copies the image into the middle of an image `padding` pixels larger on every side,
+    // repeating the edge pixels outwards
+    std::vector<unsigned char> addPadding(const std::vector<unsigned char>& src, int width, int height, int padding) {
+        int paddedWidth = width + 2 * padding;
+        int paddedHeight = height + 2 * padding;
+        std::vector<unsigned char> dst(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+        for (int y = 0; y < paddedHeight; ++y) {
+            int sy = std::clamp(y - padding, 0, height - 1);
+            for (int x = 0; x < paddedWidth; ++x) {
+                int sx = std::clamp(x - padding, 0, width - 1);
+                std::copy_n(&src[(static_cast<size_t>(sy) * width + sx) * 4], 4,
+                            &dst[(static_cast<size_t>(y) * paddedWidth + x) * 4]);
+            }
+        }
+        return dst;
+    }
+} // namespace
+
+IconAtlas::~IconAtlas() {
+    clear();
+}
+
+void IconAtlas::clear() {
+    for (auto& page : m_pages) {
+        if (page.textureId != 0) glDeleteTextures(1, &page.textureId);
+    }
+    m_pages.clear();
+    m_entries.clear();
+    m_movedIcons.clear();
+}
+
+int IconAtlas::clampDisplaySize(int displaySize) {
+    return std::clamp(displaySize, 1, PAGE_SIZE - 2 * PADDING);
+}
+
+IconAtlas::PreparedIcon IconAtlas::prepare(const std::vector<unsigned char>& rgba, int width, int height,
+                                           int displaySize) {
+    PreparedIcon icon;
+    icon.displaySize = clampDisplaySize(displaySize);
+    if (width <= 0 || height <= 0 || rgba.size() < static_cast<size_t>(width) * height * 4) return icon;
+    int scaledWidth = std::min(width, icon.displaySize);
+    int scaledHeight = std::min(height, icon.displaySize);
+    std::vector<unsigned char> scaled = ImageResampler::resize(rgba, width, height, scaledWidth, scaledHeight);
+    icon.pixels = addPadding(scaled, scaledWidth, scaledHeight, PADDING);
+    icon.width = scaledWidth + 2 * PADDING;
+    icon.height = scaledHeight + 2 * PADDING;
+    return icon;
+}
+
+const AtlasIcon* IconAtlas::find(const std::string& path) const {
+    auto it = m_entries.find(path);
+    return it != m_entries.end() ? &it->second.icon : nullptr;
+}
+
+const AtlasIcon& IconAtlas::add(const std::string& path, PreparedIcon icon) {
+    release(path); // E.g. shown at another size now (the window moved to another monitor)
+
+    Entry& entry = m_entries[path];
+    entry.icon.displaySize = icon.displaySize;
+    if (icon.pixels.empty()) {
+        return entry.icon; // Remembered as failed
+    }
+    entry.pixels = std::move(icon.pixels);
+    entry.rect.width = icon.width;
+    entry.rect.height = icon.height;
+    place(entry);
+    Logger::Debug("[IconAtlas] Packed {} ({}x{}) on page {}", path, icon.width - 2 * PADDING,
+                  icon.height - 2 * PADDING, entry.page);
+    return entry.icon;
+}
+
+void IconAtlas::release(const std::string& path) {
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) return;
+    removeFromPage(it->second.page, it->second.rect);
+    m_entries.erase(it);
+}
+
+void IconAtlas::removeFromPage(int pageIndex, const PackedRect& rect) {
+    if (pageIndex < 0) return;
+    Page& page = m_pages[pageIndex];
+    page.packer.release(rect);
+    if (--page.icons == 0) {
+        glDeleteTextures(1, &page.textureId);
+        page.textureId = 0;
+        page.packer.clear();
+        Logger::Debug("[IconAtlas] Page {} is empty; deleted its texture", pageIndex);
+    }
+}
+
+size_t IconAtlas::compact() {
+    std::vector<size_t> order; // Live pages, emptiest first
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        if (m_pages[i].textureId != 0) order.push_back(i);
+    }
+    if (order.size() < 2) return 0;
+    std::vector<double> occupancy(m_pages.size());
+    for (size_t i : order) occupancy[i] = m_pages[i].packer.stats().occupancy;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return occupancy[a] < occupancy[b]; });
+
+    size_t deleted = 0;
+    for (size_t n = 0; n + 1 < order.size() && occupancy[order[n]] < COMPACT_OCCUPANCY; ++n) {
+        size_t source = order[n];
+        std::vector<std::pair<const std::string*, Entry*>> entries;
+        for (auto& [path, entry] : m_entries) {
+            if (entry.page == static_cast<int>(source)) entries.emplace_back(&path, &entry);
+        }
+        // Fullest first, so the pages that are emptied next are not filled up again
+        std::vector<size_t> targets;
+        for (size_t m = order.size() - 1; m > n; --m) {
+            if (m_pages[order[m]].textureId != 0) targets.push_back(order[m]);
+        }
+
+        // Only worth the uploads if the whole page empties: try it on copies first. The
+        // packers are deterministic, so the real inserts below land in the same places.
+        std::vector<SkylinePacker> trial;
+        for (size_t target : targets) trial.push_back(m_pages[target].packer);
+        bool fits = std::all_of(entries.begin(), entries.end(), [&](const auto& item) {
+            return std::any_of(trial.begin(), trial.end(), [&](SkylinePacker& packer) {
+                return packer.insert(item.second->rect.width, item.second->rect.height).has_value();
+            });
+        });
+        if (!fits) continue;
+
+        for (auto [path, entry] : entries) {
+            PackedRect oldRect = entry->rect; // tryPlaceOnPage() overwrites the position
+            for (size_t target : targets) {
+                if (tryPlaceOnPage(*entry, target)) break;
+            }
+            removeFromPage(static_cast<int>(source), oldRect);
+            m_movedIcons.push_back(*path);
+        }
+        ++deleted;
+    }
+    if (deleted > 0) Logger::Debug("[IconAtlas] Compacted the atlas; {} pages deleted", deleted);
+    return deleted;
+}
+
+std::vector<std::string> IconAtlas::takeMovedIcons() {
+    return std::exchange(m_movedIcons, {});
+}
+
+void IconAtlas::place(Entry& entry) {
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        if (tryPlaceOnPage(entry, i)) return;
+    }
+
+    // Space freed by released icons is only reusable by icons that fit in it; repack the
+    // pages where that space adds up
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        if (m_pages[i].textureId == 0 || !m_pages[i].packer.shouldRepack()) continue;
+        repackPage(i);
+        if (tryPlaceOnPage(entry, i)) return;
+    }
+
+    size_t pageIndex = addPage();
+    if (!tryPlaceOnPage(entry, pageIndex)) {
+        // get() clamps icons to the page size, so an empty page always has room
+        Logger::Error("[IconAtlas] Icon of {}x{} does not fit on an empty page", entry.rect.width, entry.rect.height);
+    }
+}
+
+bool IconAtlas::tryPlaceOnPage(Entry& entry, size_t pageIndex) {
+    Page& page = m_pages[pageIndex];
+    if (page.textureId == 0) return false;
+    auto rect = page.packer.insert(entry.rect.width, entry.rect.height);
+    if (!rect) return false;
+
+    entry.page = static_cast<int>(pageIndex);
+    entry.rect = *rect;
+    entry.icon.textureId = page.textureId;
+    constexpr float SCALE = 1.0f / PAGE_SIZE;
+    entry.icon.uv0 = ImVec2((rect->x + PADDING) * SCALE, (rect->y + PADDING) * SCALE);
+    entry.icon.uv1 = ImVec2((rect->x + rect->width - PADDING) * SCALE, (rect->y + rect->height - PADDING) * SCALE);
+    ++page.icons;
+    upload(entry);
+    return true;
+}
+
+void IconAtlas::repackPage(size_t pageIndex) {
+    std::vector<std::pair<const std::string*, Entry*>> entries; // Paths for the icons that end up elsewhere
+    for (auto& [path, entry] : m_entries) {
+        if (entry.page == static_cast<int>(pageIndex)) entries.emplace_back(&path, &entry);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const auto& a, const auto& b) { return SkylinePacker::repackOrder(a.second->rect, b.second->rect); });
+
+    Page& page = m_pages[pageIndex];
+    double fragmentationBefore = page.packer.stats().fragmentation;
+    page.packer.clear();
+    page.icons = 0;
+    std::vector<std::pair<const std::string*, Entry*>> displaced;
+    for (const auto& item : entries) {
+        if (!tryPlaceOnPage(*item.second, pageIndex)) displaced.push_back(item);
+    }
+    ++m_repacks;
+    Logger::Debug("[IconAtlas] Repacked page {} ({} icons): fragmentation {} -> {}", pageIndex, entries.size(),
+                  fragmentationBefore, m_pages[pageIndex].packer.stats().fragmentation);
+
+    // Sorting changes the layout, so in rare cases not everything fits back
+    for (auto [path, entry] : displaced) {
+        entry->page = -1;
+        for (size_t i = 0; i < m_pages.size() && entry->page < 0; ++i) {
+            if (i != pageIndex) tryPlaceOnPage(*entry, i);
+        }
+        if (entry->page < 0) tryPlaceOnPage(*entry, addPage());
+        m_movedIcons.push_back(*path);
+    }
+}
+
+size_t IconAtlas::addPage() {
+    auto unused = std::find_if(m_pages.begin(), m_pages.end(), [](const Page& page) { return page.textureId == 0; });
+    size_t index = unused - m_pages.begin();
+    if (unused == m_pages.end()) m_pages.emplace_back();
+    Page& page = m_pages[index];
+
+    glGenTextures(1, &page.textureId);
+    glBindTexture(GL_TEXTURE_2D, page.textureId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, PAGE_SIZE, PAGE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    Logger::Debug("[IconAtlas] Added page {} (texture {}, {}x{})", index, page.textureId, PAGE_SIZE, PAGE_SIZE);
+    return index;
+}
+
+void IconAtlas::upload(const Entry& entry) {
+    glBindTexture(GL_TEXTURE_2D, m_pages[entry.page].textureId);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, entry.rect.x, entry.rect.y, entry.rect.width, entry.rect.height, GL_RGBA,
+                    GL_UNSIGNED_BYTE, entry.pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+IconAtlas::Stats IconAtlas::stats() const {
+    Stats stats;
+    for (const auto& page : m_pages) {
+        if (page.textureId == 0) continue;
+        SkylinePacker::Stats pageStats = page.packer.stats();
+        ++stats.pages;
+        stats.icons += page.icons;
+        stats.occupancy += pageStats.occupancy;
+        stats.fragmentation += pageStats.fragmentation;
+    }
+    stats.bytes = stats.pages * PAGE_BYTES;
+    if (stats.pages > 0) {
+        stats.occupancy /= stats.pages;
+        stats.fragmentation /= stats.pages;
+    }
+    stats.repacks = m_repacks;
+    return stats;
+}
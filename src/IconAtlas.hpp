@@ -0,0 +1,113 @@
+#pragma once
+
+#include <imgui.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <GL/glew.h> // For GLuint
+#include "Utils/SkylinePacker.hpp"
+
+// Where a button icon is in the atlas. textureId 0 means the icon could not be loaded.
+struct AtlasIcon {
+    GLuint textureId = 0;
+    ImVec2 uv0;
+    ImVec2 uv1;
+    int displaySize = 0; // The size it was prepared for
+};
+
+// Static button icons packed into a few large textures ("pages"), so the button grid
+// draws all its icons from one texture instead of binding one texture per button.
+// Icons are downscaled to the size they are displayed at before packing; each page is
+// packed with a SkylinePacker.
+//
+// When icons change, only the affected rectangles are touched: a released icon's space
+// is reused by the next icon that fits in it, a page whose free space is too fragmented
+// is repacked from the CPU copies of its icons when something new doesn't fit, and a
+// page with no icons left is deleted. compact() moves the icons of sparse pages onto
+// the others so that those pages can be deleted too.
+// prepare() can run on any thread; everything else must run on the thread that owns
+// the GL context.
+class IconAtlas {
+public:
+    static constexpr int PAGE_SIZE = 1024;
+    static constexpr int PADDING = 1; // Edge pixels repeated around each icon so linear filtering doesn't bleed
+    static constexpr size_t PAGE_BYTES = size_t(PAGE_SIZE) * PAGE_SIZE * 4; // RGBA8, allocated in full
+    // compact() empties pages whose icons cover less than this share of them
+    static constexpr double COMPACT_OCCUPANCY = 0.5;
+
+    struct Stats {
+        size_t pages = 0;
+        size_t icons = 0;
+        double occupancy = 0.0;     // Average over the pages
+        double fragmentation = 0.0; // Average over the pages
+        size_t repacks = 0;         // Since construction
+        size_t bytes = 0;           // Texture memory of the pages
+    };
+
+    // An icon scaled and padded for packing, made by prepare()
+    struct PreparedIcon {
+        int displaySize = 0;
+        int width = 0;  // Including the padding
+        int height = 0;
+        std::vector<unsigned char> pixels; // RGBA; empty if the image could not be loaded
+
+        size_t bytes() const { return pixels.size(); }
+    };
+
+    // Largest display size an icon can be prepared for
+    static int clampDisplaySize(int displaySize);
+    // Downscales decoded RGBA pixels to at most displaySize x displaySize (Lanczos, so the
+    // icon is drawn 1:1 and needs no mipmaps) and adds the padding. No GL calls; safe on any thread.
+    static PreparedIcon prepare(const std::vector<unsigned char>& rgba, int width, int height, int displaySize);
+
+    IconAtlas() = default;
+    IconAtlas(const IconAtlas&) = delete;
+    IconAtlas& operator=(const IconAtlas&) = delete;
+    ~IconAtlas();
+
+    // The icon added for `path` (at whatever size), or nullptr
+    const AtlasIcon* find(const std::string& path) const;
+    // Packs and uploads an icon, replacing any earlier one for `path`. An icon without
+    // pixels is remembered as a failed load.
+    const AtlasIcon& add(const std::string& path, PreparedIcon icon);
+    // Frees the icon's space
+    void release(const std::string& path);
+    void clear();
+
+    // Moves the icons of pages less than COMPACT_OCCUPANCY full onto fuller pages where
+    // they fit, and deletes the pages that end up empty. Returns the number deleted.
+    size_t compact();
+    // Icons that add() or compact() moved to another page since the last call (their
+    // textureId changed), for owners that track memory per texture
+    std::vector<std::string> takeMovedIcons();
+
+    Stats stats() const;
+
+private:
+    struct Page {
+        GLuint textureId = 0; // 0 for an unused slot
+        SkylinePacker packer{PAGE_SIZE, PAGE_SIZE};
+        size_t icons = 0;
+    };
+
+    struct Entry {
+        AtlasIcon icon;
+        int page = -1; // -1 if not packed (load failure)
+        PackedRect rect;
+        std::vector<unsigned char> pixels; // RGBA including the padding, kept for repacking
+    };
+
+    // Finds room for the entry on some page (repacking or adding a page if needed) and uploads it
+    void place(Entry& entry);
+    bool tryPlaceOnPage(Entry& entry, size_t pageIndex);
+    // Frees `rect` on page `pageIndex` (-1: nothing), deleting the page when it was the last icon on it
+    void removeFromPage(int pageIndex, const PackedRect& rect);
+    void repackPage(size_t pageIndex);
+    size_t addPage();
+    void upload(const Entry& entry);
+
+    std::vector<Page> m_pages;
+    std::unordered_map<std::string, Entry> m_entries;
+    size_t m_repacks = 0;
+    std::vector<std::string> m_movedIcons;
+};
@@ -0,0 +1,141 @@
+#include "IconLoader.hpp"
+#include "Utils/Logger.hpp"
+#include "Utils/TextureLoader.hpp"
+#include <algorithm>
+
+size_t IconLoader::defaultThreadCount()
+{
+    size_t hardwareThreads = std::thread::hardware_concurrency();
+    return std::clamp<size_t>(hardwareThreads / 2, 1, 4);
+}
+
+IconLoader::IconLoader(size_t threadCount)
+{
+    threadCount = std::max<size_t>(threadCount, 1);
+    m_threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&IconLoader::run, this);
+    }
+}
+
+IconLoader::~IconLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+void IconLoader::setWakeup(std::function<void()> wakeup)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_wakeup = std::move(wakeup);
+}
+
+void IconLoader::request(const std::string& path, bool isGif, int displaySize)
+{
+    if (m_pending.count(path)) return;
+    uint64_t ticket = m_nextTicket++;
+    m_pending.emplace(path, ticket);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back({path, ticket, isGif, displaySize});
+    }
+    m_condition.notify_one();
+}
+
+void IconLoader::cancel(const std::string& path)
+{
+    auto it = m_pending.find(path);
+    if (it == m_pending.end()) return;
+    uint64_t ticket = it->second;
+    m_pending.erase(it);
+
+    // Not started yet: no need to decode it at all
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto job = std::find_if(m_jobs.begin(), m_jobs.end(), [ticket](const Job& queued) { return queued.ticket == ticket; });
+    if (job != m_jobs.end()) m_jobs.erase(job);
+}
+
+size_t IconLoader::takeReady(size_t budgetBytes, const std::function<void(Result&)>& upload)
+{
+    std::vector<Result> taken;
+    size_t takenBytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (!m_ready.empty()) {
+            Finished& finished = m_ready.front();
+            auto pending = m_pending.find(finished.result.path);
+            if (pending == m_pending.end() || pending->second != finished.ticket) {
+                m_ready.pop_front(); // Cancelled or re-requested since
+                continue;
+            }
+            size_t bytes = finished.result.bytes();
+            if (!taken.empty() && takenBytes + bytes > budgetBytes) break;
+            m_pending.erase(pending);
+            takenBytes += bytes;
+            taken.push_back(std::move(finished.result));
+            m_ready.pop_front();
+        }
+    }
+    for (auto& result : taken) {
+        upload(result);
+    }
+    return takenBytes;
+}
+
+bool IconLoader::hasReady() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_ready.empty();
+}
+
+IconLoader::Result IconLoader::decode(const Job& job)
+{
+    Result result;
+    result.path = job.path;
+    result.isGif = job.isGif;
+    if (job.isGif) {
+        result.ok = GifLoader::OpenAnimatedGif(job.path.c_str(), result.gif);
+    } else {
+        std::vector<unsigned char> pixels;
+        int width = 0, height = 0;
+        if (TextureLoader::LoadPixels(job.path, pixels, width, height)) {
+            result.image = IconAtlas::prepare(pixels, width, height, job.displaySize);
+            result.ok = !result.image.pixels.empty();
+        } else {
+            result.image.displaySize = IconAtlas::clampDisplaySize(job.displaySize);
+        }
+    }
+    return result;
+}
+
+void IconLoader::run()
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        Result result = decode(job);
+
+        std::function<void()> wakeup;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping) return;
+            m_ready.push_back({job.ticket, std::move(result)});
+            wakeup = m_wakeup;
+        }
+        if (wakeup) wakeup();
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "IconAtlas.hpp"
+#include "Utils/GifLoader.hpp"
+
+// Decodes button icons on a small pool of worker threads, so the first frame of a large
+// deck doesn't stall on stbi_load / GIF decoding. Static images come back already scaled
+// for the IconAtlas, GIFs with their first frame composited; the UI thread uploads them with
+// takeReady(), a bounded number of bytes per frame.
+//
+// request(), cancel() and takeReady() must all be called from the UI thread.
+class IconLoader {
+public:
+    // A finished decode
+    struct Result {
+        std::string path;
+        bool isGif = false;
+        bool ok = false;
+        IconAtlas::PreparedIcon image; // Static images
+        GifLoader::AnimatedGif gif;    // GIFs: opened, first frame composited, no texture yet
+
+        size_t bytes() const { return isGif ? gif.canvasBytes() : image.bytes(); }
+    };
+
+    // Half the hardware threads, at least 1 and at most 4; decoding is I/O and memory bound
+    static size_t defaultThreadCount();
+
+    explicit IconLoader(size_t threadCount = defaultThreadCount());
+    ~IconLoader(); // Discards queued decodes and waits for the running ones
+
+    IconLoader(const IconLoader&) = delete;
+    IconLoader& operator=(const IconLoader&) = delete;
+
+    // Called (from a worker thread) when a result is ready, so an idle main loop can
+    // wake up, e.g. glfwPostEmptyEvent
+    void setWakeup(std::function<void()> wakeup);
+
+    // Queue a decode of `path`, unless one is already queued or running. Static images
+    // are scaled for `displaySize`.
+    void request(const std::string& path, bool isGif, int displaySize);
+    bool isPending(const std::string& path) const { return m_pending.count(path) != 0; }
+    // Forget a requested decode; its result is dropped when it arrives
+    void cancel(const std::string& path);
+
+    // Hands finished results to `upload`, oldest first, until about `budgetBytes` have been
+    // handed over (always at least one, so a result larger than the budget still goes
+    // through). Returns the number of bytes handed over.
+    size_t takeReady(size_t budgetBytes, const std::function<void(Result&)>& upload);
+    // Results waiting for takeReady()
+    bool hasReady() const;
+
+private:
+    struct Job {
+        std::string path;
+        uint64_t ticket;
+        bool isGif;
+        int displaySize;
+    };
+    struct Finished {
+        uint64_t ticket;
+        Result result;
+    };
+
+    void run();
+    static Result decode(const Job& job);
+
+    // UI thread only: the ticket of the newest request for each path
+    std::unordered_map<std::string, uint64_t> m_pending;
+    uint64_t m_nextTicket = 1;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition; // Wakes the workers
+    std::deque<Job> m_jobs;
+    std::deque<Finished> m_ready;
+    std::function<void()> m_wakeup;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
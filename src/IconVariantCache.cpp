@@ -0,0 +1,154 @@
+#include "IconVariantCache.hpp"
+#include "Utils/FileUtils.hpp"
+#include "Utils/HashUtils.hpp"
+#include "Utils/IconResizer.hpp"
+#include "Utils/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Part of every file name's hash; bump it when IconResizer's output changes so old
+    // files are no longer found (and get trimmed eventually)
+    constexpr uint64_t kFormatVersion = 1;
+} // namespace
+
+int IconVariantCache::bucketSize(double cssPixels, double devicePixelRatio)
+{
+    if (!(cssPixels > 0.0) || !(devicePixelRatio > 0.0)) return 0; // Also rejects NaN
+    double pixels = std::min(std::ceil(cssPixels * devicePixelRatio), static_cast<double>(MAX_SIZE));
+    int size = (static_cast<int>(pixels) + SIZE_STEP - 1) / SIZE_STEP * SIZE_STEP;
+    return std::clamp(size, MIN_SIZE, MAX_SIZE);
+}
+
+IconVariantCache::IconVariantCache(fs::path directory, size_t diskBudget, size_t threadCount)
+    : m_directory(std::move(directory)), m_diskBudget(diskBudget)
+{
+    m_jobs.push_back([this] { trimDirectory(); });
+    threadCount = std::max<size_t>(threadCount, 1);
+    m_threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&IconVariantCache::run, this);
+    }
+}
+
+IconVariantCache::~IconVariantCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+void IconVariantCache::request(fs::path sourcePath, int size, Callback done)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back([this, sourcePath = std::move(sourcePath), size, done = std::move(done)] {
+            done(produce(sourcePath, size));
+        });
+    }
+    m_condition.notify_one();
+}
+
+IconVariantCache::Variant IconVariantCache::produce(const fs::path& sourcePath, int size)
+{
+    Variant variant;
+    std::string source;
+    std::string error;
+    if (!FileUtils::ReadWholeFile(sourcePath, source, error)) {
+        Logger::Warn("[IconVariants] Could not read {}: {}", sourcePath, error);
+        return variant;
+    }
+    variant.ok = true;
+
+    IconResizer::Format format = IconResizer::outputFormat(source);
+    std::string name = HashUtils::ToHex(HashUtils::XxHash64(source, kFormatVersion)) + "-" + std::to_string(size);
+    variant.mimeType = std::string(IconResizer::mimeType(format));
+    variant.etag = "\"" + name + "\"";
+    fs::path cachedPath = m_directory / (name + std::string(IconResizer::extension(format)));
+
+    // Made before, maybe by an earlier run
+    std::error_code ec;
+    if (fs::is_regular_file(cachedPath, ec) && FileUtils::ReadWholeFile(cachedPath, variant.body, error)) {
+        fs::last_write_time(cachedPath, fs::file_time_type::clock::now(), ec); // Recently used, for trimDirectory()
+        variant.useOriginal = variant.body.empty();
+        return variant;
+    }
+
+    variant.body.clear(); // In case a half-read file left something there
+    auto encoded = IconResizer::shrink(source, size);
+    if (encoded) {
+        variant.body = std::move(encoded->bytes);
+        Logger::Debug("[IconVariants] {} -> {}x{}, {} -> {} bytes", sourcePath, encoded->width, encoded->height,
+                      source.size(), variant.body.size());
+    } else {
+        variant.useOriginal = true;
+    }
+
+    fs::create_directories(m_directory, ec);
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (!FileUtils::WriteFileAtomically(cachedPath, variant.body, error)) {
+        // Still served from memory; only the next run has to encode it again
+        Logger::Warn("[IconVariants] Could not write {}: {}", cachedPath, error);
+    }
+    return variant;
+}
+
+void IconVariantCache::trimDirectory()
+{
+    struct Entry {
+        fs::path path;
+        fs::file_time_type used;
+        uintmax_t bytes;
+    };
+    std::vector<Entry> entries;
+    uintmax_t totalBytes = 0;
+    std::error_code ec;
+    if (!fs::is_directory(m_directory, ec)) return;
+    for (auto it = fs::directory_iterator(m_directory, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        std::error_code entryError; // Skips the entry; ec ends the scan
+        if (!it->is_regular_file(entryError)) continue;
+        if (it->path().extension() == ".tmp") { // Left behind by a crash
+            fs::remove(it->path(), entryError);
+            continue;
+        }
+        Entry entry{it->path(), it->last_write_time(entryError), it->file_size(entryError)};
+        if (entryError) continue;
+        totalBytes += entry.bytes;
+        entries.push_back(std::move(entry));
+    }
+    if (totalBytes <= m_diskBudget) return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    size_t removed = 0;
+    for (const auto& entry : entries) {
+        if (totalBytes <= m_diskBudget) break;
+        if (fs::remove(entry.path, ec)) {
+            totalBytes -= entry.bytes;
+            ++removed;
+        }
+    }
+    Logger::Info("[IconVariants] Trimmed {} old files from {} ({} bytes left).", removed, m_directory, totalBytes);
+}
+
+void IconVariantCache::run()
+{
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
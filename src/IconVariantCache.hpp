@@ -0,0 +1,70 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Icons re-encoded at the size the web client shows them (IconResizer), made on a small
+// pool of worker threads so the uWS event loop never decodes an image. Each variant is
+// written once to the cache directory as "<xxhash64 of the source>-<size><ext>" and read
+// back from there afterwards, also after a restart; an edited icon hashes differently and
+// simply gets new files. An empty file records that the source is already small enough.
+// Least recently used files are deleted at startup while the directory is over budget.
+//
+// request() is thread-safe; callbacks run on a worker thread.
+class IconVariantCache {
+public:
+    struct Variant {
+        bool ok = false;          // False if the source could not be read
+        bool useOriginal = false; // The source is as small as it gets; send it unchanged
+        std::string mimeType;
+        std::string etag;         // Quoted; identifies the source content and size
+        std::string body;
+    };
+    using Callback = std::function<void(Variant)>;
+
+    // Requested sizes are rounded up to a multiple of SIZE_STEP and clamped, so clients
+    // with slightly different layouts share variants and the number of files stays small
+    static constexpr int MIN_SIZE = 16;
+    static constexpr int MAX_SIZE = 512;
+    static constexpr int SIZE_STEP = 16;
+    static constexpr size_t DEFAULT_DISK_BUDGET = 64 * 1024 * 1024;
+
+    // Variant size in pixels for an icon shown at `cssPixels` on a `devicePixelRatio`
+    // screen; 0 if the numbers make no sense
+    static int bucketSize(double cssPixels, double devicePixelRatio);
+
+    explicit IconVariantCache(std::filesystem::path directory, size_t diskBudget = DEFAULT_DISK_BUDGET,
+                              size_t threadCount = 2);
+    ~IconVariantCache(); // Discards queued requests (their callbacks never run) and waits for the running ones
+
+    IconVariantCache(const IconVariantCache&) = delete;
+    IconVariantCache& operator=(const IconVariantCache&) = delete;
+
+    // Produces the variant of the file `sourcePath` whose larger side is at most `size`
+    // pixels (see bucketSize) and hands it to `done` on a worker thread
+    void request(std::filesystem::path sourcePath, int size, Callback done);
+
+    const std::filesystem::path& directory() const { return m_directory; }
+
+private:
+    Variant produce(const std::filesystem::path& sourcePath, int size);
+    void trimDirectory();
+    void run();
+
+    std::filesystem::path m_directory;
+    size_t m_diskBudget;
+    std::mutex m_writeMutex; // Two sources with the same content would share "<path>.tmp"
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition; // Wakes the workers
+    std::deque<std::function<void()>> m_jobs;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
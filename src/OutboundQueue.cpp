@@ -0,0 +1,63 @@
+#include "OutboundQueue.hpp"
+#include <cstddef>
+
+bool OutboundQueue::push(std::string_view payload, bool binary, std::string_view key, size_t maxBytes) {
+    if (!key.empty()) {
+        for (size_t index = 0; index < m_messages.size(); ++index) {
+            OutboundMessage& message = m_messages[index];
+            if (message.key != key) continue;
+
+            ++m_coalesced;
+            if (payload.size() > maxBytes) {
+                // The queued state is stale and its replacement can't be queued either
+                m_bytes -= message.payload.size();
+                m_messages.erase(m_messages.begin() + static_cast<ptrdiff_t>(index));
+                ++m_dropped;
+                return false;
+            }
+
+            // Keep the slot (and therefore the ordering) of the superseded message
+            m_bytes = m_bytes - message.payload.size() + payload.size();
+            message.payload.assign(payload);
+            message.binary = binary;
+
+            // A larger replacement may overshoot; drop the oldest other messages
+            bool lostMessages = false;
+            while (m_bytes > maxBytes) {
+                size_t victim = index == 0 ? 1 : 0;
+                m_bytes -= m_messages[victim].payload.size();
+                m_messages.erase(m_messages.begin() + static_cast<ptrdiff_t>(victim));
+                if (victim < index) --index;
+                ++m_dropped;
+                lostMessages = true;
+            }
+            return !lostMessages;
+        }
+    }
+
+    if (payload.size() > maxBytes) {
+        ++m_dropped;
+        return false;
+    }
+
+    bool lostMessages = false;
+    while (!m_messages.empty() && m_bytes + payload.size() > maxBytes) {
+        pop();
+        ++m_dropped;
+        lostMessages = true;
+    }
+
+    m_messages.push_back({std::string(payload), binary, std::string(key)});
+    m_bytes += payload.size();
+    return !lostMessages;
+}
+
+void OutboundQueue::pop() {
+    m_bytes -= m_messages.front().payload.size();
+    m_messages.pop_front();
+}
+
+void OutboundQueue::clear() {
+    m_messages.clear();
+    m_bytes = 0;
+}
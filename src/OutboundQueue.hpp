@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+
+// A message waiting to be handed to uWS for one client
+struct OutboundMessage {
+    std::string payload;
+    bool binary = false;
+    std::string key; // Non-empty for state messages; a newer message with the same key replaces it
+};
+
+// Per-client FIFO of messages held back while the socket is congested.
+// CommServer keeps one in PerSocketData and only hands messages to uWS while the
+// socket's buffered amount is below the high watermark, so a stalled client costs at
+// most maxBytes here instead of an unbounded uWS buffer.
+// Not thread-safe: only touch it from the uWS event-loop thread.
+class OutboundQueue {
+public:
+    // Queue a message. State messages with a key replace any queued message with the
+    // same key (only the latest layout/state matters). If the queue would exceed
+    // maxBytes, also through a larger replacement, the oldest messages are dropped;
+    // returns false in that case so the caller can schedule a full resync for the client.
+    bool push(std::string_view payload, bool binary, std::string_view key, size_t maxBytes);
+
+    bool empty() const { return m_messages.empty(); }
+    size_t size() const { return m_messages.size(); }
+    size_t bytes() const { return m_bytes; }
+
+    const OutboundMessage& front() const { return m_messages.front(); }
+    void pop();
+    void clear();
+
+    // Lifetime counters for this client
+    uint64_t dropped() const { return m_dropped; }
+    uint64_t coalesced() const { return m_coalesced; }
+    void countDropped(uint64_t count = 1) { m_dropped += count; }
+
+private:
+    std::deque<OutboundMessage> m_messages;
+    size_t m_bytes = 0;
+    uint64_t m_dropped = 0;
+    uint64_t m_coalesced = 0;
+};
@@ -0,0 +1,102 @@
+#include "RenderScheduler.hpp"
+#include "Utils/Logger.hpp"
+#include <imgui.h>
+#include <imgui_internal.h> // InputEventsQueue: input the backend queued during the wait
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+namespace {
+    // CPU time used by the whole process so far, in seconds
+    double processCpuSeconds() {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0.0;
+        auto toTicks = [](const FILETIME& time) {
+            return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+        };
+        return static_cast<double>(toTicks(kernel) + toTicks(user)) / 1e7; // 100 ns ticks
+#else
+        timespec time{};
+        if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0) return 0.0;
+        return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) / 1e9;
+#endif
+    }
+} // namespace
+
+RenderScheduler::RenderScheduler(GLFWwindow* window)
+    : m_window(window)
+{
+    m_statsStart = glfwGetTime();
+    m_statsCpuStart = processCpuSeconds();
+}
+
+bool RenderScheduler::waitForNextFrame()
+{
+    bool minimized = glfwGetWindowAttrib(m_window, GLFW_ICONIFIED) != 0;
+    double now = glfwGetTime();
+    double deadline = minimized ? NO_DEADLINE : m_deadline;
+    if (!minimized && m_settleFrames > 0) {
+        glfwPollEvents();
+    } else if (deadline == NO_DEADLINE) {
+        glfwWaitEvents();
+    } else if (deadline > now) {
+        glfwWaitEventsTimeout(deadline - now);
+    } else {
+        glfwPollEvents();
+    }
+    ++m_wakeups;
+    m_frameStart = glfwGetTime();
+    updateStats(m_frameStart);
+
+    if (glfwGetWindowAttrib(m_window, GLFW_ICONIFIED)) {
+        return false;
+    }
+    // Input needs a few frames to be fully reflected (hover, click release, window moves);
+    // an empty event or a deadline only needs the one
+    if (ImGui::GetCurrentContext()->InputEventsQueue.Size > 0) {
+        m_settleFrames = SETTLE_FRAMES;
+    }
+    return true;
+}
+
+void RenderScheduler::frameDrawn(double secondsUntilAnimation)
+{
+    ++m_frames;
+    if (m_settleFrames > 0) --m_settleFrames;
+
+    double delay = secondsUntilAnimation;
+    if (ImGui::GetIO().WantTextInput) {
+        delay = std::min(delay, TEXT_INPUT_INTERVAL);
+    }
+    // Relative to the start of the frame, like the animation timings themselves
+    m_deadline = std::isinf(delay) ? NO_DEADLINE : m_frameStart + std::max(delay, 0.0);
+}
+
+void RenderScheduler::updateStats(double now)
+{
+    double elapsed = now - m_statsStart;
+    if (elapsed < STATS_INTERVAL) return;
+
+    double cpu = processCpuSeconds();
+    m_stats.framesPerSecond = m_frames / elapsed;
+    m_stats.wakeupsPerSecond = m_wakeups / elapsed;
+    m_stats.cpuPercent = 100.0 * (cpu - m_statsCpuStart) / elapsed;
+    Logger::Debug("[Render] {} s: {} frames/s, {} wakeups/s, process CPU {}%", elapsed, m_stats.framesPerSecond,
+                  m_stats.wakeupsPerSecond, m_stats.cpuPercent);
+
+    m_statsStart = now;
+    m_statsCpuStart = cpu;
+    m_frames = 0;
+    m_wakeups = 0;
+}
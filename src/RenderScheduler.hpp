@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+struct GLFWwindow;
+
+// Decides when the main loop draws a frame. Instead of rendering at vsync forever, the
+// loop sleeps in glfwWaitEventsTimeout() until one of these happens:
+//   - input arrives (then a few extra frames are drawn so hover/release states settle)
+//   - another thread calls glfwPostEmptyEvent() (actions handed back by ActionExecutor,
+//     new log lines, server state changes, config reloads)
+//   - the next animation frame is due (GIF frames of the visible buttons)
+// Nothing is drawn while the window is minimized.
+class RenderScheduler {
+public:
+    // Averages over the last STATS_INTERVAL seconds (or longer, if the loop slept through it)
+    struct Stats {
+        double framesPerSecond = 0.0;
+        double wakeupsPerSecond = 0.0;
+        double cpuPercent = 0.0; // Process CPU time (all threads) over wall time; one busy core = 100
+    };
+
+    static constexpr int SETTLE_FRAMES = 3;            // Frames drawn after input
+    static constexpr double TEXT_INPUT_INTERVAL = 0.2; // Redraw cadence while a text field is active (caret blink)
+    static constexpr double STATS_INTERVAL = 5.0;
+    static constexpr double NO_DEADLINE = std::numeric_limits<double>::infinity();
+
+    explicit RenderScheduler(GLFWwindow* window);
+
+    // Sleeps until the next frame is due or an event arrives, and processes the events.
+    // Returns false if nothing needs drawing (window minimized).
+    bool waitForNextFrame();
+
+    // Call after each drawn frame. `secondsUntilAnimation` is how long after the frame
+    // started the UI changes by itself (NO_DEADLINE if nothing animates).
+    void frameDrawn(double secondsUntilAnimation);
+
+    const Stats& stats() const { return m_stats; }
+
+private:
+    GLFWwindow* m_window;
+    int m_settleFrames = SETTLE_FRAMES; // The first frames are drawn unconditionally
+    double m_deadline = NO_DEADLINE;    // glfwGetTime() of the next animation frame
+    double m_frameStart = 0.0;          // glfwGetTime() when the current frame began
+
+    // Counters for the current stats period
+    Stats m_stats;
+    double m_statsStart = 0.0;
+    double m_statsCpuStart = 0.0;
+    uint64_t m_frames = 0;
+    uint64_t m_wakeups = 0;
+
+    void updateStats(double now);
+};
@@ -0,0 +1,126 @@
+#include "TextureResidency.hpp"
+
+void TextureResidency::attach(Entry& entry, uint64_t textureId, size_t textureBytes) {
+    entry.textureId = textureId;
+    auto it = m_textures.find(textureId);
+    if (it == m_textures.end()) {
+        m_recency.push_front(textureId);
+        it = m_textures.emplace(textureId, Texture{}).first;
+        it->second.bytes = textureBytes;
+        it->second.lastFrame = entry.lastFrame;
+        it->second.position = m_recency.begin();
+        m_residentBytes += textureBytes;
+    }
+    ++it->second.icons;
+}
+
+void TextureResidency::detach(uint64_t textureId) {
+    auto it = m_textures.find(textureId);
+    if (it == m_textures.end() || --it->second.icons > 0) return;
+    m_residentBytes -= it->second.bytes;
+    m_recency.erase(it->second.position);
+    m_textures.erase(it);
+}
+
+void TextureResidency::markDrawn(Entry& entry) {
+    entry.lastFrame = m_frame;
+    Texture& texture = m_textures.at(entry.textureId);
+    if (texture.lastFrame != m_frame) {
+        texture.lastFrame = m_frame;
+        m_recency.splice(m_recency.begin(), m_recency, texture.position);
+    }
+}
+
+void TextureResidency::add(const std::string& path, uint64_t textureId, size_t textureBytes) {
+    auto [it, inserted] = m_entries.try_emplace(path);
+    if (!inserted) {
+        detach(it->second.textureId); // Replaced, e.g. prepared for another size
+    }
+    attach(it->second, textureId, textureBytes);
+    markDrawn(it->second);
+}
+
+void TextureResidency::move(const std::string& path, uint64_t textureId, size_t textureBytes) {
+    auto it = m_entries.find(path);
+    if (it == m_entries.end() || it->second.textureId == textureId) return;
+    // Attach first, so a texture gaining and losing icons in one move is never freed
+    uint64_t previous = it->second.textureId;
+    attach(it->second, textureId, textureBytes);
+    detach(previous);
+    Texture& texture = m_textures.at(textureId);
+    if (texture.lastFrame < it->second.lastFrame) {
+        texture.lastFrame = it->second.lastFrame;
+        m_recency.splice(m_recency.begin(), m_recency, texture.position);
+    }
+}
+
+bool TextureResidency::touch(const std::string& path) {
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) return false;
+    ++m_hits;
+    markDrawn(it->second);
+    return true;
+}
+
+void TextureResidency::remove(const std::string& path) {
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) return;
+    detach(it->second.textureId);
+    m_entries.erase(it);
+}
+
+void TextureResidency::clear() {
+    m_entries.clear();
+    m_textures.clear();
+    m_recency.clear();
+    m_residentBytes = 0;
+}
+
+std::vector<std::string> TextureResidency::evict() {
+    std::vector<std::string> evicted;
+    if (m_residentBytes <= m_budget) return evicted;
+
+    // Whole textures, least recently drawn first; each one frees its bytes
+    while (m_residentBytes > m_budget && !m_recency.empty()) {
+        uint64_t textureId = m_recency.back();
+        if (m_textures.at(textureId).lastFrame == m_frame) break; // Everything left is on screen
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->second.textureId != textureId) {
+                ++it;
+                continue;
+            }
+            evicted.push_back(it->first);
+            detach(it->second.textureId);
+            it = m_entries.erase(it);
+            ++m_evictions;
+        }
+    }
+
+    // Every texture left has an icon on screen. The others on them only cost memory once
+    // the owner has moved the visible ones onto fewer textures.
+    if (m_residentBytes > m_budget) {
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->second.lastFrame == m_frame) {
+                ++it;
+                continue;
+            }
+            evicted.push_back(it->first);
+            detach(it->second.textureId);
+            it = m_entries.erase(it);
+            ++m_evictions;
+        }
+    }
+    return evicted;
+}
+
+TextureResidency::Stats TextureResidency::stats() const {
+    Stats stats;
+    stats.residentBytes = m_residentBytes;
+    stats.budgetBytes = m_budget;
+    stats.icons = m_entries.size();
+    stats.textures = m_textures.size();
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    return stats;
+}
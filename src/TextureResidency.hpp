@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Keeps the button icon textures (atlas pages and GIF canvases) within a byte budget.
+// The owner reports which texture each icon was uploaded to and what it drew each frame.
+// Memory is counted per texture, as allocated: an atlas page costs its full size while
+// any icon is on it, however few. When that goes over the budget, evict() names the icons
+// to release, whole textures at a time, least recently drawn first. They are decoded again
+// the next time a button shows them.
+//
+// Only bookkeeping: no GL calls, so the owner decides how an icon is released.
+class TextureResidency {
+public:
+    // Enough for several pages of large icons and a few animations; small enough for
+    // integrated GPUs that share a few hundred MB with the system
+    static constexpr size_t DEFAULT_BUDGET = 64 * 1024 * 1024;
+
+    struct Stats {
+        size_t residentBytes = 0; // Allocated by the textures that hold at least one icon
+        size_t budgetBytes = 0;
+        size_t icons = 0;
+        size_t textures = 0;
+        uint64_t hits = 0;      // Draws of an icon that was resident
+        uint64_t misses = 0;    // Loads, including reloads after an eviction
+        uint64_t evictions = 0; // Icons
+
+        double hitRate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+    };
+
+    explicit TextureResidency(size_t budgetBytes = DEFAULT_BUDGET) : m_budget(budgetBytes) {}
+
+    void setBudget(size_t budgetBytes) { m_budget = budgetBytes; }
+    size_t budget() const { return m_budget; }
+    bool overBudget() const { return m_residentBytes > m_budget; }
+
+    // Starts a new frame; icons drawn in it are never evicted during it
+    void beginFrame() { ++m_frame; }
+    // `path` was uploaded to texture `textureId`, which allocates `textureBytes` in total
+    // (shared with the other icons on it). Counts as drawn.
+    void add(const std::string& path, uint64_t textureId, size_t textureBytes);
+    // `path` was moved to another texture (an atlas repack or compaction); not a draw
+    void move(const std::string& path, uint64_t textureId, size_t textureBytes);
+    // `path` is drawn this frame. Returns false (and counts nothing) if it isn't resident.
+    bool touch(const std::string& path);
+    // A load was started for an icon that wasn't resident
+    void countMiss() { ++m_misses; }
+    // The owner released `path` itself (not an eviction)
+    void remove(const std::string& path);
+    void clear();
+
+    // Icons to release until the rest fits the budget. First every icon of the least
+    // recently drawn textures, which frees those textures. If the textures still in use
+    // are over budget by themselves, then the icons on them that were not drawn in the
+    // current frame; that frees nothing until the owner moves the remaining icons
+    // together (IconAtlas::compact()). Evicted icons are forgotten here; the owner must
+    // release them.
+    std::vector<std::string> evict();
+
+    Stats stats() const;
+
+private:
+    struct Texture {
+        size_t bytes = 0;
+        size_t icons = 0;
+        uint64_t lastFrame = 0;                 // Newest draw of any of its icons
+        std::list<uint64_t>::iterator position; // In m_recency
+    };
+    struct Entry {
+        uint64_t textureId = 0;
+        uint64_t lastFrame = 0;
+    };
+
+    // Puts the entry on a texture (creating it) or takes it off (deleting it when empty)
+    void attach(Entry& entry, uint64_t textureId, size_t textureBytes);
+    void detach(uint64_t textureId);
+    void markDrawn(Entry& entry);
+
+    size_t m_budget;
+    uint64_t m_frame = 0;
+    size_t m_residentBytes = 0;
+    std::list<uint64_t> m_recency; // Textures, most recently drawn first
+    std::unordered_map<uint64_t, Texture> m_textures;
+    std::unordered_map<std::string, Entry> m_entries;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+};
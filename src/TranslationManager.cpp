@@ -1,6 +1,7 @@
 #include "TranslationManager.hpp"
+#include <algorithm>
 #include <fstream>
-#include <iostream>
+#include "Utils/Logger.hpp"
 #include <filesystem> // Requires C++17
 
 namespace fs = std::filesystem;
@@ -8,19 +9,20 @@ namespace fs = std::filesystem;
 TranslationManager::TranslationManager(const std::string& langFolderPath, const std::string& defaultLang)
     : m_langFolderPath(langFolderPath)
 {
+    resolveStrings(); // Every key reads as the fallback until a language loads
     detectAvailableLanguages();
     if (!setLanguage(defaultLang)) {
-        std::cerr << "Warning: Failed to load default language '" << defaultLang << "'.";
+        Logger::Warn("Failed to load default language '{}'.", defaultLang);
         // Try loading English as a fallback if available
         if (std::find(m_availableLanguages.begin(), m_availableLanguages.end(), "en") != m_availableLanguages.end()) {
              if (setLanguage("en")) {
-                 std::cerr << " Loaded 'en' instead." << std::endl;
+                 Logger::Warn("Loaded 'en' instead of '{}'.", defaultLang);
              } else {
-                 std::cerr << " Failed to load 'en' fallback either." << std::endl;
+                 Logger::Error("Failed to load 'en' fallback either.");
                  m_currentLanguage = ""; // Indicate no language loaded
              }
         } else {
-             std::cerr << " No fallback language found." << std::endl;
+             Logger::Error("No fallback language found.");
              m_currentLanguage = "";
         }
     }
@@ -33,14 +35,14 @@ void TranslationManager::detectAvailableLanguages() {
             for (const auto& entry : fs::directory_iterator(m_langFolderPath)) {
                 if (entry.is_regular_file() && entry.path().extension() == ".json") {
                     m_availableLanguages.push_back(entry.path().stem().string());
-                     std::cout << "Detected language file: " << entry.path().filename() << std::endl;
+                     Logger::Info("Detected language file: {}", entry.path().filename());
                 }
             }
         } else {
-             std::cerr << "Language folder not found or not a directory: " << m_langFolderPath << std::endl;
+             Logger::Error("Language folder not found or not a directory: {}", m_langFolderPath);
         }
     } catch (const fs::filesystem_error& e) {
-        std::cerr << "Filesystem error accessing language folder: " << e.what() << std::endl;
+        Logger::Error("Filesystem error accessing language folder: {}", e.what());
     }
      std::sort(m_availableLanguages.begin(), m_availableLanguages.end()); // Keep it sorted
 }
@@ -49,33 +51,58 @@ void TranslationManager::detectAvailableLanguages() {
 bool TranslationManager::loadLanguage(const std::string& langCode) {
     fs::path langFilePath = fs::path(m_langFolderPath) / (langCode + ".json");
     if (!fs::exists(langFilePath)) {
-        std::cerr << "Error: Language file not found: " << langFilePath << std::endl;
+        Logger::Error("Language file not found: {}", langFilePath);
         return false;
     }
 
     std::ifstream langFile(langFilePath);
     if (!langFile.is_open()) {
-        std::cerr << "Error: Could not open language file: " << langFilePath << std::endl;
+        Logger::Error("Could not open language file: {}", langFilePath);
         return false;
     }
 
     try {
-        langFile >> m_translations;
+        json translations;
+        langFile >> translations;
         langFile.close();
-        m_cachedStrings.clear(); // Clear cache when new language is loaded
-        std::cout << "Successfully loaded language: " << langCode << std::endl;
+        if (!translations.is_object()) {
+            Logger::Error("Language file {} is not a JSON object.", langFilePath);
+            return false;
+        }
+        m_translations = std::move(translations);
+        resolveStrings();
+        Logger::Info("Successfully loaded language: {}", langCode);
         return true;
     } catch (json::parse_error& e) {
-        std::cerr << "Error parsing language file: " << langFilePath << "\nMessage: " << e.what() << std::endl;
-        m_translations = json::object(); // Clear translations on error
+        Logger::Error("Error parsing language file: {}\nMessage: {}", langFilePath, e.what());
         return false;
     } catch (const std::exception& e) {
-         std::cerr << "Error loading language file " << langFilePath << ": " << e.what() << std::endl;
-         m_translations = json::object();
+         Logger::Error("Error loading language file {}: {}", langFilePath, e.what());
          return false;
     }
 }
 
+void TranslationManager::resolveStrings() {
+    size_t missing = 0;
+    for (size_t i = 0; i < TR_KEY_COUNT; ++i) {
+        auto it = m_translations.find(TR_KEY_NAMES[i]);
+        if (it != m_translations.end() && it->is_string()) {
+            m_strings[i] = it->get<std::string>();
+        } else {
+            m_strings[i] = m_fallbackString;
+            if (!m_translations.empty()) {
+                Logger::Warn("Translation key not found or not a string: '{}'", TR_KEY_NAMES[i]);
+            }
+            ++missing;
+        }
+    }
+    m_extraStrings.clear();
+    if (missing > 0 && !m_translations.empty()) {
+        Logger::Warn("{} of {} translation keys are missing; they will show as '{}'.", missing, TR_KEY_COUNT,
+                     m_fallbackString);
+    }
+}
+
 bool TranslationManager::setLanguage(const std::string& langCode) {
     if (loadLanguage(langCode)) {
         m_currentLanguage = langCode;
@@ -84,37 +111,32 @@ bool TranslationManager::setLanguage(const std::string& langCode) {
     return false;
 }
 
-const std::string& TranslationManager::get(const std::string& key) {
-    // Check cache first
-    auto it_cache = m_cachedStrings.find(key);
-    if (it_cache != m_cachedStrings.end()) {
-        return it_cache->second;
+std::optional<TrKey> TranslationManager::findKey(std::string_view name) {
+    auto it = std::lower_bound(TR_KEY_NAMES.begin(), TR_KEY_NAMES.end(), name);
+    if (it == TR_KEY_NAMES.end() || *it != name) {
+        return std::nullopt;
     }
+    return static_cast<TrKey>(it - TR_KEY_NAMES.begin());
+}
 
-    // If not in cache, look in the loaded JSON translations
-    try {
-        auto it_json = m_translations.find(key);
-        if (it_json != m_translations.end() && it_json->is_string()) {
-            // Key found in JSON, get the value
-            std::string value = it_json->get<std::string>();
-            // Insert into the mutable cache and return reference to inserted element
-            // Use emplace for potential efficiency
-            auto result = m_cachedStrings.emplace(key, std::move(value)); 
-            return result.first->second; // Return reference to the inserted string in the map
-        } else {
-            // Key not found in JSON or not a string
-            if (!m_currentLanguage.empty()) { // Only warn if a language was actually loaded
-                 std::cerr << "Warning: Translation key not found or not a string: '" << key << "' in language '" << m_currentLanguage << "'" << std::endl;
-            }
-        }
-    } catch (const json::exception& e) {
-        std::cerr << "Error accessing translation key '" << key << "': " << e.what() << std::endl;
+const std::string& TranslationManager::get(std::string_view key) {
+    if (auto known = findKey(key)) {
+        return get(*known);
     }
 
-     // Fallback: Key not found or error occurred
-     // Insert the fallback string into the cache and return reference to it
-     auto result = m_cachedStrings.emplace(key, m_fallbackString); // Use fallback string directly
-     return result.first->second;
+    // Not a key of the reference language; look in the loaded JSON once and cache the result
+    auto it_cache = m_extraStrings.find(key);
+    if (it_cache != m_extraStrings.end()) {
+        return it_cache->second;
+    }
+    std::string value = m_fallbackString;
+    auto it_json = m_translations.find(key);
+    if (it_json != m_translations.end() && it_json->is_string()) {
+        value = it_json->get<std::string>();
+    } else if (!m_currentLanguage.empty()) { // Only warn if a language was actually loaded
+        Logger::Warn("Translation key not found or not a string: '{}' in language '{}'", key, m_currentLanguage);
+    }
+    return m_extraStrings.emplace(std::string(key), std::move(value)).first->second;
 }
 
 const std::string& TranslationManager::getCurrentLanguage() const {
@@ -1,9 +1,14 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <nlohmann/json.hpp>
-#include <map>
+#include <array>
+#include <optional>
+#include <unordered_map>
 #include <vector> // For available languages
+#include "TranslationKeys.hpp" // Generated from assets/lang/en.json
+#include "Utils/HashUtils.hpp"
 
 using json = nlohmann::json;
 
@@ -12,8 +17,16 @@ public:
     // Constructor, loads default language
     explicit TranslationManager(const std::string& langFolderPath = "assets/lang", const std::string& defaultLang = "zh");
 
-    // Get translated string for a given key
-    const std::string& get(const std::string& key);
+    // Get translated string for a key known at compile time (every key in en.json).
+    // Resolved when the language is loaded, so this is just an array index.
+    const std::string& get(TrKey key) const { return m_strings[static_cast<size_t>(key)]; }
+
+    // Get translated string for a key only known at runtime. Keys from en.json still
+    // resolve through the table; anything else is looked up once and cached.
+    const std::string& get(std::string_view key);
+
+    // The TrKey named `name`, if en.json has it
+    static std::optional<TrKey> findKey(std::string_view name);
 
     // Switch language
     bool setLanguage(const std::string& langCode);
@@ -30,12 +43,17 @@ private:
     std::string m_currentLanguage;
     json m_translations; // Current loaded translations
     std::string m_fallbackString = "???"; // String to return if key not found
-    std::map<std::string, std::string> m_cachedStrings; // Cache for retrieved strings to return const ref
+    std::array<std::string, TR_KEY_COUNT> m_strings; // Current language, indexed by TrKey
+    // Runtime keys that aren't in en.json, resolved on first use
+    std::unordered_map<std::string, std::string, HashUtils::StringHash, std::equal_to<>> m_extraStrings;
     std::vector<std::string> m_availableLanguages;
 
     // Load translations from a file for a specific language code
     bool loadLanguage(const std::string& langCode);
 
+    // Fill m_strings from m_translations
+    void resolveStrings();
+
     // Scan the lang folder for available language files (.json)
     void detectAvailableLanguages();
-};
\ No newline at end of file
+};
@@ -7,6 +7,7 @@
 #include <iphlpapi.h> // For GetAdaptersAddresses
 #include <iostream>   // For std::cerr
 #include <qrcodegen.hpp> // Re-add QR Code generation library
+#include "Utils/AllocationProfiler.hpp"
 
 
 // Define STB_IMAGE_IMPLEMENTATION in *one* CPP file before including stb_image.h
@@ -68,8 +69,8 @@ UIManager::UIManager(ConfigManager& configManager, ActionExecutor& actionExecuto
       m_translator(translationManager),
       m_buttonGridWindow(configManager, actionExecutor, translationManager),
       m_configWindow(configManager, translationManager),
-      m_statusLogWindow(translationManager),
-      m_qrCodeWindow(translationManager) // <<< ADDED: Initialize the QR code window
+      m_statusLogWindow(translationManager, m_frameArena),
+      m_qrCodeWindow(translationManager, m_frameArena) // <<< ADDED: Initialize the QR code window
 {
     m_serverIP = NetworkUtils::GetLocalIPv4(); // <<< ADDED: Call helper on startup
 }
@@ -83,19 +84,43 @@ UIManager::~UIManager()
 
 void UIManager::drawUI()
 {
+    m_frameArena.reset();
+
+    // GL objects can only be deleted here, on the thread that owns the context
+    std::vector<std::string> staleIconPaths;
+    {
+        std::lock_guard<std::mutex> lock(m_staleIconsMutex);
+        staleIconPaths.swap(m_staleIconPaths);
+    }
+    if (!staleIconPaths.empty()) {
+        m_buttonGridWindow.releaseIconTextures(staleIconPaths);
+    }
+
     ImGuiID dockspace_id = ImGui::GetID("MyDockSpace");
     ImGui::DockSpace(dockspace_id, ImVec2(0.0f, 0.0f), ImGuiDockNodeFlags_PassthruCentralNode);
 
-    // drawButtonGridWindow(); // <<< REMOVED
-    m_buttonGridWindow.Draw(); // <<< ADDED: Call the new class's Draw method
-    m_configWindow.Draw(); // <<< ADDED: Call the new class's Draw method
-    m_statusLogWindow.Draw(m_isServerRunning, m_serverPort, m_serverIP, [this]() {
-        m_serverIP = NetworkUtils::GetLocalIPv4();
-    });
-    // drawQrCodeWindow(); // <<< REMOVED
-    m_qrCodeWindow.Draw(m_isServerRunning, m_serverPort, m_serverIP, [this]() {
-        m_serverIP = NetworkUtils::GetLocalIPv4();
-    });
+    // Each window's allocations are reported separately when profiling is built in
+    {
+        AllocationProfiler::Scope scope("ButtonGrid");
+        m_buttonGridWindow.Draw(); // <<< ADDED: Call the new class's Draw method
+    }
+    {
+        AllocationProfiler::Scope scope("Configuration");
+        m_configWindow.Draw(); // <<< ADDED: Call the new class's Draw method
+    }
+    {
+        AllocationProfiler::Scope scope("StatusLog");
+        m_statusLogWindow.Draw(m_isServerRunning, m_serverPort, m_serverIP, m_renderStats,
+                               m_buttonGridWindow.textureStats(), [this]() {
+            m_serverIP = NetworkUtils::GetLocalIPv4();
+        });
+    }
+    {
+        AllocationProfiler::Scope scope("QrCode");
+        m_qrCodeWindow.Draw(m_isServerRunning, m_serverPort, m_serverIP, [this]() {
+            m_serverIP = NetworkUtils::GetLocalIPv4();
+        });
+    }
 }
 
 
@@ -105,6 +130,11 @@ void UIManager::setServerStatus(bool isRunning, int port) {
     m_serverPort = port;
 }
 
+void UIManager::invalidateIconTextures(const std::vector<std::string>& iconPaths) {
+    std::lock_guard<std::mutex> lock(m_staleIconsMutex);
+    m_staleIconPaths.insert(m_staleIconPaths.end(), iconPaths.begin(), iconPaths.end());
+}
+
 // Helper function to get the local IPv4 address (Windows specific)
 // void UIManager::updateLocalIP() { // <<< REMOVED: Entire function moved to NetworkUtils
     // ... (implementation removed)
@@ -3,6 +3,8 @@
 #include <imgui.h>
 #include <string>
 #include <map>
+#include <mutex>
+#include <vector>
 #include "ConfigManager.hpp"
 #include "ActionExecutor.hpp"
 #include "TranslationManager.hpp"
@@ -11,6 +13,8 @@
 #include "UIWindows/UIStatusLogWindow.hpp"
 #include "UIWindows/UIQrCodeWindow.hpp"
 #include "Utils/NetworkUtils.hpp"
+#include "Utils/FrameArena.hpp"
+#include "RenderScheduler.hpp"
 
 
 class UIManager
@@ -24,6 +28,28 @@ public:
     // Method to receive server status from main application
     void setServerStatus(bool isRunning, int port);
 
+    // Render loop statistics, shown in the status window
+    void setRenderStats(const RenderScheduler::Stats& stats) { m_renderStats = stats; }
+
+    // Seconds after the last drawUI() until something on screen animates by itself
+    // (RenderScheduler::NO_DEADLINE if nothing does)
+    double secondsUntilNextFrame() const { return m_buttonGridWindow.secondsUntilNextFrame(); }
+
+    // Called from a decoder thread when a button icon is ready to upload, so an idle
+    // main loop can wake up (e.g. glfwPostEmptyEvent)
+    void setIconWakeup(std::function<void()> wakeup) { m_buttonGridWindow.setIconWakeup(std::move(wakeup)); }
+
+    // True if the Status/Log window was on screen in the last frame (not collapsed or
+    // behind another tab). Safe to call from any thread, e.g. a Logger tail listener.
+    bool isLogWindowVisible() const { return m_statusLogWindow.isVisible(); }
+
+    // Byte budget for the button icon textures (TextureResidency::DEFAULT_BUDGET by default)
+    void setTextureBudget(size_t budgetBytes) { m_buttonGridWindow.setTextureBudget(budgetBytes); }
+
+    // Forget cached icon textures for these paths. Safe to call from any thread; the
+    // textures are released on the UI thread at the start of the next drawUI().
+    void invalidateIconTextures(const std::vector<std::string>& iconPaths);
+
 private:
     ConfigManager& m_configManager;
     ActionExecutor& m_actionExecutor;
@@ -33,6 +59,14 @@ private:
     bool m_isServerRunning = false;
     int m_serverPort = 0;
     std::string m_serverIP = "Fetching..."; // Default value
+    RenderScheduler::Stats m_renderStats;
+
+    // Icon paths queued by invalidateIconTextures(), released by drawUI()
+    std::mutex m_staleIconsMutex;
+    std::vector<std::string> m_staleIconPaths;
+
+    // Temporaries of the windows, reset at the start of every drawUI()
+    FrameArena m_frameArena;
 
     
     // <<< ADDED: Member variable for the button grid window
@@ -1,6 +1,21 @@
 #include "UIButtonGridWindow.hpp"
-#include <iostream> // For std::cerr, std::cout
-#include <algorithm> // For std::transform
+#include "../Utils/Logger.hpp"
+#include <algorithm> // For std::count_if
+#include <cctype>
+#include <cmath>
+
+namespace {
+    // Case-insensitive ".gif" suffix check, without lowercasing a copy of the path
+    bool isGifPath(std::string_view path) {
+        constexpr std::string_view GIF_EXTENSION = ".gif";
+        if (path.size() <= GIF_EXTENSION.size()) return false;
+        std::string_view extension = path.substr(path.size() - GIF_EXTENSION.size());
+        for (size_t i = 0; i < GIF_EXTENSION.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(extension[i])) != GIF_EXTENSION[i]) return false;
+        }
+        return true;
+    }
+} // namespace
 
 UIButtonGridWindow::UIButtonGridWindow(ConfigManager& configManager, ActionExecutor& actionExecutor, TranslationManager& translationManager)
     : m_configManager(configManager), m_actionExecutor(actionExecutor), m_translator(translationManager) {}
@@ -10,58 +25,207 @@ UIButtonGridWindow::~UIButtonGridWindow() {
 }
 
 void UIButtonGridWindow::releaseAnimatedGifTextures() {
-    for (auto const& [path, gifData] : m_animatedGifTextures) {
+    for (auto& [path, gifData] : m_animatedGifTextures) {
         if (gifData.loaded) {
-            glDeleteTextures(gifData.frameTextureIds.size(), gifData.frameTextureIds.data());
-             std::cout << "Deleted " << gifData.frameTextureIds.size() << " GIF textures (GridWindow) for: " << path << std::endl;
+            GifLoader::ReleaseAnimatedGif(gifData);
+            Logger::Info("Deleted GIF texture (GridWindow) for: {}", path);
         }
     }
     m_animatedGifTextures.clear();
+    m_loadedIconPaths.clear();
+    m_failedIconPaths.clear();
+    m_residency.clear();
+}
+
+void UIButtonGridWindow::releaseIconTextures(const std::vector<std::string>& iconPaths) {
+    for (const auto& path : iconPaths) {
+        auto it = m_animatedGifTextures.find(path);
+        if (it != m_animatedGifTextures.end()) {
+            if (it->second.loaded) {
+                GifLoader::ReleaseAnimatedGif(it->second);
+                Logger::Info("Deleted GIF texture (GridWindow) for: {}", path);
+            }
+            m_animatedGifTextures.erase(it);
+        }
+        m_iconAtlas.release(path);
+        m_iconLoader.cancel(path);
+        m_residency.remove(path);
+        m_loadedIconPaths.erase(path);
+        m_failedIconPaths.erase(path);
+    }
+    syncMovedIcons(); // Releasing can repack a page
+}
+
+void UIButtonGridWindow::syncMovedIcons() {
+    for (const auto& path : m_iconAtlas.takeMovedIcons()) {
+        const AtlasIcon* icon = m_iconAtlas.find(path);
+        if (icon && icon->textureId != 0) m_residency.move(path, icon->textureId, IconAtlas::PAGE_BYTES);
+    }
+}
+
+void UIButtonGridWindow::uploadDecodedIcons() {
+    m_iconLoader.takeReady(ICON_UPLOAD_BUDGET, [this](IconLoader::Result& result) {
+        if (result.isGif) {
+            GifLoader::AnimatedGif& gifData = m_animatedGifTextures[result.path];
+            gifData = std::move(result.gif);
+            if (result.ok && GifLoader::UploadAnimatedGif(gifData)) {
+                gifData.lastFrameTime = ImGui::GetTime();
+                m_residency.add(result.path, gifData.textureId, gifData.canvasBytes());
+            } else {
+                gifData = {}; // A failure is cached as not loaded
+                m_failedIconPaths.insert(result.path);
+                Logger::Error("Failed to load GIF (GridWindow) from path: {}", result.path);
+            }
+        } else {
+            // Charged the whole page it lands on, since the page is only freed once every icon on it is released
+            const AtlasIcon& icon = m_iconAtlas.add(result.path, std::move(result.image));
+            if (icon.textureId != 0) {
+                m_residency.add(result.path, icon.textureId, IconAtlas::PAGE_BYTES);
+                syncMovedIcons(); // Making room can repack the page
+            } else {
+                m_residency.remove(result.path); // The earlier size, if any, is gone too
+                m_failedIconPaths.insert(result.path);
+            }
+        }
+    });
+    if (m_iconLoader.hasReady()) {
+        m_secondsUntilNextFrame = 0.0; // Over budget; the rest goes up next frame
+    }
 }
 
-void UIButtonGridWindow::DrawSingleButton(const ButtonConfig& button, double currentTime, float buttonSize) {
+void UIButtonGridWindow::openPage(const std::string& pageId, bool isFolder) {
+    if (pageId == m_currentPageId) return;
+    if (isFolder) {
+        m_folderTrail.push_back(m_currentPageId);
+    } else {
+        m_folderTrail.clear();
+    }
+    m_currentPageId = pageId;
+    m_prunedGeneration = 0; // Retry failed icons on the next Draw()
+    Logger::Debug("Button grid showing page '{}'", pageId);
+}
+
+void UIButtonGridWindow::pruneIconTextures(const ConfigSnapshot& snapshot) {
+    std::unordered_set<std::string_view> used;
+    for (const auto& button : snapshot.buttons) {
+        used.insert(button.icon_path);
+    }
+    std::vector<std::string> unused(m_failedIconPaths.begin(), m_failedIconPaths.end());
+    for (const auto& path : m_loadedIconPaths) {
+        if (!used.count(path) && !m_failedIconPaths.count(path)) unused.push_back(path);
+    }
+    if (!unused.empty()) {
+        Logger::Debug("Releasing {} icon textures no button uses or that failed to load", unused.size());
+        releaseIconTextures(unused);
+    }
+    m_prunedGeneration = snapshot.generation;
+}
+
+void UIButtonGridWindow::evictIconTextures() {
+    std::vector<std::string> evicted = m_residency.evict();
+    if (evicted.empty()) return;
+    releaseIconTextures(evicted);
+    if (m_residency.overBudget()) {
+        // Only icons drawn last frame are left, spread over pages that are mostly empty
+        m_iconAtlas.compact();
+        syncMovedIcons();
+    }
+    TextureResidency::Stats stats = m_residency.stats();
+    Logger::Debug("Evicted {} least recently drawn icons ({} textures, {} of {} bytes left)", evicted.size(),
+                  stats.textures, stats.residentBytes, stats.budgetBytes);
+}
+
+const std::string& UIButtonGridWindow::pageLabel(const PageConfig& page) const {
+    if (!page.name.empty()) return page.name;
+    return page.id.empty() ? m_translator.get(TrKey::root_page_name) : page.id;
+}
+
+void UIButtonGridWindow::DrawPageBar(const ConfigSnapshot& snapshot, const PageContents& page) {
+    if (page.page.folder) {
+        if (ImGui::Button(m_translator.get(TrKey::page_back_button).c_str())) {
+            std::string parent = m_folderTrail.empty() ? std::string() : m_folderTrail.back();
+            if (!m_folderTrail.empty()) m_folderTrail.pop_back();
+            m_currentPageId = parent;
+            m_prunedGeneration = 0;
+        }
+        ImGui::SameLine();
+        ImGui::TextUnformatted(pageLabel(page.page).c_str());
+        ImGui::Separator();
+        return;
+    }
+
+    size_t topLevelPages = std::count_if(snapshot.deck.begin(), snapshot.deck.end(),
+                                         [](const PageContents& contents) { return !contents.page.folder; });
+    if (topLevelPages < 2) return;
+    bool first = true;
+    for (const auto& contents : snapshot.deck) {
+        if (contents.page.folder) continue;
+        if (!first) ImGui::SameLine();
+        first = false;
+        ImGui::PushID(contents.page.id.c_str());
+        if (ImGui::RadioButton(pageLabel(contents.page).c_str(), contents.page.id == m_currentPageId)) {
+            openPage(contents.page.id, false);
+        }
+        ImGui::PopID();
+    }
+    ImGui::Separator();
+}
+
+void UIButtonGridWindow::DrawSingleButton(const ButtonConfig& button, double currentTime, float buttonSize, int iconPixels) {
     ImGui::PushID(button.id.c_str());
 
     GLuint textureID = 0;
+    ImVec2 uv0(0, 0), uv1(1, 1);
     bool useImageButton = false;
-    std::string lowerIconPath = button.icon_path;
-    std::transform(lowerIconPath.begin(), lowerIconPath.end(), lowerIconPath.begin(), ::tolower);
 
     if (!button.icon_path.empty()) {
-        if (lowerIconPath.length() > 4 && lowerIconPath.substr(lowerIconPath.length() - 4) == ".gif") {
+        if (isGifPath(button.icon_path)) {
             // Handle Animated GIF
             auto it = m_animatedGifTextures.find(button.icon_path);
-            if (it == m_animatedGifTextures.end()) {
-                GifLoader::AnimatedGif gifData;
-                if (GifLoader::LoadAnimatedGifFromFile(button.icon_path.c_str(), gifData)) {
-                    gifData.lastFrameTime = currentTime;
-                    m_animatedGifTextures[button.icon_path] = std::move(gifData);
-                    it = m_animatedGifTextures.find(button.icon_path);
-                } else {
-                     m_animatedGifTextures[button.icon_path] = {}; // Cache failure
-                    std::cerr << "Failed to load GIF (GridWindow) for button '" << button.id << "' from path: " << button.icon_path << std::endl;
-                }
+            if (it == m_animatedGifTextures.end() && !m_iconLoader.isPending(button.icon_path)) {
+                m_iconLoader.request(button.icon_path, true, iconPixels); // Shows the name until uploaded
+                m_loadedIconPaths.insert(button.icon_path);
+                m_residency.countMiss();
             }
 
-            if (it != m_animatedGifTextures.end() && it->second.loaded && !it->second.frameTextureIds.empty()) {
+            if (it != m_animatedGifTextures.end() && it->second.loaded && it->second.textureId != 0) {
                  GifLoader::AnimatedGif& gif = it->second;
                 double timeSinceLastFrame = currentTime - gif.lastFrameTime;
-                double frameDelaySeconds = static_cast<double>(gif.frameDelaysMs[gif.currentFrame]) / 1000.0;
+                double frameDelaySeconds = static_cast<double>(gif.currentDelayMs) / 1000.0;
 
-                if (timeSinceLastFrame >= frameDelaySeconds) {
-                    gif.currentFrame = (gif.currentFrame + 1) % gif.frameTextureIds.size();
+                // The idle loop wakes us at the deadline; a wakeup a hair early still counts
+                constexpr double DEADLINE_SLACK = 0.002;
+                if (gif.animated && timeSinceLastFrame >= frameDelaySeconds - DEADLINE_SLACK) {
+                    GifLoader::AdvanceAnimatedGif(gif); // Decodes the next frame into the canvas texture
                     gif.lastFrameTime = currentTime;
+                    timeSinceLastFrame = 0.0;
+                    frameDelaySeconds = static_cast<double>(gif.currentDelayMs) / 1000.0;
                 }
-                textureID = gif.frameTextureIds[gif.currentFrame];
+                if (gif.animated) {
+                    m_secondsUntilNextFrame = std::min(m_secondsUntilNextFrame, frameDelaySeconds - timeSinceLastFrame);
+                }
+                m_residency.touch(button.icon_path);
+                textureID = gif.textureId;
                 useImageButton = true;
             }
         } else {
-            // Handle Static Image using the global TextureLoader
-            textureID = TextureLoader::LoadTexture(button.icon_path);
-            if (textureID != 0) {
+            // Static image, packed into the icon atlas at the size it is shown at. Until the
+            // decoder delivers, the button shows its name (or the icon at its previous size).
+            const AtlasIcon* icon = m_iconAtlas.find(button.icon_path);
+            if ((!icon || icon->displaySize != IconAtlas::clampDisplaySize(iconPixels)) &&
+                !m_iconLoader.isPending(button.icon_path)) {
+                m_iconLoader.request(button.icon_path, false, iconPixels);
+                m_loadedIconPaths.insert(button.icon_path); // Failures too, so that they are retried once unused
+                m_residency.countMiss();
+            }
+            if (icon && icon->textureId != 0) {
+                m_residency.touch(button.icon_path);
+                textureID = icon->textureId;
+                uv0 = icon->uv0;
+                uv1 = icon->uv1;
                 useImageButton = true;
             } else {
-                // TextureLoader::LoadTexture already logs errors
+                // TextureLoader::LoadPixels already logs errors
             }
         }
     }
@@ -70,13 +234,15 @@ void UIButtonGridWindow::DrawSingleButton(const ButtonConfig& button, double cur
     bool buttonClicked = false;
     ImVec2 sizeVec(buttonSize, buttonSize);
     if (useImageButton && textureID != 0) {
-         buttonClicked = ImGui::ImageButton(button.id.c_str(), // Use button.id as str_id for image button too
-                                            (ImTextureID)(intptr_t)textureID,
-                                            sizeVec,
-                                            ImVec2(0, 0), // uv0
-                                            ImVec2(1, 1), // uv1
-                                            ImVec4(0,0,0,0), // bg_col
-                                            ImVec4(1,1,1,1)); // tint_col
+        // Laid out and drawn like ImageButton, but with the image in the icon channel
+        ImVec2 padding = ImGui::GetStyle().FramePadding;
+        buttonClicked = ImGui::Button("##icon", ImVec2(buttonSize + padding.x * 2, buttonSize + padding.y * 2));
+        ImVec2 imageMin(ImGui::GetItemRectMin().x + padding.x, ImGui::GetItemRectMin().y + padding.y);
+        ImVec2 imageMax(imageMin.x + buttonSize, imageMin.y + buttonSize);
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        m_drawSplitter.SetCurrentChannel(drawList, ICON_CHANNEL);
+        drawList->AddImage((ImTextureID)(intptr_t)textureID, imageMin, imageMax, uv0, uv1);
+        m_drawSplitter.SetCurrentChannel(drawList, FRAME_CHANNEL);
          if (ImGui::IsItemHovered()) {
             ImGui::SetTooltip("%s", button.name.c_str());
          }
@@ -86,23 +252,49 @@ void UIButtonGridWindow::DrawSingleButton(const ButtonConfig& button, double cur
 
     // Handle Click
     if (buttonClicked) {
-         printf("Button '%s' (ID: %s) clicked! Action: %s(%s)\n",
-               button.name.c_str(), button.id.c_str(),
-               button.action_type.c_str(), button.action_param.c_str());
-        m_actionExecutor.requestAction(button.id);
+        Logger::Debug("Button '{}' (ID: {}) clicked! Action: {}({})", button.name, button.id, button.action_type,
+                      button.action_param);
+        if (button.action_type == OPEN_FOLDER_ACTION) {
+            // Takes effect next frame; this frame keeps drawing the page it started with
+            openPage(button.action_param, true);
+        } else {
+            m_actionExecutor.requestAction(button.id);
+        }
     }
 
     ImGui::PopID();
 }
 
 void UIButtonGridWindow::Draw() {
-    ImGui::Begin(m_translator.get("button_grid_window_title").c_str());
+    m_secondsUntilNextFrame = std::numeric_limits<double>::infinity();
+    uploadDecodedIcons();
+    evictIconTextures(); // Before the new frame: nothing drawn in the last one is evicted
+    m_residency.beginFrame();
+    if (!ImGui::Begin(m_translator.get(TrKey::button_grid_window_title).c_str())) {
+        ImGui::End(); // Collapsed or a hidden dock tab: nothing to draw or animate
+        return;
+    }
 
-    const std::vector<ButtonConfig>& buttons = m_configManager.getButtons();
+    auto configSnapshot = m_configManager.getSnapshot();
+    const std::vector<ButtonConfig>& buttons = configSnapshot->buttons;
     double currentTime = ImGui::GetTime();
 
-    if (buttons.empty()) {
-        ImGui::TextUnformatted(m_translator.get("no_buttons_loaded").c_str());
+    // The page may have been removed from the configuration; fall back to the root page
+    const PageContents* page = configSnapshot->findPage(m_currentPageId);
+    if (!page) {
+        m_currentPageId.clear();
+        m_folderTrail.clear();
+        page = configSnapshot->findPage(m_currentPageId);
+    }
+    if (m_prunedGeneration != configSnapshot->generation) {
+        pruneIconTextures(*configSnapshot);
+    }
+    if (page) {
+        DrawPageBar(*configSnapshot, *page);
+    }
+
+    if (buttons.empty() || !page) {
+        ImGui::TextUnformatted(m_translator.get(TrKey::no_buttons_loaded).c_str());
     } else {
         const float button_size = 100.0f; // Base button size
         // --- Potential Dynamic Layout --- 
@@ -115,10 +307,13 @@ void UIButtonGridWindow::Draw() {
         // --- End Potential Dynamic Layout ---
         
         int button_index_in_row = 0;
+        // Icons are packed at the framebuffer resolution they are shown at
+        int iconPixels = static_cast<int>(std::ceil(button_size * ImGui::GetIO().DisplayFramebufferScale.x));
 
-        for (const auto& button : buttons) {
+        m_drawSplitter.Split(ImGui::GetWindowDrawList(), 2);
+        for (uint32_t index : page->buttons) {
             // Call the helper function to draw the button
-            DrawSingleButton(button, currentTime, button_size);
+            DrawSingleButton(buttons[index], currentTime, button_size, iconPixels);
 
             // Handle layout (wrapping)
             button_index_in_row++;
@@ -134,6 +329,7 @@ void UIButtonGridWindow::Draw() {
         if (button_index_in_row != 0) {
              ImGui::NewLine();
         }
+        m_drawSplitter.Merge(ImGui::GetWindowDrawList()); // Icons end up drawn over the frames
     }
 
     ImGui::End();
@@ -4,12 +4,16 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_set>
+#include <limits>
 #include <GL/glew.h> // For GLuint
 #include "../ConfigManager.hpp"
 #include "../ActionExecutor.hpp"
 #include "../TranslationManager.hpp"
+#include "../IconAtlas.hpp"
+#include "../IconLoader.hpp"
+#include "../TextureResidency.hpp"
 #include "../Utils/GifLoader.hpp" // For AnimatedGif struct
-#include "../Utils/TextureLoader.hpp"
 
 // Forward declare UIManager to avoid circular dependency if needed later
 // class UIManager;
@@ -21,6 +25,27 @@ public:
 
     void Draw();
 
+    // Drop the cached textures (static and animated) for these icon paths; they are
+    // reloaded from disk the next time a button shows them
+    void releaseIconTextures(const std::vector<std::string>& iconPaths);
+
+    // Icon textures beyond this many bytes are released, least recently drawn first
+    void setTextureBudget(size_t budgetBytes) { m_residency.setBudget(budgetBytes); }
+    TextureResidency::Stats textureStats() const { return m_residency.stats(); }
+
+    // Page being shown; empty for the root page
+    const std::string& currentPageId() const { return m_currentPageId; }
+
+    // Seconds from the last Draw() until a visible GIF shows its next frame (0 while decoded
+    // icons are waiting for upload); infinity if nothing visible changes by itself
+    double secondsUntilNextFrame() const { return m_secondsUntilNextFrame; }
+
+    // Called from a decoder thread when an icon is ready to upload (e.g. glfwPostEmptyEvent)
+    void setIconWakeup(std::function<void()> wakeup) { m_iconLoader.setWakeup(std::move(wakeup)); }
+
+    // Bytes of decoded icons uploaded to the GPU per frame; the rest wait for the next one
+    static constexpr size_t ICON_UPLOAD_BUDGET = 4 * 1024 * 1024;
+
     // Helper function to load static textures (moved from UIManager)
     // GLuint LoadTextureFromFile(const char* filename);
 
@@ -29,12 +54,46 @@ private:
     ActionExecutor& m_actionExecutor;
     TranslationManager& m_translator;
 
-    // Texture management moved here from UIManager for icons used in this window
-    // std::map<std::string, GLuint> m_buttonIconTextures;
+    // Static icons are packed into the atlas; GIFs keep a canvas texture each. Both are
+    // decoded off the UI thread; buttons show their name until the icon is uploaded.
+    IconAtlas m_iconAtlas;
     std::map<std::string, GifLoader::AnimatedGif> m_animatedGifTextures;
+    IconLoader m_iconLoader;
+    // Both kinds of icon count against one texture budget, by the textures they allocate
+    TextureResidency m_residency;
+
+    // Button frames and labels go to one channel and icons to another, so that after the
+    // merge all icons on the same atlas page are drawn by a single draw command
+    ImDrawListSplitter m_drawSplitter;
+    static constexpr int FRAME_CHANNEL = 0;
+    static constexpr int ICON_CHANNEL = 1;
+
+    // Only the page being shown is drawn. Icons of other pages stay loaded until the
+    // texture budget needs their room, so switching back is instant.
+    std::string m_currentPageId;
+    std::vector<std::string> m_folderTrail; // Pages to return to, innermost last
+    std::unordered_set<std::string> m_loadedIconPaths; // Icons with a texture (static or GIF) or being decoded
+    std::unordered_set<std::string> m_failedIconPaths; // Loads that failed; retried on the next page change
+    uint64_t m_prunedGeneration = 0;     // Config generation the loaded icons were last checked against
+    double m_secondsUntilNextFrame = std::numeric_limits<double>::infinity();
 
     void releaseAnimatedGifTextures(); // Helper for GIF textures
+    // Uploads decoded icons, up to ICON_UPLOAD_BUDGET bytes
+    void uploadDecodedIcons();
+
+    // Show another page: folders remember the page they were opened from
+    void openPage(const std::string& pageId, bool isFolder);
+    // Release the icons no button uses any more, and forget failed loads so they are retried
+    void pruneIconTextures(const ConfigSnapshot& snapshot);
+    // Release the least recently drawn icons while over the texture budget, then compact
+    // the atlas if the pages still in use are over it
+    void evictIconTextures();
+    // Tell the residency about icons the atlas moved to another page
+    void syncMovedIcons();
+    // Top-level page selector, or a back button inside a folder
+    void DrawPageBar(const ConfigSnapshot& snapshot, const PageContents& page);
+    const std::string& pageLabel(const PageConfig& page) const;
 
     // <<< ADDED: Helper function to draw a single button
-    void DrawSingleButton(const ButtonConfig& button, double currentTime, float buttonSize);
+    void DrawSingleButton(const ButtonConfig& button, double currentTime, float buttonSize, int iconPixels);
 };
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "UIConfigurationWindow.hpp"
 #include "../Utils/InputUtils.hpp" // Include necessary headers
-#include <iostream>          // For std::cout, std::cerr
+#include "../Utils/Logger.hpp"
 #include <cstring>           // For strncpy, strlen
 #include <string>            // For std::string manipulation
 
@@ -8,6 +8,13 @@
 UIConfigurationWindow::UIConfigurationWindow(ConfigManager& configManager, TranslationManager& translationManager)
     : m_configManager(configManager), m_translator(translationManager) {}
 
+std::string_view UIConfigurationWindow::selectedActionType() const {
+    if (m_newButtonActionTypeIndex < 0 || m_newButtonActionTypeIndex >= static_cast<int>(m_supportedActionTypes.size())) {
+        return {};
+    }
+    return m_supportedActionTypes[m_newButtonActionTypeIndex].type;
+}
+
 // Implementation of HandleFileDialog (moved from the end of drawConfigurationWindow)
 void UIConfigurationWindow::HandleFileDialog() {
     std::string selectedFilePath;
@@ -27,7 +34,7 @@ void UIConfigurationWindow::HandleFileDialog() {
             selectedFilePath = ImGuiFileDialog::Instance()->GetFilePathName();
             // No need to check user data if we use distinct keys
             updateParam = true; // Assume OK means update the action param
-            std::cout << "Selected App Path: " << selectedFilePath << std::endl;
+            Logger::Info("Selected App Path: {}", selectedFilePath);
         }
         ImGuiFileDialog::Instance()->Close();
     }
@@ -38,7 +45,7 @@ void UIConfigurationWindow::HandleFileDialog() {
             selectedFilePath = ImGuiFileDialog::Instance()->GetFilePathName();
             // No need to check user data if we use distinct keys
             updateIcon = true; // Assume OK means update the icon path
-            std::cout << "Selected Icon Path: " << selectedFilePath << std::endl;
+            Logger::Info("Selected Icon Path: {}", selectedFilePath);
         }
         ImGuiFileDialog::Instance()->Close();
     }
@@ -48,29 +55,32 @@ void UIConfigurationWindow::HandleFileDialog() {
     if (updateParam) {
          strncpy(m_newButtonActionParam, selectedFilePath.c_str(), sizeof(m_newButtonActionParam) - 1);
          m_newButtonActionParam[sizeof(m_newButtonActionParam) - 1] = '\0'; // Ensure null termination
-         std::cout << "Updated Action Param Buffer: " << m_newButtonActionParam << std::endl;
+         Logger::Info("Updated Action Param Buffer: {}", m_newButtonActionParam);
     }
     if (updateIcon) {
          strncpy(m_newButtonIconPath, selectedFilePath.c_str(), sizeof(m_newButtonIconPath) - 1);
          m_newButtonIconPath[sizeof(m_newButtonIconPath) - 1] = '\0'; // Ensure null termination
-         std::cout << "Updated Icon Path Buffer: " << m_newButtonIconPath << std::endl;
+         Logger::Info("Updated Icon Path Buffer: {}", m_newButtonIconPath);
     }
 }
 
 
 void UIConfigurationWindow::Draw() {
-    ImGui::Begin(m_translator.get("config_window_title").c_str());
+    ImGui::Begin(m_translator.get(TrKey::config_window_title).c_str());
 
-    const auto& buttons = m_configManager.getButtons();
+    // Held for the whole frame: edits below publish a new snapshot, this one stays intact
+    auto configSnapshot = m_configManager.getSnapshot();
+    const auto& buttons = configSnapshot->buttons;
 
     // --- Loaded Buttons Table ---
     if (buttons.empty()) {
-        ImGui::TextUnformatted(m_translator.get("no_buttons_loaded").c_str());
+        ImGui::TextUnformatted(m_translator.get(TrKey::no_buttons_loaded).c_str());
     } else {
-        ImGui::TextUnformatted(m_translator.get("loaded_buttons_header").c_str());
-        if (ImGui::BeginTable("buttons_table", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable)) {
+        ImGui::TextUnformatted(m_translator.get(TrKey::loaded_buttons_header).c_str());
+        if (ImGui::BeginTable("buttons_table", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable)) {
             ImGui::TableSetupColumn("ID");
             ImGui::TableSetupColumn("Name");
+            ImGui::TableSetupColumn("Page");
             ImGui::TableSetupColumn("Actions");
             ImGui::TableHeadersRow();
 
@@ -81,8 +91,10 @@ void UIConfigurationWindow::Draw() {
                 ImGui::TableSetColumnIndex(1);
                 ImGui::Text("%s", button.name.c_str());
                 ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%s", button.page.c_str());
+                ImGui::TableSetColumnIndex(3);
                 ImGui::PushID(button.id.c_str());
-                if (ImGui::SmallButton(m_translator.get("edit_button_label").c_str())) {
+                if (ImGui::SmallButton(m_translator.get(TrKey::edit_button_label).c_str())) {
                     auto buttonToEditOpt = m_configManager.getButtonById(button.id);
                     if (buttonToEditOpt) {
                         const auto& btnCfg = *buttonToEditOpt;
@@ -91,28 +103,29 @@ void UIConfigurationWindow::Draw() {
                         strncpy(m_newButtonName, btnCfg.name.c_str(), sizeof(m_newButtonName) - 1); m_newButtonName[sizeof(m_newButtonName) - 1] = 0;
                         m_newButtonActionTypeIndex = -1; // Reset before searching
                         for(size_t i = 0; i < m_supportedActionTypes.size(); ++i) {
-                            if (m_supportedActionTypes[i] == btnCfg.action_type) {
+                            if (m_supportedActionTypes[i].type == btnCfg.action_type) {
                                 m_newButtonActionTypeIndex = static_cast<int>(i);
                                 break;
                             }
                         }
                         // Handle case where action type wasn't found (set to 0 or log error?)
                          if (m_newButtonActionTypeIndex == -1) {
-                            std::cerr << "Warning: Action type '" << btnCfg.action_type << "' for button ID '" << btnCfg.id << "' not found in supported types. Defaulting to first type." << std::endl;
+                            Logger::Warn("Action type '{}' for button ID '{}' not found in supported types. Defaulting to first type.", btnCfg.action_type, btnCfg.id);
                              m_newButtonActionTypeIndex = 0; // Default to the first one
                          }
 
                         strncpy(m_newButtonActionParam, btnCfg.action_param.c_str(), sizeof(m_newButtonActionParam) - 1); m_newButtonActionParam[sizeof(m_newButtonActionParam) - 1] = 0;
                         strncpy(m_newButtonIconPath, btnCfg.icon_path.c_str(), sizeof(m_newButtonIconPath) - 1); m_newButtonIconPath[sizeof(m_newButtonIconPath) - 1] = 0;
+                        strncpy(m_newButtonPage, btnCfg.page.c_str(), sizeof(m_newButtonPage) - 1); m_newButtonPage[sizeof(m_newButtonPage) - 1] = 0;
                         m_isCapturingHotkey = false; // Ensure capture mode is off when starting edit
                         m_manualHotkeyEntry = false; // Reset manual entry flag
-                        std::cout << "Editing button: " << m_editingButtonId << std::endl;
+                        Logger::Info("Editing button: {}", m_editingButtonId);
                     } else {
-                         std::cerr << "Error: Could not find button data for ID: " << button.id << " to edit." << std::endl;
+                         Logger::Error("Could not find button data for ID: {} to edit.", button.id);
                     }
                 }
                 ImGui::SameLine();
-                if (ImGui::SmallButton(m_translator.get("delete_button_label").c_str())) {
+                if (ImGui::SmallButton(m_translator.get(TrKey::delete_button_label).c_str())) {
                     m_buttonIdToDelete = button.id;
                     m_showDeleteConfirmation = true;
                 }
@@ -122,11 +135,23 @@ void UIConfigurationWindow::Draw() {
         }
     }
 
+    // --- Save Status ---
+    // Saves finish on a background thread, so their outcome is shown here rather than
+    // where the edit was made
+    ConfigPersister::Stats saveStats = m_configManager.getSaveStats();
+    if (!saveStats.lastError.empty()) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), m_translator.get(TrKey::config_save_failed).c_str(),
+                           saveStats.lastError.c_str());
+    } else if (saveStats.writes > 0) {
+        ImGui::TextDisabled(m_translator.get(TrKey::config_last_saved).c_str(),
+                            static_cast<unsigned long long>(saveStats.lastBytes), saveStats.lastLatency.count() / 1000.0);
+    }
+
     ImGui::Separator();
 
     // --- Add/Edit Section ---
     bool isEditing = !m_editingButtonId.empty();
-    ImGui::TextUnformatted(isEditing ? m_translator.get("edit_button_header").c_str() : m_translator.get("add_new_button_header").c_str());
+    ImGui::TextUnformatted(isEditing ? m_translator.get(TrKey::edit_button_header).c_str() : m_translator.get(TrKey::add_new_button_header).c_str());
 
     if (ImGui::BeginTable("add_edit_form", 2, ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_BordersInnerV )) {
         ImGui::TableSetupColumn("Labels", ImGuiTableColumnFlags_WidthFixed, 120.0f);
@@ -134,39 +159,38 @@ void UIConfigurationWindow::Draw() {
 
         // Row 1: Button ID
         ImGui::TableNextRow();
-        ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(m_translator.get("button_id_label").c_str());
+        ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(m_translator.get(TrKey::button_id_label).c_str());
         ImGui::TableSetColumnIndex(1);
         ImGui::PushItemWidth(-FLT_MIN); // Stretch
         ImGuiInputTextFlags idFlags = isEditing ? ImGuiInputTextFlags_ReadOnly : ImGuiInputTextFlags_None;
         ImGui::InputText("##ButtonID", m_newButtonId, sizeof(m_newButtonId), idFlags);
         ImGui::PopItemWidth();
-        if (ImGui::IsItemHovered() && !isEditing) { ImGui::SetTooltip("%s", m_translator.get("button_id_tooltip").c_str()); }
+        if (ImGui::IsItemHovered() && !isEditing) { ImGui::SetTooltip("%s", m_translator.get(TrKey::button_id_tooltip).c_str()); }
          if (isEditing) { ImGui::SameLine(); ImGui::TextDisabled("(Cannot be changed)"); }
 
 
         // Row 2: Button Name
         ImGui::TableNextRow();
-        ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(m_translator.get("button_name_label").c_str());
+        ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(m_translator.get(TrKey::button_name_label).c_str());
         ImGui::TableSetColumnIndex(1);
         ImGui::PushItemWidth(-FLT_MIN); // Stretch
         ImGui::InputText("##ButtonName", m_newButtonName, sizeof(m_newButtonName));
         ImGui::PopItemWidth();
-        if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get("button_name_tooltip").c_str()); }
+        if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get(TrKey::button_name_tooltip).c_str()); }
 
         // Row 3: Action Type
         ImGui::TableNextRow();
-        ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(m_translator.get("action_type_label").c_str());
+        ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(m_translator.get(TrKey::action_type_label).c_str());
         ImGui::TableSetColumnIndex(1);
         ImGui::PushItemWidth(-FLT_MIN); // Stretch
-        std::vector<const char*> actionTypeDisplayItems;
-        std::string previousActionType = (m_newButtonActionTypeIndex >= 0 && m_newButtonActionTypeIndex < m_supportedActionTypes.size()) ? m_supportedActionTypes[m_newButtonActionTypeIndex] : "";
-        for(const auto& type : m_supportedActionTypes) {
-            std::string translationKey = "action_type_" + type + "_display";
-            actionTypeDisplayItems.push_back(m_translator.get(translationKey).c_str());
+        std::string_view previousActionType = selectedActionType();
+        m_actionTypeDisplayItems.clear();
+        for(const auto& option : m_supportedActionTypes) {
+            m_actionTypeDisplayItems.push_back(m_translator.get(option.displayKey).c_str());
         }
-        if (ImGui::Combo("##ActionTypeCombo", &m_newButtonActionTypeIndex, actionTypeDisplayItems.data(), actionTypeDisplayItems.size())) {
+        if (ImGui::Combo("##ActionTypeCombo", &m_newButtonActionTypeIndex, m_actionTypeDisplayItems.data(), m_actionTypeDisplayItems.size())) {
              // If the action type changed *away* from hotkey, disable capture mode.
-             std::string newActionType = (m_newButtonActionTypeIndex >= 0 && m_newButtonActionTypeIndex < m_supportedActionTypes.size()) ? m_supportedActionTypes[m_newButtonActionTypeIndex] : "";
+             std::string_view newActionType = selectedActionType();
              if (previousActionType == "hotkey" && newActionType != "hotkey") {
                  m_isCapturingHotkey = false;
              }
@@ -179,18 +203,16 @@ void UIConfigurationWindow::Draw() {
         }
         ImGui::PopItemWidth();
         if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByPopup | ImGuiHoveredFlags_AllowWhenBlockedByActiveItem)) {
-            ImGui::SetTooltip("%s", m_translator.get("action_type_tooltip").c_str());
+            ImGui::SetTooltip("%s", m_translator.get(TrKey::action_type_tooltip).c_str());
         }
 
         // Row 4: Action Param
         ImGui::TableNextRow();
-        ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(m_translator.get("action_param_label").c_str());
+        ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(m_translator.get(TrKey::action_param_label).c_str());
         ImGui::TableSetColumnIndex(1);
         // Action Param Input Logic
         { // Scope for variables
-            std::string currentActionTypeStr = (m_newButtonActionTypeIndex >= 0 && m_newButtonActionTypeIndex < m_supportedActionTypes.size())
-                                               ? m_supportedActionTypes[m_newButtonActionTypeIndex]
-                                               : "";
+            std::string_view currentActionTypeStr = selectedActionType();
             bool isHotkeyAction = (currentActionTypeStr == "hotkey");
             bool isLaunchAppAction = (currentActionTypeStr == "launch_app");
             bool isMediaAction = (currentActionTypeStr.rfind("media_", 0) == 0);
@@ -208,20 +230,20 @@ void UIConfigurationWindow::Draw() {
                  if (strlen(m_newButtonActionParam) > 0) { m_newButtonActionParam[0] = '\0'; }
             } else if (isHotkeyAction) {
                 ImGui::Checkbox("##ManualHotkeyCheckbox", &m_manualHotkeyEntry);
-                ImGui::SameLine(); ImGui::TextUnformatted(m_translator.get("hotkey_manual_input_checkbox").c_str());
-                if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get("hotkey_manual_input_tooltip").c_str()); }
+                ImGui::SameLine(); ImGui::TextUnformatted(m_translator.get(TrKey::hotkey_manual_input_checkbox).c_str());
+                if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get(TrKey::hotkey_manual_input_tooltip).c_str()); }
 
                 ImGui::PushItemWidth(-FLT_MIN);
                 if (m_manualHotkeyEntry) {
                     m_isCapturingHotkey = false; // Turn off capture if switching to manual
                     ImGui::InputText("##ActionParamInputManual", m_newButtonActionParam, sizeof(m_newButtonActionParam));
-                    if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get("action_param_tooltip").c_str()); }
+                    if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get(TrKey::action_param_tooltip).c_str()); }
                 } else {
                     if (m_isCapturingHotkey) {
                         char capturePlaceholder[256];
-                        snprintf(capturePlaceholder, sizeof(capturePlaceholder), m_translator.get("hotkey_capture_prompt").c_str(), m_newButtonActionParam);
+                        snprintf(capturePlaceholder, sizeof(capturePlaceholder), m_translator.get(TrKey::hotkey_capture_prompt).c_str(), m_newButtonActionParam);
                         ImGui::InputText("##ActionParamInputCapturing", capturePlaceholder, sizeof(capturePlaceholder), ImGuiInputTextFlags_ReadOnly);
-                        if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get("hotkey_capture_tooltip_capturing").c_str()); }
+                        if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get(TrKey::hotkey_capture_tooltip_capturing).c_str()); }
 
                         // Attempt to capture the hotkey
                         if (InputUtils::TryCaptureHotkey(m_newButtonActionParam, sizeof(m_newButtonActionParam))) {
@@ -233,7 +255,7 @@ void UIConfigurationWindow::Draw() {
                         }
                     } else {
                         ImGui::InputText("##ActionParamInput", m_newButtonActionParam, sizeof(m_newButtonActionParam), ImGuiInputTextFlags_ReadOnly); // Readonly until clicked
-                        if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get("hotkey_capture_tooltip_start").c_str()); }
+                        if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get(TrKey::hotkey_capture_tooltip_start).c_str()); }
                         if (ImGui::IsItemClicked()) {
                              m_isCapturingHotkey = true;
                              m_newButtonActionParam[0] = '\0'; // Clear buffer on starting capture
@@ -246,18 +268,18 @@ void UIConfigurationWindow::Draw() {
                  m_isCapturingHotkey = false; // Ensure capture is off
                  float browseButtonWidth = 0.0f;
                  if (isLaunchAppAction) {
-                     browseButtonWidth = ImGui::CalcTextSize(m_translator.get("browse_button_label").c_str()).x + ImGui::GetStyle().ItemSpacing.x * 2.0f;
+                     browseButtonWidth = ImGui::CalcTextSize(m_translator.get(TrKey::browse_button_label).c_str()).x + ImGui::GetStyle().ItemSpacing.x * 2.0f;
                  }
                  float inputWidth = ImGui::GetContentRegionAvail().x - browseButtonWidth;
                  ImGui::PushItemWidth(inputWidth > 0 ? inputWidth : -FLT_MIN);
                  ImGui::InputText("##ActionParamInput", m_newButtonActionParam, sizeof(m_newButtonActionParam));
                  ImGui::PopItemWidth();
-                 if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get("action_param_tooltip").c_str()); }
+                 if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get(TrKey::action_param_tooltip).c_str()); }
 
                  if (isLaunchAppAction) {
                      ImGui::SameLine();
-                     if (ImGui::Button(m_translator.get("browse_button_label").c_str())) {
-                         const char* title = m_translator.get("select_app_dialog_title").c_str();
+                     if (ImGui::Button(m_translator.get(TrKey::browse_button_label).c_str())) {
+                         const char* title = m_translator.get(TrKey::select_app_dialog_title).c_str();
                          // Use a key specific to this window instance/purpose
                          const char* key = "SelectAppDlgKey_Config";
                          #ifdef _WIN32
@@ -268,7 +290,7 @@ void UIConfigurationWindow::Draw() {
                          IGFD::FileDialogConfig config; config.path = ".";
                          // config.userDatas = (void*)"ConfigWindowActionParam"; // Not strictly needed if using unique keys
                          ImGuiFileDialog::Instance()->OpenDialog(key, title, filters, config);
-                          std::cout << "Opening File Dialog: " << key << std::endl;
+                          Logger::Info("Opening File Dialog: {}", key);
                      }
                  }
             }
@@ -277,7 +299,7 @@ void UIConfigurationWindow::Draw() {
 
         // Row 5: Icon Path
         ImGui::TableNextRow();
-        ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(m_translator.get("button_icon_label").c_str());
+        ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(m_translator.get(TrKey::button_icon_label).c_str());
         ImGui::TableSetColumnIndex(1);
         // Icon Path Input Logic
         {
@@ -288,39 +310,48 @@ void UIConfigurationWindow::Draw() {
             ImGui::PopItemWidth();
             ImGui::SameLine();
             if (ImGui::Button("...##IconBrowse")) {
-                 const char* title = m_translator.get("select_icon_dialog_title").c_str(); // Use a specific title key
+                 const char* title = m_translator.get(TrKey::select_icon_dialog_title).c_str(); // Use a specific title key
                  const char* key = "SelectIconDlgKey_Config"; // Use a key specific to this window instance/purpose
                  // More specific image filters
                  const char* filters = "Image files (*.png *.jpg *.jpeg *.bmp *.gif){.png,.jpg,.jpeg,.bmp,.gif},.*";
                  IGFD::FileDialogConfig config; config.path = ".";
                  // config.userDatas = (void*)"ConfigWindowIconPath"; // Not strictly needed if using unique keys
                  ImGuiFileDialog::Instance()->OpenDialog(key, title, filters, config);
-                 std::cout << "Opening File Dialog: " << key << std::endl;
+                 Logger::Info("Opening File Dialog: {}", key);
 
             }
-            if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get("button_icon_tooltip").c_str()); }
+            if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get(TrKey::button_icon_tooltip).c_str()); }
         } // End Icon Path scope
 
+        // Row 6: Page
+        ImGui::TableNextRow();
+        ImGui::TableSetColumnIndex(0); ImGui::TextUnformatted(m_translator.get(TrKey::button_page_label).c_str());
+        ImGui::TableSetColumnIndex(1);
+        ImGui::PushItemWidth(-FLT_MIN); // Stretch
+        ImGui::InputText("##ButtonPage", m_newButtonPage, sizeof(m_newButtonPage));
+        ImGui::PopItemWidth();
+        if (ImGui::IsItemHovered()) { ImGui::SetTooltip("%s", m_translator.get(TrKey::button_page_tooltip).c_str()); }
+
 
         ImGui::EndTable();
     } // End Add/Edit Form Table
 
 
     // --- Action Buttons (Add/Save/Cancel) ---
-    const char* submitLabel = isEditing ? m_translator.get("save_changes_button_label").c_str() : m_translator.get("add_button_label").c_str();
+    const char* submitLabel = isEditing ? m_translator.get(TrKey::save_changes_button_label).c_str() : m_translator.get(TrKey::add_button_label).c_str();
     bool submitted = ImGui::Button(submitLabel);
 
     // Cancel button (only in edit mode)
     if (isEditing) {
         ImGui::SameLine();
-        if (ImGui::Button(m_translator.get("cancel_button_label").c_str())) {
+        if (ImGui::Button(m_translator.get(TrKey::cancel_button_label).c_str())) {
              // Clear fields and exit edit mode
              m_newButtonId[0] = '\0'; m_newButtonName[0] = '\0'; m_newButtonActionTypeIndex = -1;
-             m_newButtonActionParam[0] = '\0'; m_newButtonIconPath[0] = '\0';
+             m_newButtonActionParam[0] = '\0'; m_newButtonIconPath[0] = '\0'; m_newButtonPage[0] = '\0';
              std::string cancelledId = m_editingButtonId; // Store before clearing
              m_editingButtonId = ""; // Exit edit mode
              m_isCapturingHotkey = false; // Ensure capture is off
-             std::cout << "Edit cancelled for button ID: " << cancelledId << std::endl;
+             Logger::Info("Edit cancelled for button ID: {}", cancelledId);
              submitted = false; // Don't process submit if cancelled
         }
     }
@@ -329,10 +360,10 @@ void UIConfigurationWindow::Draw() {
         ButtonConfig buttonData;
         buttonData.name = m_newButtonName;
         if (m_newButtonActionTypeIndex >= 0 && m_newButtonActionTypeIndex < m_supportedActionTypes.size()) {
-             buttonData.action_type = m_supportedActionTypes[m_newButtonActionTypeIndex];
+             buttonData.action_type = m_supportedActionTypes[m_newButtonActionTypeIndex].type;
         } else {
             buttonData.action_type = ""; // Should not happen if index is validated/defaulted
-            std::cerr << "Error: Invalid action type index during submit." << std::endl;
+            Logger::Error("Invalid action type index during submit.");
         }
         buttonData.action_param = m_newButtonActionParam;
          // For media actions, ensure param is empty in the config
@@ -340,52 +371,47 @@ void UIConfigurationWindow::Draw() {
              buttonData.action_param = "";
          }
         buttonData.icon_path = m_newButtonIconPath;
+        buttonData.page = m_newButtonPage;
 
         bool configChanged = false;
-        bool saveSuccess = false;
 
         if (isEditing) {
             // --- Update Logic ---
             buttonData.id = m_editingButtonId; // ID is read-only, use stored one
             if (buttonData.name.empty()) {
-                std::cerr << "Error: Updated button name cannot be empty." << std::endl;
+                Logger::Error("Updated button name cannot be empty.");
                 // TODO: Show user feedback in UI?
             } else if (m_configManager.updateButton(m_editingButtonId, buttonData)) {
-                std::cout << "Button updated successfully: " << m_editingButtonId << std::endl;
+                Logger::Info("Button updated successfully: {}", m_editingButtonId);
                 configChanged = true;
             } else {
-                 std::cerr << "Error: Failed to update button " << m_editingButtonId << " (check console/ConfigManager logs)." << std::endl;
+                 Logger::Error("Failed to update button {} (check console/ConfigManager logs).", m_editingButtonId);
                  // TODO: Show user feedback in UI?
             }
         } else {
             // --- Add Logic ---
             buttonData.id = m_newButtonId;
             if (buttonData.id.empty() || buttonData.name.empty()) {
-                std::cerr << "Error: Cannot add button with empty ID or Name." << std::endl;
+                Logger::Error("Cannot add button with empty ID or Name.");
                 // TODO: Show user feedback in UI?
             } else if (m_configManager.addButton(buttonData)) {
-                std::cout << m_translator.get("button_added_success_log") << buttonData.id << std::endl;
+                Logger::Info("{}{}", m_translator.get(TrKey::button_added_success_log), buttonData.id);
                  configChanged = true;
             } else {
-                std::cerr << m_translator.get("add_button_fail_log") << " ID: " << buttonData.id << std::endl;
+                Logger::Error("{} ID: {}", m_translator.get(TrKey::add_button_fail_log), buttonData.id);
                 // TODO: Show user feedback in UI? Could be duplicate ID.
             }
         }
 
         if (configChanged) {
-             if (m_configManager.saveConfig()) {
-                 std::cout << "Configuration saved successfully." << std::endl;
-                 saveSuccess = true;
-             } else {
-                 std::cerr << "Error: Failed to save configuration after changes." << std::endl;
-                 // TODO: Show user feedback in UI?
-             }
+             m_configManager.scheduleSave(); // Written in the background; failures show below the button list
+             Logger::Info("Configuration save scheduled.");
         }
 
-        // If add/update and save were successful, clear the form and exit edit mode
-        if (configChanged && saveSuccess) {
+        // If add/update was successful, clear the form and exit edit mode
+        if (configChanged) {
              m_newButtonId[0] = '\0'; m_newButtonName[0] = '\0'; m_newButtonActionTypeIndex = -1;
-             m_newButtonActionParam[0] = '\0'; m_newButtonIconPath[0] = '\0';
+             m_newButtonActionParam[0] = '\0'; m_newButtonIconPath[0] = '\0'; m_newButtonPage[0] = '\0';
              m_editingButtonId = ""; // Exit edit mode if we were editing
              m_isCapturingHotkey = false; // Ensure capture is off
         }
@@ -394,37 +420,32 @@ void UIConfigurationWindow::Draw() {
 
     // --- Delete Confirmation Modal ---
     if (m_showDeleteConfirmation) {
-        ImGui::OpenPopup(m_translator.get("delete_confirm_title").c_str());
+        ImGui::OpenPopup(m_translator.get(TrKey::delete_confirm_title).c_str());
         m_showDeleteConfirmation = false; // Reset flag after opening
     }
 
-    if (ImGui::BeginPopupModal(m_translator.get("delete_confirm_title").c_str(), NULL, ImGuiWindowFlags_AlwaysAutoResize)) {
-        ImGui::TextUnformatted(m_translator.get("delete_confirm_text").c_str());
+    if (ImGui::BeginPopupModal(m_translator.get(TrKey::delete_confirm_title).c_str(), NULL, ImGuiWindowFlags_AlwaysAutoResize)) {
+        ImGui::TextUnformatted(m_translator.get(TrKey::delete_confirm_text).c_str());
         ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.6f, 1.0f), "%s", m_buttonIdToDelete.c_str());
         ImGui::Separator();
 
         bool deleted = false;
-        if (ImGui::Button(m_translator.get("delete_confirm_yes").c_str(), ImVec2(120, 0))) {
+        if (ImGui::Button(m_translator.get(TrKey::delete_confirm_yes).c_str(), ImVec2(120, 0))) {
             if (m_configManager.removeButton(m_buttonIdToDelete)) {
-                 std::cout << m_translator.get("button_removed_log") << m_buttonIdToDelete << std::endl;
-                 if (m_configManager.saveConfig()) {
-                     std::cout << m_translator.get("config_saved_delete_log") << std::endl;
-                     deleted = true; // Indicate success
-                 } else {
-                     std::cerr << m_translator.get("config_save_fail_delete_log") << std::endl;
-                     // Consider how to handle this - maybe revert the delete? For now, log error.
-                 }
+                 Logger::Info("{}{}", m_translator.get(TrKey::button_removed_log), m_buttonIdToDelete);
+                 m_configManager.scheduleSave();
+                 Logger::Info("{}", m_translator.get(TrKey::config_saved_delete_log));
+                 deleted = true; // Indicate success
             } else {
-                 std::cerr << m_translator.get("remove_button_fail_log") << m_buttonIdToDelete
-                           << m_translator.get("remove_button_fail_log_suffix") << std::endl;
+                 Logger::Error("{}{}{}", m_translator.get(TrKey::remove_button_fail_log), m_buttonIdToDelete, m_translator.get(TrKey::remove_button_fail_log_suffix));
             }
             m_buttonIdToDelete = ""; // Clear ID regardless of success for this popup
             ImGui::CloseCurrentPopup();
         }
         ImGui::SetItemDefaultFocus();
         ImGui::SameLine();
-        if (ImGui::Button(m_translator.get("delete_confirm_cancel").c_str(), ImVec2(120, 0))) {
-            std::cout << m_translator.get("delete_cancel_log") << m_buttonIdToDelete << std::endl;
+        if (ImGui::Button(m_translator.get(TrKey::delete_confirm_cancel).c_str(), ImVec2(120, 0))) {
+            Logger::Info("{}{}", m_translator.get(TrKey::delete_cancel_log), m_buttonIdToDelete);
             m_buttonIdToDelete = "";
             ImGui::CloseCurrentPopup();
         }
@@ -433,10 +454,10 @@ void UIConfigurationWindow::Draw() {
          // If deletion occurred AND we were editing the *same* button, cancel the edit.
          if (deleted && !m_editingButtonId.empty() && m_editingButtonId == m_buttonIdToDelete /* This check is redundant as m_buttonIdToDelete is cleared, but conceptually correct */ ) {
              m_newButtonId[0] = '\0'; m_newButtonName[0] = '\0'; m_newButtonActionTypeIndex = -1;
-             m_newButtonActionParam[0] = '\0'; m_newButtonIconPath[0] = '\0';
+             m_newButtonActionParam[0] = '\0'; m_newButtonIconPath[0] = '\0'; m_newButtonPage[0] = '\0';
              m_editingButtonId = "";
              m_isCapturingHotkey = false;
-             std::cout << "Cancelled edit mode because the button being edited was deleted." << std::endl;
+             Logger::Info("Cancelled edit mode because the button being edited was deleted.");
          }
 
     } // End Delete Modal
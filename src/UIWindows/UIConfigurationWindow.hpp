@@ -2,6 +2,7 @@
 
 #include <imgui.h>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map> // Although not directly used, ImGuiFileDialog might need it indirectly? Keep for safety or remove later.
 #include "../ConfigManager.hpp"
@@ -28,26 +29,35 @@ private:
     int m_newButtonActionTypeIndex = -1;
     char m_newButtonActionParam[256] = "";
     char m_newButtonIconPath[256] = "";
+    char m_newButtonPage[128] = "";
     std::string m_editingButtonId = "";
     bool m_isCapturingHotkey = false;
     bool m_manualHotkeyEntry = false;
     bool m_showDeleteConfirmation = false;
     std::string m_buttonIdToDelete = "";
 
-    // Supported action types, moved from UIManager
-    const std::vector<std::string> m_supportedActionTypes = {
-        "launch_app",
-        "open_url",
-        "hotkey",
-        "media_volume_up",
-        "media_volume_down",
-        "media_mute",
-        "media_play_pause",
-        "media_next_track",
-        "media_prev_track",
-        "media_stop"
+    // Supported action types, moved from UIManager, with the key of their display name
+    struct ActionTypeOption {
+        std::string type;
+        TrKey displayKey;
     };
+    const std::vector<ActionTypeOption> m_supportedActionTypes = {
+        {"launch_app", TrKey::action_type_launch_app_display},
+        {"open_url", TrKey::action_type_open_url_display},
+        {"hotkey", TrKey::action_type_hotkey_display},
+        {"open_folder", TrKey::action_type_open_folder_display},
+        {"media_volume_up", TrKey::action_type_media_volume_up_display},
+        {"media_volume_down", TrKey::action_type_media_volume_down_display},
+        {"media_mute", TrKey::action_type_media_mute_display},
+        {"media_play_pause", TrKey::action_type_media_play_pause_display},
+        {"media_next_track", TrKey::action_type_media_next_track_display},
+        {"media_prev_track", TrKey::action_type_media_prev_track_display},
+        {"media_stop", TrKey::action_type_media_stop_display}
+    };
+    std::vector<const char*> m_actionTypeDisplayItems; // Combo labels, refilled each frame without reallocating
 
     // Private helper methods if needed (e.g., for file dialog handling) could be added here
     void HandleFileDialog();
+    // Type of the action selected in the form; empty if none
+    std::string_view selectedActionType() const;
 };
\ No newline at end of file
@@ -1,10 +1,11 @@
 #include "UIQrCodeWindow.hpp"
-#include <iostream> // For std::cerr, std::cout
+#include "../Utils/Logger.hpp"
 #include <vector>   // For std::vector used in helper
+#include <charconv> // For std::to_chars
 
 
-UIQrCodeWindow::UIQrCodeWindow(TranslationManager& translationManager)
-    : m_translator(translationManager) {}
+UIQrCodeWindow::UIQrCodeWindow(TranslationManager& translationManager, FrameArena& frameArena)
+    : m_translator(translationManager), m_frameArena(frameArena) {}
 
 UIQrCodeWindow::~UIQrCodeWindow() {
     releaseQrTexture(); // Ensure texture is released on destruction
@@ -33,7 +34,7 @@ GLuint UIQrCodeWindow::qrCodeToTextureHelper(const qrcodegen::QrCode& qr) {
     GLuint textureID = 0;
     glGenTextures(1, &textureID);
      if (textureID == 0) {
-        std::cerr << "Error: Failed to generate texture ID (QRWindow)" << std::endl;
+        Logger::Error("Failed to generate texture ID (QRWindow)");
         return 0;
     }
     glBindTexture(GL_TEXTURE_2D, textureID);
@@ -47,20 +48,20 @@ GLuint UIQrCodeWindow::qrCodeToTextureHelper(const qrcodegen::QrCode& qr) {
 
 
 // Helper to generate/update QR Code texture (Now a private member)
-void UIQrCodeWindow::generateQrTexture(const std::string& text) {
+void UIQrCodeWindow::generateQrTexture(const char* text) {
     releaseQrTexture(); // Release existing texture first
     try {
-        qrcodegen::QrCode qr = qrcodegen::QrCode::encodeText(text.c_str(), qrcodegen::QrCode::Ecc::MEDIUM);
+        qrcodegen::QrCode qr = qrcodegen::QrCode::encodeText(text, qrcodegen::QrCode::Ecc::MEDIUM);
         m_qrTextureId = qrCodeToTextureHelper(qr); // Use the member helper
         if (m_qrTextureId != 0) {
             m_lastGeneratedQrText = text; // Store the text used for this texture
-            std::cout << "Generated QR Code texture for: " << text << " (ID: " << m_qrTextureId << ")" << std::endl;
+            Logger::Info("Generated QR Code texture for: {} (ID: {})", text, m_qrTextureId);
         } else {
              m_lastGeneratedQrText = ""; // Generation failed
-             std::cerr << "QR Code texture generation helper failed for: " << text << std::endl;
+             Logger::Error("QR Code texture generation helper failed for: {}", text);
          }
     } catch (const std::exception& e) {
-        std::cerr << "Error generating QR Code: " << e.what() << std::endl;
+        Logger::Error("Error generating QR Code: {}", e.what());
         m_qrTextureId = 0;
         m_lastGeneratedQrText = "";
     }
@@ -69,7 +70,7 @@ void UIQrCodeWindow::generateQrTexture(const std::string& text) {
 // Helper to release the QR Code texture (Now a private member)
 void UIQrCodeWindow::releaseQrTexture() {
     if (m_qrTextureId != 0) {
-        std::cout << "Deleting QR Code texture (ID: " << m_qrTextureId << ") for text: " << m_lastGeneratedQrText << std::endl;
+        Logger::Info("Deleting QR Code texture (ID: {}) for text: {}", m_qrTextureId, m_lastGeneratedQrText);
         glDeleteTextures(1, &m_qrTextureId);
         m_qrTextureId = 0;
         m_lastGeneratedQrText = "";
@@ -80,7 +81,7 @@ void UIQrCodeWindow::releaseQrTexture() {
 void UIQrCodeWindow::Draw(bool isServerRunning, int serverPort, const std::string& serverIP,
                           std::function<void()> refreshIpCallback)
 {
-    ImGui::Begin(m_translator.get("qr_code_window_title").c_str());
+    ImGui::Begin(m_translator.get(TrKey::qr_code_window_title).c_str());
 
     bool isIpValid = (serverIP.find("Error") == std::string::npos &&
                       serverIP.find("Fetching") == std::string::npos &&
@@ -88,34 +89,38 @@ void UIQrCodeWindow::Draw(bool isServerRunning, int serverPort, const std::strin
                       !serverIP.empty());
 
     if (isServerRunning && serverPort > 0 && isIpValid) {
-        std::string http_address = "http://" + serverIP + ":" + std::to_string(serverPort);
+        // Built in the frame arena: this runs every frame
+        char port[16];
+        char* portEnd = std::to_chars(port, port + sizeof(port), serverPort).ptr;
+        std::pmr::string http_address(&m_frameArena);
+        http_address.append("http://").append(serverIP).append(":").append(port, portEnd);
 
         // Regenerate texture only if the address has changed
-        if (http_address != m_lastGeneratedQrText) {
-            generateQrTexture(http_address);
+        if (std::string_view(http_address) != m_lastGeneratedQrText) {
+            generateQrTexture(http_address.c_str());
         }
 
-        ImGui::TextUnformatted(m_translator.get("scan_qr_code_prompt_1").c_str());
-        ImGui::TextUnformatted(m_translator.get("scan_qr_code_prompt_2").c_str());
+        ImGui::TextUnformatted(m_translator.get(TrKey::scan_qr_code_prompt_1).c_str());
+        ImGui::TextUnformatted(m_translator.get(TrKey::scan_qr_code_prompt_2).c_str());
 
         if (m_qrTextureId != 0) {
             ImGui::Image((ImTextureID)(intptr_t)m_qrTextureId, ImVec2(200, 200));
         } else {
-            ImGui::TextUnformatted(m_translator.get("qr_code_failed").c_str());
+            ImGui::TextUnformatted(m_translator.get(TrKey::qr_code_failed).c_str());
         }
 
-        ImGui::Text("%s %s", m_translator.get("open_in_browser_label").c_str(), http_address.c_str());
-        if (ImGui::Button(m_translator.get("copy_web_address_button").c_str())) {
+        ImGui::Text("%s %s", m_translator.get(TrKey::open_in_browser_label).c_str(), http_address.c_str());
+        if (ImGui::Button(m_translator.get(TrKey::copy_web_address_button).c_str())) {
              ImGui::SetClipboardText(http_address.c_str());
         }
 
     } else if (!isServerRunning) {
-        ImGui::TextUnformatted(m_translator.get("server_stopped_qr_prompt").c_str());
+        ImGui::TextUnformatted(m_translator.get(TrKey::server_stopped_qr_prompt).c_str());
         // Release texture if server stops
         if (m_qrTextureId != 0) { releaseQrTexture(); }
     } else { // Server running but IP invalid/fetching
-        ImGui::TextUnformatted(m_translator.get("waiting_for_ip_qr_prompt").c_str());
-        if (ImGui::Button(m_translator.get("retry_fetch_ip_button").c_str())) {
+        ImGui::TextUnformatted(m_translator.get(TrKey::waiting_for_ip_qr_prompt).c_str());
+        if (ImGui::Button(m_translator.get(TrKey::retry_fetch_ip_button).c_str())) {
             if (refreshIpCallback) {
                 refreshIpCallback();
             }
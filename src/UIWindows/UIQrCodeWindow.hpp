@@ -6,11 +6,12 @@
 #include <vector>     // For texture data
 #include <GL/glew.h>    // For GLuint, gl functions
 #include "../TranslationManager.hpp"
+#include "../Utils/FrameArena.hpp"
 #include <qrcodegen.hpp> // For QR code generation
 
 class UIQrCodeWindow {
 public:
-    UIQrCodeWindow(TranslationManager& translationManager);
+    UIQrCodeWindow(TranslationManager& translationManager, FrameArena& frameArena);
     ~UIQrCodeWindow();
 
     // Draw method takes server status, IP, port, and callbacks
@@ -19,13 +20,14 @@ public:
 
 private:
     TranslationManager& m_translator;
+    FrameArena& m_frameArena; // Per-frame temporaries
 
     // QR Code state moved from UIManager
     GLuint m_qrTextureId = 0;
     std::string m_lastGeneratedQrText = "";
 
     // Helper functions moved from UIManager (now private members)
-    void generateQrTexture(const std::string& text);
+    void generateQrTexture(const char* text);
     void releaseQrTexture();
     GLuint qrCodeToTextureHelper(const qrcodegen::QrCode& qr); // Made private member
 };
\ No newline at end of file
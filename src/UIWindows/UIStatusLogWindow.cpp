@@ -1,8 +1,8 @@
 #include "UIStatusLogWindow.hpp"
-#include <iostream> // For std::cout, std::cerr
+#include "../Utils/Logger.hpp"
 
-UIStatusLogWindow::UIStatusLogWindow(TranslationManager& translationManager)
-    : m_translator(translationManager) {
+UIStatusLogWindow::UIStatusLogWindow(TranslationManager& translationManager, FrameArena& frameArena)
+    : m_translator(translationManager), m_frameArena(frameArena) {
     // Initialize language index based on current translator language
     const auto& availableLangs = m_translator.getAvailableLanguages();
     const std::string& currentLang = m_translator.getCurrentLanguage();
@@ -19,13 +19,20 @@ UIStatusLogWindow::UIStatusLogWindow(TranslationManager& translationManager)
 }
 
 
-void UIStatusLogWindow::Draw(bool isServerRunning, int serverPort, const std::string& serverIP, std::function<void()> refreshIpCallback) {
-    ImGui::Begin(m_translator.get("status_log_window_title").c_str());
+void UIStatusLogWindow::Draw(bool isServerRunning, int serverPort, const std::string& serverIP,
+                             const RenderScheduler::Stats& renderStats, const TextureResidency::Stats& textureStats,
+                             std::function<void()> refreshIpCallback) {
+    bool visible = ImGui::Begin(m_translator.get(TrKey::status_log_window_title).c_str());
+    m_visible.store(visible, std::memory_order_relaxed);
+    if (!visible) { // Collapsed or a hidden tab; the log is copied again when it shows
+        ImGui::End();
+        return;
+    }
 
     // --- Server Status Display ---
-    ImGui::Text("%s %s", m_translator.get("server_status_label").c_str(),
-              isServerRunning ? m_translator.get("server_status_running").c_str()
-                                : m_translator.get("server_status_stopped").c_str());
+    ImGui::Text("%s %s", m_translator.get(TrKey::server_status_label).c_str(),
+              isServerRunning ? m_translator.get(TrKey::server_status_running).c_str()
+                                : m_translator.get(TrKey::server_status_stopped).c_str());
 
     // Check if IP is valid before displaying addresses
     bool isIpValid = (serverIP.find("Error") == std::string::npos &&
@@ -34,30 +41,38 @@ void UIStatusLogWindow::Draw(bool isServerRunning, int serverPort, const std::st
                       !serverIP.empty());
 
     if (isServerRunning && serverPort > 0 && isIpValid) {
-         ImGui::Text("%s http://%s:%d", m_translator.get("web_ui_address_label").c_str(), serverIP.c_str(), serverPort);
-         ImGui::Text("%s ws://%s:%d", m_translator.get("websocket_address_label").c_str(), serverIP.c_str(), serverPort);
+         ImGui::Text("%s http://%s:%d", m_translator.get(TrKey::web_ui_address_label).c_str(), serverIP.c_str(), serverPort);
+         ImGui::Text("%s ws://%s:%d", m_translator.get(TrKey::websocket_address_label).c_str(), serverIP.c_str(), serverPort);
     } else {
-        ImGui::Text("%s %s", m_translator.get("server_address_label").c_str(),
-                  m_translator.get("server_address_error").c_str());
+        ImGui::Text("%s %s", m_translator.get(TrKey::server_address_label).c_str(),
+                  m_translator.get(TrKey::server_address_error).c_str());
     }
 
     // Refresh IP Button - Use the callback provided by UIManager
-    if (ImGui::Button(m_translator.get("refresh_ip_button").c_str())) {
+    if (ImGui::Button(m_translator.get(TrKey::refresh_ip_button).c_str())) {
         if (refreshIpCallback) {
             refreshIpCallback();
         }
     }
+    // Render loop activity; near zero while nothing changes on screen
+    ImGui::Text("%s %.1f fps, %.1f%% CPU", m_translator.get(TrKey::render_stats_label).c_str(),
+                renderStats.framesPerSecond, renderStats.cpuPercent);
+    // Button icon textures (as allocated) against their budget
+    constexpr double MIB = 1024.0 * 1024.0;
+    ImGui::Text("%s %.1f / %.0f MB in %zu textures, %.1f%% hits, %llu evictions",
+                m_translator.get(TrKey::texture_stats_label).c_str(), textureStats.residentBytes / MIB,
+                textureStats.budgetBytes / MIB, textureStats.textures, textureStats.hitRate() * 100.0,
+                static_cast<unsigned long long>(textureStats.evictions));
     ImGui::Separator();
 
     // --- Logs Section ---
-    ImGui::TextUnformatted(m_translator.get("logs_header").c_str());
-    // TODO: Implement actual logging display here (needs access to a log buffer/system)
-    ImGui::TextWrapped("Log display area placeholder..."); // Placeholder
+    ImGui::TextUnformatted(m_translator.get(TrKey::logs_header).c_str());
+    DrawLogPanel();
     ImGui::Separator();
 
     // --- Language Selection ---
     const auto& availableLangs = m_translator.getAvailableLanguages();
-    std::vector<const char*> langItems;
+    std::pmr::vector<const char*> langItems(&m_frameArena);
     langItems.reserve(availableLangs.size()); // Pre-allocate memory
     for (const auto& lang : availableLangs) {
         langItems.push_back(lang.c_str());
@@ -77,10 +92,10 @@ void UIStatusLogWindow::Draw(bool isServerRunning, int serverPort, const std::st
         if (m_currentLangIndex >= 0 && m_currentLangIndex < static_cast<int>(availableLangs.size())) {
             const std::string& selectedLang = availableLangs[m_currentLangIndex];
             if (m_translator.setLanguage(selectedLang)) {
-                std::cout << "Language changed to: " << selectedLang << std::endl;
+                Logger::Info("Language changed to: {}", selectedLang);
                 // Potentially trigger font rebuild if necessary (though often handled elsewhere)
             } else {
-                 std::cerr << "Failed to set language to: " << selectedLang << std::endl;
+                 Logger::Error("Failed to set language to: {}", selectedLang);
                  // Revert index? Or maybe translator handles this internally?
                  // For now, just log the error. The index might be out of sync if setLanguage fails.
                  // Re-fetch the index after attempt might be safer:
@@ -97,4 +112,79 @@ void UIStatusLogWindow::Draw(bool isServerRunning, int serverPort, const std::st
     ImGui::PopItemWidth();
 
     ImGui::End();
+}
+
+void UIStatusLogWindow::DrawLogPanel() {
+    // Cheap when nothing was logged since the last frame: one atomic load, no copy
+    uint64_t sequence = Logger::CopyTail(m_logEntries, m_logSequence);
+    if (sequence != m_logSequence) {
+        m_logSequence = sequence;
+        m_visibleLogLinesDirty = true;
+    }
+
+    // The level combo sets what gets logged at all, so hidden levels cost nothing
+    static const char* levelNames[] = {"Debug", "Info", "Warn", "Error"};
+    int levelIndex = static_cast<int>(Logger::GetLevel());
+    ImGui::PushItemWidth(90);
+    if (ImGui::Combo(m_translator.get(TrKey::log_level_label).c_str(), &levelIndex, levelNames, IM_ARRAYSIZE(levelNames))) {
+        Logger::SetLevel(static_cast<Logger::Level>(levelIndex));
+        m_visibleLogLinesDirty = true;
+    }
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    if (m_logFilter.Draw(m_translator.get(TrKey::log_filter_label).c_str(), 200.0f)) {
+        m_visibleLogLinesDirty = true;
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox(m_translator.get(TrKey::log_auto_scroll).c_str(), &m_autoScroll);
+    ImGui::SameLine();
+    if (ImGui::Button(m_translator.get(TrKey::log_clear_button).c_str())) {
+        m_clearedSequence = m_logSequence;
+        m_visibleLogLinesDirty = true;
+    }
+
+    if (m_visibleLogLinesDirty) {
+        RebuildVisibleLogLines();
+    }
+
+    // Leave room for the separator and language selector below the log
+    float footerHeight = ImGui::GetStyle().ItemSpacing.y * 2 + ImGui::GetFrameHeightWithSpacing();
+    ImGui::BeginChild("##LogScrollRegion", ImVec2(0, -footerHeight), true, ImGuiWindowFlags_HorizontalScrollbar);
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4, 1));
+
+    // Only the rows that are on screen are submitted
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(m_visibleLogLines.size()));
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+            const Logger::Entry& entry = m_logEntries[m_visibleLogLines[row]];
+            ImVec4 color = ImGui::GetStyleColorVec4(ImGuiCol_Text);
+            if (entry.level == Logger::Level::Error) color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
+            else if (entry.level == Logger::Level::Warn) color = ImVec4(1.0f, 0.8f, 0.3f, 1.0f);
+            else if (entry.level == Logger::Level::Debug) color = ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled);
+            ImGui::PushStyleColor(ImGuiCol_Text, color);
+            ImGui::TextUnformatted(entry.text.data(), entry.text.data() + entry.text.size());
+            ImGui::PopStyleColor();
+        }
+    }
+    clipper.End();
+
+    ImGui::PopStyleVar();
+    // Follow new messages unless the user scrolled up
+    if (m_autoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
+        ImGui::SetScrollHereY(1.0f);
+    }
+    ImGui::EndChild();
+}
+
+void UIStatusLogWindow::RebuildVisibleLogLines() {
+    m_visibleLogLines.clear();
+    Logger::Level minLevel = Logger::GetLevel();
+    for (size_t i = 0; i < m_logEntries.size(); ++i) {
+        const Logger::Entry& entry = m_logEntries[i];
+        if (entry.sequence <= m_clearedSequence || entry.level < minLevel) continue;
+        if (!m_logFilter.PassFilter(entry.text.c_str(), entry.text.c_str() + entry.text.size())) continue;
+        m_visibleLogLines.push_back(static_cast<int>(i));
+    }
+    m_visibleLogLinesDirty = false;
 }
\ No newline at end of file
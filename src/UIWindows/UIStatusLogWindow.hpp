@@ -1,9 +1,14 @@
 #pragma once
 
 #include <imgui.h>
+#include <atomic>
 #include <string>
 #include <vector>
 #include "../TranslationManager.hpp"
+#include "../Utils/Logger.hpp"
+#include "../Utils/FrameArena.hpp"
+#include "../RenderScheduler.hpp"
+#include "../TextureResidency.hpp"
 
 // Forward declare UIManager to access updateLocalIP if needed, or pass necessary state/callbacks
 // class UIManager;
@@ -11,16 +16,36 @@
 class UIStatusLogWindow {
 public:
     // Constructor now takes TranslationManager
-    UIStatusLogWindow(TranslationManager& translationManager);
+    UIStatusLogWindow(TranslationManager& translationManager, FrameArena& frameArena);
     ~UIStatusLogWindow() = default;
 
     // Draw method now takes the necessary state as arguments
-    void Draw(bool isServerRunning, int serverPort, const std::string& serverIP, std::function<void()> refreshIpCallback);
+    void Draw(bool isServerRunning, int serverPort, const std::string& serverIP,
+              const RenderScheduler::Stats& renderStats, const TextureResidency::Stats& textureStats,
+              std::function<void()> refreshIpCallback);
+
+    // Whether the window was drawn in the last frame; read from the logger's thread
+    bool isVisible() const { return m_visible.load(std::memory_order_relaxed); }
 
 private:
     TranslationManager& m_translator;
+    FrameArena& m_frameArena; // Per-frame temporaries
     // UIManager& m_uiManager; // Removed, using callback instead
 
      // Language selection state remains here
     int m_currentLangIndex = -1; // Initialize properly
+
+    std::atomic<bool> m_visible{false};
+
+    // Log view state: a copy of Logger's tail, refreshed only when it changed
+    std::vector<Logger::Entry> m_logEntries;
+    uint64_t m_logSequence = 0;
+    uint64_t m_clearedSequence = 0;      // Entries up to this sequence are hidden ("Clear")
+    std::vector<int> m_visibleLogLines;  // Indices into m_logEntries passing the filters
+    bool m_visibleLogLinesDirty = true;
+    ImGuiTextFilter m_logFilter;
+    bool m_autoScroll = true;
+
+    void DrawLogPanel();
+    void RebuildVisibleLogLines();
 };
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "AllocationProfiler.hpp"
+
+#ifdef WEBSTREAMDECK_PROFILE_ALLOCATIONS
+
+#include "Logger.hpp"
+#include <imgui.h>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+    thread_local uint64_t t_allocations = 0;
+    thread_local uint64_t t_bytes = 0;
+
+    void* allocate(std::size_t size) {
+        ++t_allocations;
+        t_bytes += size;
+        if (size == 0) size = 1;
+        while (true) {
+            if (void* p = std::malloc(size)) return p;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) return nullptr;
+            handler();
+        }
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+        ++t_allocations;
+        t_bytes += size;
+        auto align = static_cast<std::size_t>(alignment);
+        size = std::max<std::size_t>((size + align - 1) / align * align, align);
+        while (true) {
+#ifdef _WIN32
+            if (void* p = _aligned_malloc(size, align)) return p;
+#else
+            if (void* p = std::aligned_alloc(align, size)) return p;
+#endif
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) return nullptr;
+            handler();
+        }
+    }
+
+    void freeAligned(void* p) {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    void* imguiAlloc(size_t size, void*) {
+        ++t_allocations;
+        t_bytes += size;
+        return std::malloc(size);
+    }
+
+    void imguiFree(void* p, void*) { std::free(p); }
+
+    // Stats of one Scope name. Only touched on the UI thread, and fixed-size so that
+    // recording never allocates itself.
+    struct Slot {
+        const char* name = nullptr;
+        AllocationProfiler::Counts frame;  // This frame so far
+        AllocationProfiler::Counts total;  // Since the last report
+        uint64_t peakAllocations = 0;      // Worst frame since the last report
+    };
+    constexpr size_t MAX_SLOTS = 16;
+    std::array<Slot, MAX_SLOTS> g_slots;
+    size_t g_slotCount = 0;
+    Slot g_frameSlot = [] { Slot slot; slot.name = "frame"; return slot; }(); // The whole frame
+    AllocationProfiler::Counts g_frameStart;
+    bool g_started = false; // The first EndFrame() only marks where frames begin
+    uint64_t g_framesSinceReport = 0;
+
+    void closeFrame(Slot& slot) {
+        slot.total.allocations += slot.frame.allocations;
+        slot.total.bytes += slot.frame.bytes;
+        slot.peakAllocations = std::max(slot.peakAllocations, slot.frame.allocations);
+        slot.frame = {};
+    }
+
+    void report(Slot& slot, uint64_t frames) {
+        Logger::Info("[Alloc] {}: {} allocs/frame, {} bytes/frame, peak {} allocs (last {} frames)", slot.name,
+                     double(slot.total.allocations) / frames, double(slot.total.bytes) / frames,
+                     slot.peakAllocations, frames);
+        slot.total = {};
+        slot.peakAllocations = 0;
+    }
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* p = allocateAligned(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (void* p = allocateAligned(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { freeAligned(p); }
+
+namespace AllocationProfiler {
+
+Counts ThreadCounts() {
+    return {t_allocations, t_bytes};
+}
+
+void InstallImGuiAllocator() {
+    ImGui::SetAllocatorFunctions(imguiAlloc, imguiFree, nullptr);
+}
+
+Scope::~Scope() {
+    Counts now = ThreadCounts();
+    Slot* slot = nullptr;
+    for (size_t i = 0; i < g_slotCount; ++i) {
+        if (g_slots[i].name == m_name || std::strcmp(g_slots[i].name, m_name) == 0) {
+            slot = &g_slots[i];
+            break;
+        }
+    }
+    if (!slot) {
+        if (g_slotCount == MAX_SLOTS) return;
+        slot = &g_slots[g_slotCount++];
+        slot->name = m_name;
+    }
+    slot->frame.allocations += now.allocations - m_start.allocations;
+    slot->frame.bytes += now.bytes - m_start.bytes;
+}
+
+void EndFrame() {
+    Counts now = ThreadCounts();
+    if (!g_started) {
+        // Everything before the first frame is startup
+        g_started = true;
+        for (size_t i = 0; i < g_slotCount; ++i) g_slots[i].frame = {};
+        g_frameStart = now;
+        return;
+    }
+    g_frameSlot.frame = {now.allocations - g_frameStart.allocations, now.bytes - g_frameStart.bytes};
+    closeFrame(g_frameSlot);
+    for (size_t i = 0; i < g_slotCount; ++i) {
+        closeFrame(g_slots[i]);
+    }
+
+    if (++g_framesSinceReport >= REPORT_INTERVAL) {
+        report(g_frameSlot, g_framesSinceReport);
+        for (size_t i = 0; i < g_slotCount; ++i) {
+            report(g_slots[i], g_framesSinceReport);
+        }
+        g_framesSinceReport = 0;
+    }
+    // Whatever reporting cost belongs to nobody's frame
+    g_frameStart = ThreadCounts();
+}
+
+} // namespace AllocationProfiler
+
+#endif // WEBSTREAMDECK_PROFILE_ALLOCATIONS
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+// Heap allocation counts per UI frame and per window. Only compiled in with
+// -DWEBSTREAMDECK_PROFILE_ALLOCATIONS=ON, which replaces the global operator new and
+// ImGui's allocator with counting versions; otherwise every call here is an empty inline.
+//
+// Counts are per thread, so the server, logger and action threads don't show up in
+// the UI numbers.
+namespace AllocationProfiler {
+
+    struct Counts {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+    };
+
+#ifdef WEBSTREAMDECK_PROFILE_ALLOCATIONS
+    inline constexpr bool Enabled = true;
+
+    // Running totals for the calling thread
+    Counts ThreadCounts();
+
+    // Route ImGui's allocations through the counters. Call before ImGui::CreateContext().
+    void InstallImGuiAllocator();
+
+    // Closes the current frame. Every REPORT_INTERVAL frames, logs the average and peak
+    // allocations per frame for the whole frame and for each Scope.
+    void EndFrame();
+    inline constexpr uint64_t REPORT_INTERVAL = 600;
+
+    // Attributes the allocations made during its lifetime to `name` (a string literal)
+    class Scope {
+    public:
+        explicit Scope(const char* name) : m_name(name), m_start(ThreadCounts()) {}
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;
+        Counts m_start;
+    };
+#else
+    inline constexpr bool Enabled = false;
+
+    inline Counts ThreadCounts() { return {}; }
+    inline void InstallImGuiAllocator() {}
+    inline void EndFrame() {}
+
+    class Scope {
+    public:
+        explicit Scope(const char*) {}
+    };
+#endif
+
+} // namespace AllocationProfiler
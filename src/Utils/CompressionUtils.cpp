@@ -0,0 +1,70 @@
+#include "CompressionUtils.hpp"
+#include <zlib.h>
+#include "Logger.hpp"
+
+#ifdef WEBSTREAMDECK_HAS_BROTLI
+#include <brotli/encode.h>
+#endif
+
+namespace CompressionUtils {
+
+std::optional<std::string> GzipCompress(std::string_view data) {
+    z_stream stream{};
+    // windowBits 15 + 16 selects the gzip wrapper instead of raw zlib
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+        Logger::Error("[Compression] deflateInit2 failed.");
+        return std::nullopt;
+    }
+
+    std::string output;
+    output.resize(deflateBound(&stream, static_cast<uLong>(data.size())));
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    int result = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        Logger::Error("[Compression] gzip deflate failed with code {}", result);
+        return std::nullopt;
+    }
+
+    output.resize(stream.total_out);
+    return output;
+}
+
+std::optional<std::string> BrotliCompress(std::string_view data) {
+#ifdef WEBSTREAMDECK_HAS_BROTLI
+    std::string output;
+    size_t encodedSize = BrotliEncoderMaxCompressedSize(data.size());
+    if (encodedSize == 0) {
+        return std::nullopt; // Input too large for a single-shot encode
+    }
+    output.resize(encodedSize);
+
+    if (!BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                               data.size(), reinterpret_cast<const uint8_t*>(data.data()),
+                               &encodedSize, reinterpret_cast<uint8_t*>(output.data()))) {
+        Logger::Error("[Compression] brotli encode failed.");
+        return std::nullopt;
+    }
+
+    output.resize(encodedSize);
+    return output;
+#else
+    (void)data;
+    return std::nullopt;
+#endif
+}
+
+bool IsBrotliAvailable() {
+#ifdef WEBSTREAMDECK_HAS_BROTLI
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace CompressionUtils
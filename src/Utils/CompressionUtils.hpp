@@ -0,0 +1,20 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace CompressionUtils {
+
+    // Compresses data into a gzip stream (RFC 1952) at the highest compression level.
+    // Returns std::nullopt if zlib reports an error.
+    std::optional<std::string> GzipCompress(std::string_view data);
+
+    // Compresses data with brotli at quality 11. Returns std::nullopt on failure or
+    // when the build has no brotli encoder available.
+    std::optional<std::string> BrotliCompress(std::string_view data);
+
+    // True if this build can produce brotli output.
+    bool IsBrotliAvailable();
+
+} // namespace CompressionUtils
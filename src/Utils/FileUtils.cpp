@@ -0,0 +1,267 @@
+#include "FileUtils.hpp"
+#include <algorithm>
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace FileUtils {
+
+bool ReadWholeFile(const fs::path& path, std::string& content, std::string& error) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        error = "cannot open file";
+        return false;
+    }
+    std::streamoff size = file.tellg();
+    if (size < 0) {
+        error = "cannot determine file size";
+        return false;
+    }
+    content.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    if (size > 0 && !file.read(content.data(), size)) {
+        error = "read failed"; // E.g. truncated while we were reading
+        return false;
+    }
+    return true;
+}
+
+#ifdef _WIN32
+
+namespace {
+    std::string lastErrorMessage(const char* what) {
+        return std::string(what) + " failed (error " + std::to_string(GetLastError()) + ")";
+    }
+}
+
+bool WriteFileAtomically(const fs::path& path, std::string_view data, std::string& error) {
+    fs::path tempPath = path;
+    tempPath += ".tmp";
+
+    HANDLE file = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = lastErrorMessage("CreateFile");
+        return false;
+    }
+    size_t offset = 0;
+    while (offset < data.size()) {
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(data.size() - offset, 1u << 30));
+        DWORD written = 0;
+        if (!WriteFile(file, data.data() + offset, chunk, &written, NULL)) {
+            error = lastErrorMessage("WriteFile");
+            CloseHandle(file);
+            DeleteFileW(tempPath.c_str());
+            return false;
+        }
+        offset += written;
+    }
+    if (!FlushFileBuffers(file)) {
+        error = lastErrorMessage("FlushFileBuffers");
+        CloseHandle(file);
+        DeleteFileW(tempPath.c_str());
+        return false;
+    }
+    CloseHandle(file);
+
+    if (!MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        error = lastErrorMessage("MoveFileEx");
+        DeleteFileW(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::open(const fs::path& path, std::string& error) {
+    close();
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = lastErrorMessage("CreateFile");
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        error = lastErrorMessage("GetFileSizeEx");
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0) { // Zero-length files can't be mapped
+        CloseHandle(file);
+        m_open = true;
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file); // The mapping keeps the file open
+    if (mapping == NULL) {
+        error = lastErrorMessage("CreateFileMapping");
+        return false;
+    }
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        error = lastErrorMessage("MapViewOfFile");
+        CloseHandle(mapping);
+        return false;
+    }
+    m_mapping = mapping;
+    m_data = data;
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_open = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(other.m_data), m_size(other.m_size), m_open(other.m_open), m_mapping(other.m_mapping) {
+    other.m_data = nullptr;
+    other.m_mapping = nullptr;
+    other.m_size = 0;
+    other.m_open = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_open, other.m_open);
+        std::swap(m_mapping, other.m_mapping);
+    }
+    return *this;
+}
+
+#else
+
+namespace {
+    std::string errnoMessage(const char* what) {
+        return std::string(what) + " failed: " + std::strerror(errno);
+    }
+}
+
+bool WriteFileAtomically(const fs::path& path, std::string_view data, std::string& error) {
+    fs::path tempPath = path;
+    tempPath += ".tmp";
+
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error = errnoMessage("open");
+        return false;
+    }
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t written = ::write(fd, data.data() + offset, data.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            error = errnoMessage("write");
+            ::close(fd);
+            ::unlink(tempPath.c_str());
+            return false;
+        }
+        offset += static_cast<size_t>(written);
+    }
+    if (::fsync(fd) != 0) {
+        error = errnoMessage("fsync");
+        ::close(fd);
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+    ::close(fd);
+
+    if (::rename(tempPath.c_str(), path.c_str()) != 0) {
+        error = errnoMessage("rename");
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+
+    // Make the rename itself durable
+    fs::path directory = path.has_parent_path() ? path.parent_path() : fs::path(".");
+    int dirFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
+
+bool MappedFile::open(const fs::path& path, std::string& error) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = errnoMessage("open");
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        error = errnoMessage("fstat");
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size == 0) { // Zero-length mappings are invalid
+        ::close(fd);
+        m_open = true;
+        return true;
+    }
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference to the file
+    if (data == MAP_FAILED) {
+        error = errnoMessage("mmap");
+        return false;
+    }
+    m_data = data;
+    m_size = size;
+    m_open = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) ::munmap(const_cast<void*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(other.m_data), m_size(other.m_size), m_open(other.m_open) {
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_open = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_open, other.m_open);
+    }
+    return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+} // namespace FileUtils
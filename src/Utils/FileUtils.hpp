@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace FileUtils {
+
+    // Reads the whole file into `content` with a single sized read. Returns false and
+    // fills `error` if it can't be opened or read.
+    bool ReadWholeFile(const std::filesystem::path& path, std::string& content, std::string& error);
+
+    // Replaces `path` with `data` so that readers (and a crash at any point) see either
+    // the old file or the complete new one: writes "<path>.tmp", flushes it to disk and
+    // renames it over `path`. Returns false and fills `error` on failure; the original
+    // file is left untouched in that case.
+    bool WriteFileAtomically(const std::filesystem::path& path, std::string_view data, std::string& error);
+
+    // Read-only memory mapping of a whole file. The contents stay valid until the object
+    // is destroyed, even if the file is replaced (atomically) in the meantime.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // Returns false and fills `error` if the file can't be opened or mapped.
+        // An empty file maps successfully to an empty view.
+        bool open(const std::filesystem::path& path, std::string& error);
+        void close();
+
+        bool isOpen() const { return m_open; }
+        std::string_view view() const { return {static_cast<const char*>(m_data), m_size}; }
+        size_t size() const { return m_size; }
+
+    private:
+        const void* m_data = nullptr;
+        size_t m_size = 0;
+        bool m_open = false;
+#ifdef _WIN32
+        void* m_mapping = nullptr; // HANDLE of the file mapping object
+#endif
+    };
+
+} // namespace FileUtils
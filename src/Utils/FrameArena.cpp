@@ -0,0 +1,39 @@
+#include "FrameArena.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+
+FrameArena::FrameArena(size_t initialCapacity)
+    : m_buffer(std::make_unique<std::byte[]>(initialCapacity)), m_capacity(initialCapacity)
+{
+}
+
+void FrameArena::reset()
+{
+    size_t frameBytes = used();
+    m_highWater = std::max(m_highWater, frameBytes);
+    if (m_overflowBytes > 0) {
+        // Room for the frame that just overflowed plus some slack (alignment padding
+        // is not included in used())
+        size_t newCapacity = std::max(m_capacity * 2, frameBytes + frameBytes / 2);
+        Logger::Debug("[FrameArena] Frame needed {} bytes; growing from {} to {} bytes", frameBytes, m_capacity,
+                      newCapacity);
+        m_overflow.release();
+        m_overflowBytes = 0;
+        m_buffer.reset(); // Release before allocating so the two buffers don't coexist
+        m_buffer = std::make_unique<std::byte[]>(newCapacity);
+        m_capacity = newCapacity;
+    }
+    m_used = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    void* position = m_buffer.get() + m_used;
+    size_t space = m_capacity - m_used;
+    if (std::align(alignment, bytes, position, space)) {
+        m_used = m_capacity - space + bytes;
+        return position;
+    }
+    m_overflowBytes += bytes;
+    return m_overflow.allocate(bytes, alignment);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+// Monotonic allocator for temporaries that live for one UI frame:
+//
+//   std::pmr::vector<const char*> items(&frameArena);
+//
+// Allocations bump a pointer through one buffer and deallocation does nothing; reset()
+// at the start of each frame makes the whole buffer available again. A frame that
+// needs more than the buffer holds gets the rest from the heap, and the next reset()
+// grows the buffer to that frame's size, so steady state makes no heap allocations.
+// Not thread-safe: one arena per thread (the UI thread).
+class FrameArena : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(size_t initialCapacity = 64 * 1024);
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Frees everything allocated since the previous reset
+    void reset();
+
+    size_t capacity() const { return m_capacity; }
+    size_t used() const { return m_used + m_overflowBytes; } // Bytes handed out this frame
+    size_t highWater() const { return m_highWater; }         // Largest used() of any frame
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {} // Freed by reset()
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::unique_ptr<std::byte[]> m_buffer;
+    size_t m_capacity = 0;
+    size_t m_used = 0;
+    size_t m_highWater = 0;
+    // What didn't fit this frame; released by reset()
+    std::pmr::monotonic_buffer_resource m_overflow{std::pmr::new_delete_resource()};
+    size_t m_overflowBytes = 0;
+};
@@ -0,0 +1,93 @@
+#include "GifCompositor.hpp"
+#include "PaletteExpand.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    GifDirtyRect unite(const GifDirtyRect& a, const GifDirtyRect& b) {
+        if (a.empty()) return b;
+        if (b.empty()) return a;
+        int left = std::min(a.x, b.x);
+        int top = std::min(a.y, b.y);
+        int right = std::max(a.x + a.width, b.x + b.width);
+        int bottom = std::max(a.y + a.height, b.y + b.height);
+        return {left, top, right - left, bottom - top};
+    }
+} // namespace
+
+GifCompositor::GifCompositor(int width, int height)
+    : m_width(std::max(width, 0)), m_height(std::max(height, 0)),
+      m_canvas(static_cast<size_t>(m_width) * m_height * 4, 0)
+{
+}
+
+GifDirtyRect GifCompositor::reset()
+{
+    std::fill(m_canvas.begin(), m_canvas.end(), uint8_t(0));
+    m_pendingRect = {};
+    m_pendingDisposal = GifDisposal::None;
+    return {0, 0, m_width, m_height};
+}
+
+GifDirtyRect GifCompositor::clip(int left, int top, int width, int height) const
+{
+    int x0 = std::clamp(left, 0, m_width);
+    int y0 = std::clamp(top, 0, m_height);
+    int x1 = std::clamp(left + width, 0, m_width);
+    int y1 = std::clamp(top + height, 0, m_height);
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+void GifCompositor::copyRect(const std::vector<uint8_t>& from, std::vector<uint8_t>& to, const GifDirtyRect& rect) const
+{
+    size_t rowBytes = static_cast<size_t>(rect.width) * 4;
+    for (int y = rect.y; y < rect.y + rect.height; ++y) {
+        size_t offset = (static_cast<size_t>(y) * m_width + rect.x) * 4;
+        std::memcpy(to.data() + offset, from.data() + offset, rowBytes);
+    }
+}
+
+GifDirtyRect GifCompositor::apply(const GifFrame& frame)
+{
+    // The previous frame's disposal
+    GifDirtyRect dirty;
+    if (!m_pendingRect.empty()) {
+        if (m_pendingDisposal == GifDisposal::Background) {
+            size_t rowBytes = static_cast<size_t>(m_pendingRect.width) * 4;
+            for (int y = m_pendingRect.y; y < m_pendingRect.y + m_pendingRect.height; ++y) {
+                std::memset(m_canvas.data() + (static_cast<size_t>(y) * m_width + m_pendingRect.x) * 4, 0, rowBytes);
+            }
+            dirty = m_pendingRect;
+        } else if (m_pendingDisposal == GifDisposal::Previous) {
+            copyRect(m_saved, m_canvas, m_pendingRect);
+            dirty = m_pendingRect;
+        }
+    }
+
+    GifDirtyRect area = clip(frame.left, frame.top, frame.width, frame.height);
+    m_pendingRect = area;
+    m_pendingDisposal = frame.disposal;
+    if (area.empty() || frame.indices.size() < static_cast<size_t>(frame.width) * frame.height) {
+        return dirty;
+    }
+    if (frame.disposal == GifDisposal::Previous) {
+        if (m_saved.size() != m_canvas.size()) m_saved.resize(m_canvas.size());
+        copyRect(m_canvas, m_saved, area);
+    }
+
+    // Bake the palette once per frame: indices that draw nothing (transparent or outside the
+    // palette) get alpha 0 and keep the canvas pixel, so the row kernel needs no checks
+    std::array<uint32_t, 256> baked{};
+    const uint8_t opaqueAlpha[4] = {0, 0, 0, 255};
+    uint32_t alphaBits;
+    std::memcpy(&alphaBits, opaqueAlpha, 4);
+    for (int i = 0; i < std::min(frame.colorCount, 256); ++i) baked[i] = frame.palette[i] | alphaBits;
+    if (frame.transparentIndex >= 0 && frame.transparentIndex < 256) baked[frame.transparentIndex] = 0;
+
+    for (int y = area.y; y < area.y + area.height; ++y) {
+        const uint8_t* src = frame.indices.data() + static_cast<size_t>(y - frame.top) * frame.width + (area.x - frame.left);
+        uint8_t* dst = m_canvas.data() + (static_cast<size_t>(y) * m_width + area.x) * 4;
+        PaletteExpand::expandRow(src, static_cast<size_t>(area.width), baked.data(), dst);
+    }
+    return unite(dirty, area);
+}
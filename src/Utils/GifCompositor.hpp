@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Disposal method of a GIF frame (GIF89a graphic control extension; same values as giflib's)
+enum class GifDisposal : int {
+    Unspecified = 0, // Treated like None
+    None = 1,        // Leave the frame on the canvas
+    Background = 2,  // Clear the frame's area to transparent before the next frame
+    Previous = 3     // Restore the frame's area to what it was before the frame was drawn
+};
+
+// One frame as stored in the file: palette indices for a sub-rectangle of the canvas
+struct GifFrame {
+    int left = 0;
+    int top = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> indices;       // width * height, rows top to bottom (already deinterlaced)
+    std::array<uint32_t, 256> palette{}; // RGBA8 as stored in memory (R, G, B, A bytes); drawn opaque
+    int colorCount = 0;                  // Indices at or above this are ignored, like transparent ones
+    int transparentIndex = -1;
+    GifDisposal disposal = GifDisposal::Unspecified;
+    int delayMs = 100;
+};
+
+// Part of the canvas changed by GifCompositor::apply(), in pixels
+struct GifDirtyRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    bool empty() const { return width <= 0 || height <= 0; }
+};
+
+// Draws GIF frames onto an RGBA canvas one at a time, following the disposal method of
+// the previous frame, and reports which rectangle changed so only that needs uploading.
+// Transparent pixels leave the canvas as it is. Pure CPU; no GL or giflib.
+class GifCompositor {
+public:
+    GifCompositor(int width, int height);
+
+    // Disposes of the previous frame, then draws `frame`. Returns the union of the area the
+    // disposal touched and the frame's rectangle, clipped to the canvas.
+    GifDirtyRect apply(const GifFrame& frame);
+    // Back to a fully transparent canvas before the first frame (when the animation loops).
+    // The whole canvas counts as changed.
+    GifDirtyRect reset();
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    const std::vector<uint8_t>& canvas() const { return m_canvas; } // RGBA rows, width * 4 bytes each
+
+private:
+    GifDirtyRect clip(int left, int top, int width, int height) const;
+    void copyRect(const std::vector<uint8_t>& from, std::vector<uint8_t>& to, const GifDirtyRect& rect) const;
+
+    int m_width;
+    int m_height;
+    std::vector<uint8_t> m_canvas;
+    std::vector<uint8_t> m_saved;   // Canvas under the previous frame, for GifDisposal::Previous
+    GifDirtyRect m_pendingRect;     // Previous frame's area (clipped)
+    GifDisposal m_pendingDisposal = GifDisposal::None;
+};
@@ -1,140 +1,279 @@
 #include "GifLoader.hpp"
-#include <iostream>
+#include "Logger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <vector>
+#include <gif_lib.h> // Include giflib header
 #include <GL/glew.h> // Include GLEW for OpenGL functions
 
 namespace GifLoader {
 
-// Helper function to convert GifColorType to RGBA
-void GifColorToRGBA(const GifColorType& gifColor, unsigned char* rgba, unsigned char alpha = 255) {
-    rgba[0] = gifColor.Red;
-    rgba[1] = gifColor.Green;
-    rgba[2] = gifColor.Blue;
-    rgba[3] = alpha;
-}
+struct GifStream {
+    std::string name;
+    std::vector<GifByteType> data; // The whole file, still compressed
+    size_t offset = 0;             // Read position of the giflib handle in `data`
+    GifFileType* file = nullptr;
+    GifFrame frame;                // Reused for every frame
+    GifCompositor compositor{0, 0};
 
-bool LoadAnimatedGifFromFile(const char* filename, AnimatedGif& gifData) {
-    int error = 0;
-    GifFileType* gifFile = DGifOpenFileName(filename, &error);
-    if (!gifFile) {
-        std::cerr << "Error opening GIF file " << filename << ": " << GifErrorString(error) << std::endl;
-        return false;
-    }
+    ~GifStream() { close(); }
 
-    // Slurp the GIF into memory
-    if (DGifSlurp(gifFile) != GIF_OK) {
-        std::cerr << "Error reading GIF file " << filename << ": " << GifErrorString(gifFile->Error) << std::endl;
-        DGifCloseFile(gifFile, &error);
-        return false;
+    void close() {
+        if (file) {
+            int error = 0;
+            DGifCloseFile(file, &error);
+            file = nullptr;
+        }
     }
+};
 
-    if (gifFile->ImageCount <= 0) {
-        std::cerr << "Error: GIF file " << filename << " contains no images." << std::endl;
-        DGifCloseFile(gifFile, &error);
-        return false;
+namespace { // Anonymous namespace for internal linkage
+
+    int readFromMemory(GifFileType* file, GifByteType* buffer, int length) {
+        auto* stream = static_cast<GifStream*>(file->UserData);
+        size_t count = std::min(static_cast<size_t>(std::max(length, 0)), stream->data.size() - stream->offset);
+        std::memcpy(buffer, stream->data.data() + stream->offset, count);
+        stream->offset += count;
+        return static_cast<int>(count);
     }
 
-    gifData.width = gifFile->SWidth;
-    gifData.height = gifFile->SHeight;
-    gifData.frameTextureIds.resize(gifFile->ImageCount);
-    gifData.frameDelaysMs.resize(gifFile->ImageCount);
-
-    // Buffer to hold the fully composited frame (RGBA)
-    std::vector<unsigned char> canvas(gifData.width * gifData.height * 4, 0);
-    // Buffer to hold the *previous* frame's canvas state for disposal methods (optional, simple first)
-    // std::vector<unsigned char> previousCanvas(gifData.width * gifData.height * 4, 0);
-    int transparentColorIndex = -1; // Track transparency
-
-    for (int i = 0; i < gifFile->ImageCount; ++i) {
-        SavedImage* frame = &gifFile->SavedImages[i];
-        const GifImageDesc& desc = frame->ImageDesc;
-        ColorMapObject* colorMap = desc.ColorMap ? desc.ColorMap : gifFile->SColorMap;
-
-        if (!colorMap) {
-            std::cerr << "Error: GIF frame " << i << " in " << filename << " has no color map." << std::endl;
-            // Clean up already created textures before returning
-            for(int j = 0; j < i; ++j) glDeleteTextures(1, &gifData.frameTextureIds[j]);
-            DGifCloseFile(gifFile, &error);
+    // (Re)opens the giflib handle at the start of the file
+    bool rewind(GifStream& stream) {
+        stream.close();
+        stream.offset = 0;
+        int error = 0;
+        stream.file = DGifOpen(&stream, readFromMemory, &error);
+        if (!stream.file) {
+            Logger::Error("Error opening GIF file {}: {}", stream.name, GifErrorString(error));
             return false;
         }
+        return true;
+    }
 
-        // --- Get Delay and Transparency --- 
+    enum class ReadResult { Frame, End, Error };
+
+    // Reads records up to and including the next image. With `frame` == nullptr the image
+    // data is skipped without decompressing it (for counting frames).
+    ReadResult readFrame(GifStream& stream, GifFrame* frame) {
+        GifFileType* file = stream.file;
         int delay = 100; // Default delay 100ms (10 * 1/100s)
-        transparentColorIndex = -1; // Reset transparency for each frame
+        int transparentColorIndex = -1;
         int disposalMode = DISPOSAL_UNSPECIFIED;
-        for (int j = 0; j < frame->ExtensionBlockCount; ++j) {
-            ExtensionBlock* eb = &frame->ExtensionBlocks[j];
-            if (eb->Function == GRAPHICS_EXT_FUNC_CODE) {
-                GraphicsControlBlock gcb;
-                if (DGifExtensionToGCB(eb->ByteCount, eb->Bytes, &gcb) == GIF_OK) {
-                    delay = gcb.DelayTime * 10; // Delay is in 1/100ths of a second
-                    if (delay <= 0) delay = 100; // Use default if delay is missing or too short
-                    transparentColorIndex = gcb.TransparentColor; // -1 if not transparent
-                    disposalMode = gcb.DisposalMode;
-                } else {
-                    std::cerr << "Warning: Failed to parse GCB for frame " << i << " in " << filename << std::endl;
+
+        while (true) {
+            GifRecordType recordType;
+            if (DGifGetRecordType(file, &recordType) != GIF_OK) {
+                Logger::Error("Error reading GIF file {}: {}", stream.name, GifErrorString(file->Error));
+                return ReadResult::Error;
+            }
+
+            if (recordType == TERMINATE_RECORD_TYPE) return ReadResult::End;
+
+            if (recordType == EXTENSION_RECORD_TYPE) {
+                int code = 0;
+                GifByteType* extension = nullptr;
+                if (DGifGetExtension(file, &code, &extension) != GIF_OK) return ReadResult::Error;
+                if (code == GRAPHICS_EXT_FUNC_CODE && extension) {
+                    GraphicsControlBlock gcb;
+                    if (DGifExtensionToGCB(extension[0], extension + 1, &gcb) == GIF_OK) {
+                        delay = gcb.DelayTime * 10; // Delay is in 1/100ths of a second
+                        if (delay <= 0) delay = 100; // Use default if delay is missing or too short
+                        transparentColorIndex = gcb.TransparentColor; // -1 if not transparent
+                        disposalMode = gcb.DisposalMode;
+                    } else {
+                        Logger::Warn("Failed to parse GCB in {}", stream.name);
+                    }
                 }
-                break; // Only care about the first GCB
+                while (extension) {
+                    if (DGifGetExtensionNext(file, &extension) != GIF_OK) return ReadResult::Error;
+                }
+                continue;
             }
-        }
-        gifData.frameDelaysMs[i] = delay;
-
-        // --- Simple Compositing (Draw frame onto canvas) ---
-        // TODO: Implement proper disposal methods if needed.
-        // For now, we just draw the current frame over the previous canvas state.
-        // If disposalMode == DISPOSE_BACKGROUND, we should clear the frame's area on the *canvas* first.
-        // If disposalMode == DISPOSE_PREVIOUS, we'd need to restore from 'previousCanvas'.
-
-        for (int y = 0; y < desc.Height; ++y) {
-            for (int x = 0; x < desc.Width; ++x) {
-                int gifIndex = y * desc.Width + x;
-                int colorIndex = frame->RasterBits[gifIndex];
-
-                // Check bounds and color index validity
-                if (colorIndex < 0 || colorIndex >= colorMap->ColorCount) {
-                    // Invalid color index, treat as transparent or skip
-                    continue; 
+
+            if (recordType != IMAGE_DESC_RECORD_TYPE) continue;
+
+            if (DGifGetImageDesc(file) != GIF_OK) {
+                Logger::Error("Error reading GIF file {}: {}", stream.name, GifErrorString(file->Error));
+                return ReadResult::Error;
+            }
+            const GifImageDesc& desc = file->Image;
+
+            if (!frame) {
+                int codeSize = 0;
+                GifByteType* block = nullptr;
+                if (DGifGetCode(file, &codeSize, &block) != GIF_OK) return ReadResult::Error;
+                while (block) {
+                    if (DGifGetCodeNext(file, &block) != GIF_OK) return ReadResult::Error;
                 }
+                return ReadResult::Frame;
+            }
 
-                // Handle transparency
-                bool isTransparent = (transparentColorIndex != -1 && colorIndex == transparentColorIndex);
-                
-                // Calculate position on the full canvas
-                int canvasX = desc.Left + x;
-                int canvasY = desc.Top + y;
-
-                // Check canvas bounds
-                if (canvasX >= 0 && canvasX < gifData.width && canvasY >= 0 && canvasY < gifData.height) {
-                    int canvasIndex = (canvasY * gifData.width + canvasX) * 4;
-                    const GifColorType& gifColor = colorMap->Colors[colorIndex];
-                    GifColorToRGBA(gifColor, &canvas[canvasIndex], isTransparent ? 0 : 255);
+            ColorMapObject* colorMap = desc.ColorMap ? desc.ColorMap : file->SColorMap;
+            if (!colorMap) {
+                Logger::Error("GIF frame in {} has no color map.", stream.name);
+                return ReadResult::Error;
+            }
+
+            frame->left = desc.Left;
+            frame->top = desc.Top;
+            frame->width = desc.Width;
+            frame->height = desc.Height;
+            frame->delayMs = delay;
+            frame->transparentIndex = transparentColorIndex;
+            frame->disposal = static_cast<GifDisposal>(std::clamp(disposalMode, 0, 3));
+            frame->colorCount = std::min(colorMap->ColorCount, 256);
+            for (int i = 0; i < frame->colorCount; ++i) {
+                const GifColorType& color = colorMap->Colors[i];
+                uint8_t rgba[4] = {color.Red, color.Green, color.Blue, 255};
+                std::memcpy(&frame->palette[i], rgba, 4);
+            }
+
+            frame->indices.resize(static_cast<size_t>(desc.Width) * desc.Height);
+            // Interlaced images store every 8th row, then the 4th, 2nd and the remaining ones
+            const int interlacedOffsets[] = {0, 4, 2, 1};
+            const int interlacedSteps[] = {8, 8, 4, 2};
+            int passes = desc.Interlace ? 4 : 1;
+            for (int pass = 0; pass < passes; ++pass) {
+                int first = desc.Interlace ? interlacedOffsets[pass] : 0;
+                int step = desc.Interlace ? interlacedSteps[pass] : 1;
+                for (int y = first; y < desc.Height; y += step) {
+                    GifPixelType* row = frame->indices.data() + static_cast<size_t>(y) * desc.Width;
+                    if (DGifGetLine(file, row, desc.Width) != GIF_OK) {
+                        Logger::Error("Error decoding GIF frame in {}: {}", stream.name, GifErrorString(file->Error));
+                        return ReadResult::Error;
+                    }
                 }
             }
+            return ReadResult::Frame;
         }
+    }
 
-        // --- Create OpenGL Texture for the composited frame --- 
-        glGenTextures(1, &gifData.frameTextureIds[i]);
-        glBindTexture(GL_TEXTURE_2D, gifData.frameTextureIds[i]);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // Use NEAREST for pixel art often
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    // Uploads part of the canvas into the texture
+    void uploadRect(const AnimatedGif& gifData, const GifDirtyRect& rect) {
+        if (rect.empty()) return;
+        const std::vector<uint8_t>& canvas = gifData.stream->compositor.canvas();
+        glBindTexture(GL_TEXTURE_2D, gifData.textureId);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Ensure correct byte alignment
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, gifData.width, gifData.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, canvas.data());
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, gifData.width);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x, rect.y, rect.width, rect.height, GL_RGBA, GL_UNSIGNED_BYTE,
+                        canvas.data() + (static_cast<size_t>(rect.y) * gifData.width + rect.x) * 4);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
         glBindTexture(GL_TEXTURE_2D, 0); // Unbind
+    }
+
+} // namespace
 
-        // Optional: Store current canvas state for DISPOSE_PREVIOUS if implemented later
-        // previousCanvas = canvas;
+bool OpenAnimatedGif(const char* filename, AnimatedGif& gifData) {
+    auto stream = std::make_shared<GifStream>();
+    stream->name = filename;
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        Logger::Error("Error opening GIF file {}: cannot read the file", filename);
+        return false;
+    }
+    stream->data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (!rewind(*stream)) return false;
+
+    int width = stream->file->SWidth;
+    int height = stream->file->SHeight;
+    if (width <= 0 || height <= 0) {
+        Logger::Error("GIF file {} has an empty canvas.", filename);
+        return false;
+    }
+
+    // Count the frames without decompressing them
+    int frameCount = 0;
+    ReadResult result;
+    while ((result = readFrame(*stream, nullptr)) == ReadResult::Frame) ++frameCount;
+    if (result == ReadResult::Error) return false;
+    if (frameCount == 0) {
+        Logger::Error("GIF file {} contains no images.", filename);
+        return false;
+    }
+
+    // First frame onto the canvas
+    if (!rewind(*stream)) return false;
+    stream->compositor = GifCompositor(width, height);
+    if (readFrame(*stream, &stream->frame) != ReadResult::Frame) return false;
+    stream->compositor.apply(stream->frame);
+
+    gifData.width = width;
+    gifData.height = height;
+    gifData.frameCount = frameCount;
+    gifData.animated = frameCount > 1;
+    gifData.currentDelayMs = stream->frame.delayMs;
+    gifData.stream = std::move(stream);
+    if (!gifData.animated) gifData.stream->close(); // Nothing more to decode
+    Logger::Info("Opened GIF: {} ({} frames, {} bytes)", filename, frameCount, gifData.stream->data.size());
+    return true;
+}
+
+bool UploadAnimatedGif(AnimatedGif& gifData) {
+    if (!gifData.stream) return false;
+    glGenTextures(1, &gifData.textureId);
+    if (gifData.textureId == 0) {
+        Logger::Error("Failed to generate texture ID for {}", gifData.stream->name);
+        return false;
     }
+    glBindTexture(GL_TEXTURE_2D, gifData.textureId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // Use NEAREST for pixel art often
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Ensure correct byte alignment
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, gifData.width, gifData.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 gifData.stream->compositor.canvas().data());
+    glBindTexture(GL_TEXTURE_2D, 0); // Unbind
 
-    DGifCloseFile(gifFile, &error);
     gifData.loaded = true;
-    gifData.currentFrame = 0;
     gifData.lastFrameTime = 0.0; // Initialize timing
+    if (!gifData.animated) {
+        gifData.stream.reset(); // The texture is all a still image needs
+    }
+    return true;
+}
+
+bool AdvanceAnimatedGif(AnimatedGif& gifData) {
+    if (!gifData.loaded || !gifData.animated || !gifData.stream) return false;
+    GifStream& stream = *gifData.stream;
 
-    std::cout << "Successfully loaded GIF: " << filename << " (" << gifFile->ImageCount << " frames)" << std::endl;
+    GifDirtyRect restarted;
+    ReadResult result = readFrame(stream, &stream.frame);
+    if (result == ReadResult::End) {
+        // Loop: start over from an empty canvas
+        if (rewind(stream)) {
+            restarted = stream.compositor.reset();
+            result = readFrame(stream, &stream.frame);
+        } else {
+            result = ReadResult::Error;
+        }
+    }
+    if (result != ReadResult::Frame) {
+        Logger::Error("Stopping GIF animation of {} after a decode error", stream.name);
+        gifData.animated = false;
+        gifData.stream.reset();
+        return false;
+    }
 
+    GifDirtyRect dirty = stream.compositor.apply(stream.frame);
+    uploadRect(gifData, restarted.empty() ? dirty : restarted);
+    gifData.currentDelayMs = stream.frame.delayMs;
     return true;
 }
 
+void ReleaseAnimatedGif(AnimatedGif& gifData) {
+    if (gifData.textureId != 0) {
+        glDeleteTextures(1, &gifData.textureId);
+        gifData.textureId = 0;
+    }
+    gifData.stream.reset();
+    gifData.loaded = false;
+}
+
+bool LoadAnimatedGifFromFile(const char* filename, AnimatedGif& gifData) {
+    return OpenAnimatedGif(filename, gifData) && UploadAnimatedGif(gifData);
+}
+
 } // namespace GifLoader
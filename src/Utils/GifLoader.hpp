@@ -1,8 +1,8 @@
 #pragma once
 
-#include <vector>
+#include <memory>
 #include <string>
-#include <gif_lib.h> // Include giflib header
+#include "GifCompositor.hpp"
 
 // Forward declare or include GLuint definition
 // Assuming GLEW is included elsewhere (e.g., main.cpp)
@@ -13,28 +13,48 @@
 
 namespace GifLoader {
 
+// Decoder state of a playing GIF (giflib handle, compressed file, canvas); defined in GifLoader.cpp
+struct GifStream;
+
+// A GIF being played. Frames are decoded one at a time when they are due and drawn onto a
+// single canvas texture; only the rectangle a frame changes is uploaded. Memory is the
+// compressed file plus one or two canvases, whatever the number of frames.
 struct AnimatedGif {
-    std::vector<GLuint> frameTextureIds;
-    std::vector<int> frameDelaysMs; // Delay in milliseconds for each frame
-    int currentFrame = 0;
-    double lastFrameTime = 0.0;     // Time the current frame started displaying
+    GLuint textureId = 0;        // The canvas
+    int currentDelayMs = 100;    // How long the frame on the canvas stays
+    double lastFrameTime = 0.0;  // Time the current frame started displaying
     bool loaded = false;
+    bool animated = false;       // More than one frame
+    int frameCount = 0;
     int width = 0; // Store dimensions
     int height = 0;
+    std::shared_ptr<GifStream> stream;
+
+    size_t canvasBytes() const { return static_cast<size_t>(width) * height * 4; }
 };
 
+// Reads the file, counts its frames and composites the first one. Touches no GL state,
+// so it can run on any thread.
+bool OpenAnimatedGif(const char* filename, AnimatedGif& gifData);
+
+// Creates the canvas texture showing the first frame. Must run on the thread that owns the GL context.
+bool UploadAnimatedGif(AnimatedGif& gifData);
+
+// Decodes the next frame (starting over after the last one) and uploads the part of the
+// canvas it changed. GL thread only. On a decode error the animation stops on the
+// current frame and false is returned.
+bool AdvanceAnimatedGif(AnimatedGif& gifData);
+
+// Deletes the texture and the decoder state. GL thread only.
+void ReleaseAnimatedGif(AnimatedGif& gifData);
+
 /**
- * @brief Loads an animated GIF from a file.
- * 
- * Decodes the GIF, creates OpenGL textures for each frame, and stores frame data.
- * 
+ * @brief Loads an animated GIF from a file (OpenAnimatedGif + UploadAnimatedGif).
+ *
  * @param filename Path to the GIF file.
- * @param gifData Output structure to be filled with GIF data and textures.
+ * @param gifData Output structure to be filled with GIF data and the canvas texture.
  * @return true if loading was successful, false otherwise.
  */
 bool LoadAnimatedGifFromFile(const char* filename, AnimatedGif& gifData);
 
-// Potentially add a function to release textures if needed outside UIManager
-// void ReleaseAnimatedGif(AnimatedGif& gifData); 
-
-} // namespace GifLoader
\ No newline at end of file
+} // namespace GifLoader
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace HashUtils {
+
+    // 64-bit FNV-1a. Fast enough for content hashing of config files and web assets,
+    // not meant to be cryptographically strong.
+    inline uint64_t Fnv1a64(std::string_view data, uint64_t seed = 14695981039346656037ull) {
+        uint64_t hash = seed;
+        for (unsigned char c : data) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    namespace detail {
+        constexpr uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ull;
+        constexpr uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+        constexpr uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ull;
+
+        inline uint64_t Rotl64(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+        inline uint64_t Read64(const unsigned char* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+        inline uint32_t Read32(const unsigned char* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        inline uint64_t XxRound(uint64_t acc, uint64_t input) {
+            acc += input * XXH_PRIME64_2;
+            return Rotl64(acc, 31) * XXH_PRIME64_1;
+        }
+        inline uint64_t XxMerge(uint64_t acc, uint64_t value) {
+            acc ^= XxRound(0, value);
+            return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+        }
+    } // namespace detail
+
+    // 64-bit xxHash (XXH64, little-endian reading). Consumes 32 bytes per step in four
+    // independent lanes, so it runs at memory speed where FNV-1a is bound by one multiply
+    // per byte; used for whole-file content hashes (config.json and its sidecar).
+    inline uint64_t XxHash64(std::string_view data, uint64_t seed = 0) {
+        using namespace detail;
+        const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+        const auto* end = p + data.size();
+        uint64_t hash;
+        if (data.size() >= 32) {
+            uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+            uint64_t v2 = seed + XXH_PRIME64_2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - XXH_PRIME64_1;
+            const auto* limit = end - 32;
+            do {
+                v1 = XxRound(v1, Read64(p));
+                v2 = XxRound(v2, Read64(p + 8));
+                v3 = XxRound(v3, Read64(p + 16));
+                v4 = XxRound(v4, Read64(p + 24));
+                p += 32;
+            } while (p <= limit);
+            hash = Rotl64(v1, 1) + Rotl64(v2, 7) + Rotl64(v3, 12) + Rotl64(v4, 18);
+            hash = XxMerge(hash, v1);
+            hash = XxMerge(hash, v2);
+            hash = XxMerge(hash, v3);
+            hash = XxMerge(hash, v4);
+        } else {
+            hash = seed + XXH_PRIME64_5;
+        }
+        hash += static_cast<uint64_t>(data.size());
+
+        for (; p + 8 <= end; p += 8) {
+            hash ^= XxRound(0, Read64(p));
+            hash = Rotl64(hash, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        }
+        if (p + 4 <= end) {
+            hash ^= static_cast<uint64_t>(Read32(p)) * XXH_PRIME64_1;
+            hash = Rotl64(hash, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+            p += 4;
+        }
+        for (; p < end; ++p) {
+            hash ^= static_cast<uint64_t>(*p) * XXH_PRIME64_5;
+            hash = Rotl64(hash, 11) * XXH_PRIME64_1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= XXH_PRIME64_2;
+        hash ^= hash >> 29;
+        hash *= XXH_PRIME64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    // Formats a hash as 16 lowercase hex digits.
+    inline std::string ToHex(uint64_t value) {
+        char buffer[17];
+        std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+        return std::string(buffer, 16);
+    }
+
+    // Transparent hasher so unordered containers keyed by std::string can be
+    // searched with a std::string_view (use together with std::equal_to<>).
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view value) const noexcept {
+            return std::hash<std::string_view>{}(value);
+        }
+    };
+
+} // namespace HashUtils
@@ -0,0 +1,222 @@
+#include "IconResizer.hpp"
+#include "ImageResampler.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <gif_lib.h>
+
+// Define STB_IMAGE_IMPLEMENTATION and STB_IMAGE_WRITE_IMPLEMENTATION in *one* CPP file.
+// This is the one: unlike TextureLoader.cpp it has no GL, so the server-side benchmark can link it.
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace IconResizer {
+
+namespace { // Anonymous namespace for internal linkage
+
+    bool isGif(std::string_view data) {
+        return data.size() >= 6 && data.compare(0, 4, "GIF8") == 0;
+    }
+
+    // --- Static images ---
+
+    void appendToString(void* context, void* data, int size) {
+        static_cast<std::string*>(context)->append(static_cast<const char*>(data), static_cast<size_t>(size));
+    }
+
+    std::optional<Encoded> shrinkStatic(std::string_view data, int maxSize) {
+        const auto* buffer = reinterpret_cast<const stbi_uc*>(data.data());
+        int length = static_cast<int>(data.size());
+        int width = 0, height = 0, channels = 0;
+        // Header only: most icons are already small enough and need no decode at all
+        if (!stbi_info_from_memory(buffer, length, &width, &height, &channels)) return std::nullopt;
+        int fitWidth, fitHeight;
+        ImageResampler::fitWithin(width, height, maxSize, fitWidth, fitHeight);
+        if (fitWidth == width && fitHeight == height) return std::nullopt;
+
+        unsigned char* decoded = stbi_load_from_memory(buffer, length, &width, &height, &channels, 4);
+        if (!decoded) {
+            Logger::Warn("[IconResizer] Could not decode image: {}", stbi_failure_reason());
+            return std::nullopt;
+        }
+        std::vector<unsigned char> pixels(decoded, decoded + static_cast<size_t>(width) * height * 4);
+        stbi_image_free(decoded);
+
+        std::vector<unsigned char> resized = ImageResampler::resize(pixels, width, height, fitWidth, fitHeight);
+        if (resized.empty()) return std::nullopt;
+
+        // An opaque icon doesn't need its alpha channel; a quarter fewer bytes to deflate
+        int components = 4;
+        bool opaque = true;
+        for (size_t i = 3; i < resized.size() && opaque; i += 4) opaque = resized[i] == 255;
+        if (opaque) {
+            size_t out = 0;
+            for (size_t i = 0; i < resized.size(); i += 4) {
+                resized[out++] = resized[i];
+                resized[out++] = resized[i + 1];
+                resized[out++] = resized[i + 2];
+            }
+            resized.resize(out);
+            components = 3;
+        }
+
+        Encoded encoded;
+        encoded.format = Format::Png;
+        encoded.width = fitWidth;
+        encoded.height = fitHeight;
+        if (!stbi_write_png_to_func(appendToString, &encoded.bytes, fitWidth, fitHeight, components, resized.data(),
+                                    fitWidth * components)) {
+            Logger::Warn("[IconResizer] Could not encode a {}x{} PNG", fitWidth, fitHeight);
+            return std::nullopt;
+        }
+        return encoded;
+    }
+
+    // --- GIF ---
+
+    struct MemoryReader {
+        std::string_view data;
+        size_t offset = 0;
+    };
+
+    int readFromMemory(GifFileType* file, GifByteType* buffer, int length) {
+        auto* reader = static_cast<MemoryReader*>(file->UserData);
+        size_t count = std::min(static_cast<size_t>(std::max(length, 0)), reader->data.size() - reader->offset);
+        std::memcpy(buffer, reader->data.data() + reader->offset, count);
+        reader->offset += count;
+        return static_cast<int>(count);
+    }
+
+    int writeToString(GifFileType* file, const GifByteType* buffer, int length) {
+        static_cast<std::string*>(file->UserData)->append(reinterpret_cast<const char*>(buffer), static_cast<size_t>(length));
+        return length;
+    }
+
+    // Writes extension blocks as DGifSlurp stored them: a block with a function code
+    // starts an extension, CONTINUE_EXT_FUNC_CODE blocks continue it
+    bool writeExtensions(GifFileType* out, const ExtensionBlock* blocks, int count) {
+        for (int i = 0; i < count; ++i) {
+            const ExtensionBlock& block = blocks[i];
+            if (block.Function != CONTINUE_EXT_FUNC_CODE && EGifPutExtensionLeader(out, block.Function) != GIF_OK) {
+                return false;
+            }
+            if (EGifPutExtensionBlock(out, block.ByteCount, block.Bytes) != GIF_OK) return false;
+            if ((i + 1 == count || blocks[i + 1].Function != CONTINUE_EXT_FUNC_CODE) &&
+                EGifPutExtensionTrailer(out) != GIF_OK) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // One frame, scaled by (scaleX, scaleY) in canvas coordinates so neighbouring frames
+    // still line up. Destination pixels whose source falls outside the frame take the
+    // transparent index when the frame has one, and the nearest edge pixel otherwise.
+    bool writeFrame(GifFileType* out, const SavedImage& frame, int transparent, double scaleX, double scaleY,
+                    int canvasWidth, int canvasHeight) {
+        const GifImageDesc& desc = frame.ImageDesc;
+        int left = std::clamp(static_cast<int>(std::floor(desc.Left * scaleX)), 0, canvasWidth - 1);
+        int top = std::clamp(static_cast<int>(std::floor(desc.Top * scaleY)), 0, canvasHeight - 1);
+        int right = std::clamp(static_cast<int>(std::ceil((desc.Left + desc.Width) * scaleX)), left + 1, canvasWidth);
+        int bottom = std::clamp(static_cast<int>(std::ceil((desc.Top + desc.Height) * scaleY)), top + 1, canvasHeight);
+        int width = right - left;
+        int height = bottom - top;
+
+        if (EGifPutImageDesc(out, left, top, width, height, false, desc.ColorMap) != GIF_OK) return false;
+
+        // Source column for every destination column, -1 when outside the frame
+        std::vector<int> sourceColumn(width);
+        for (int x = 0; x < width; ++x) {
+            int sx = static_cast<int>(std::floor((left + x + 0.5) / scaleX)) - desc.Left;
+            if (sx < 0 || sx >= desc.Width) sx = transparent >= 0 ? -1 : std::clamp(sx, 0, desc.Width - 1);
+            sourceColumn[x] = sx;
+        }
+        std::vector<GifPixelType> row(width);
+        for (int y = 0; y < height; ++y) {
+            int sy = static_cast<int>(std::floor((top + y + 0.5) / scaleY)) - desc.Top;
+            bool outside = sy < 0 || sy >= desc.Height;
+            if (outside && transparent >= 0) {
+                std::fill(row.begin(), row.end(), static_cast<GifPixelType>(transparent));
+            } else {
+                const GifByteType* source = frame.RasterBits + static_cast<size_t>(std::clamp(sy, 0, desc.Height - 1)) * desc.Width;
+                for (int x = 0; x < width; ++x) {
+                    row[x] = sourceColumn[x] < 0 ? static_cast<GifPixelType>(transparent) : source[sourceColumn[x]];
+                }
+            }
+            if (EGifPutLine(out, row.data(), width) != GIF_OK) return false;
+        }
+        return true;
+    }
+
+    std::optional<Encoded> shrinkGif(std::string_view data, int maxSize) {
+        MemoryReader reader{data, 0};
+        int error = 0;
+        GifFileType* in = DGifOpen(&reader, readFromMemory, &error);
+        if (!in) return std::nullopt;
+
+        std::optional<Encoded> result;
+        int fitWidth, fitHeight;
+        ImageResampler::fitWithin(in->SWidth, in->SHeight, maxSize, fitWidth, fitHeight);
+        if ((fitWidth != in->SWidth || fitHeight != in->SHeight) && DGifSlurp(in) == GIF_OK && in->ImageCount > 0) {
+            Encoded encoded;
+            encoded.format = Format::Gif;
+            encoded.width = fitWidth;
+            encoded.height = fitHeight;
+            GifFileType* out = EGifOpen(&encoded.bytes, writeToString, &error);
+            bool ok = out != nullptr;
+            if (ok) {
+                EGifSetGifVersion(out, true);
+                ok = EGifPutScreenDesc(out, fitWidth, fitHeight, in->SColorResolution, in->SBackGroundColor,
+                                       in->SColorMap) == GIF_OK;
+                double scaleX = static_cast<double>(fitWidth) / in->SWidth;
+                double scaleY = static_cast<double>(fitHeight) / in->SHeight;
+                for (int i = 0; ok && i < in->ImageCount; ++i) {
+                    const SavedImage& frame = in->SavedImages[i];
+                    if (!frame.RasterBits || frame.ImageDesc.Width <= 0 || frame.ImageDesc.Height <= 0) continue;
+                    GraphicsControlBlock gcb{DISPOSAL_UNSPECIFIED, false, 0, NO_TRANSPARENT_COLOR};
+                    DGifSavedExtensionToGCB(in, i, &gcb);
+                    ok = writeExtensions(out, frame.ExtensionBlocks, frame.ExtensionBlockCount) &&
+                         writeFrame(out, frame, gcb.TransparentColor, scaleX, scaleY, fitWidth, fitHeight);
+                }
+                ok = ok && writeExtensions(out, in->ExtensionBlocks, in->ExtensionBlockCount);
+                // Writes the trailer and frees the handle, also after a failure
+                ok = EGifCloseFile(out, &error) == GIF_OK && ok;
+            }
+            if (ok) {
+                result = std::move(encoded);
+            } else {
+                Logger::Warn("[IconResizer] Could not encode a {}x{} GIF: {}", fitWidth, fitHeight, GifErrorString(error));
+            }
+        }
+        DGifCloseFile(in, &error);
+        return result;
+    }
+
+} // namespace
+
+Format outputFormat(std::string_view data) {
+    return isGif(data) ? Format::Gif : Format::Png;
+}
+
+std::string_view mimeType(Format format) {
+    return format == Format::Gif ? "image/gif" : "image/png";
+}
+
+std::string_view extension(Format format) {
+    return format == Format::Gif ? ".gif" : ".png";
+}
+
+std::optional<Encoded> shrink(std::string_view data, int maxSize) {
+    if (data.empty() || maxSize <= 0) return std::nullopt;
+    std::optional<Encoded> encoded = isGif(data) ? shrinkGif(data, maxSize) : shrinkStatic(data, maxSize);
+    if (encoded && encoded->bytes.size() >= data.size()) {
+        return std::nullopt; // E.g. a well optimised PNG only a little larger than maxSize
+    }
+    return encoded;
+}
+
+} // namespace IconResizer
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Re-encodes icon files at the size a client shows them, so a phone doesn't download a
+// 256 px PNG or a 1 MB GIF to draw it at 45 CSS px. Static images are decoded with
+// stb_image, resampled with ImageResampler and written as PNG. GIFs keep their palettes,
+// timing, disposal and loop count and are scaled by nearest neighbour on the palette
+// indices, so no frame has to be quantised again. No GL; safe on any thread.
+namespace IconResizer {
+
+enum class Format {
+    Png,
+    Gif
+};
+
+struct Encoded {
+    Format format = Format::Png;
+    int width = 0;
+    int height = 0;
+    std::string bytes; // The complete file
+};
+
+// Format a shrunk copy of this file would have (GIFs stay GIFs), by its signature
+Format outputFormat(std::string_view data);
+std::string_view mimeType(Format format);
+std::string_view extension(Format format); // With the dot
+
+// Re-encodes the image file `data` so that its larger side is at most `maxSize` pixels.
+// Returns nullopt if it can't be decoded, already fits, or the result would not be
+// smaller than `data`; the original is the better file to send in all of those cases.
+std::optional<Encoded> shrink(std::string_view data, int maxSize);
+
+} // namespace IconResizer
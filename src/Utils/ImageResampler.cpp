@@ -0,0 +1,169 @@
+#include "ImageResampler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ImageResampler {
+
+namespace { // Anonymous namespace for internal linkage
+
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double LANCZOS_LOBES = 3.0;
+
+    double sinc(double x) {
+        if (std::abs(x) < 1e-8) return 1.0;
+        x *= PI;
+        return std::sin(x) / x;
+    }
+
+    double lanczos3(double x) {
+        if (std::abs(x) >= LANCZOS_LOBES) return 0.0;
+        return sinc(x) * sinc(x / LANCZOS_LOBES);
+    }
+
+    // For every destination pixel along one axis: the source pixels it reads
+    // (first, first + count) and their weights, normalized to sum to 1
+    struct AxisWeights {
+        std::vector<int> first;
+        std::vector<int> count;
+        std::vector<size_t> offset;  // Into weights
+        std::vector<float> weights;
+    };
+
+    AxisWeights computeWeights(int srcSize, int dstSize, Filter filter) {
+        double scale = static_cast<double>(srcSize) / dstSize;
+        double filterScale = std::max(scale, 1.0); // Widen the kernel when shrinking
+        double support = (filter == Filter::Box ? 0.5 : LANCZOS_LOBES) * filterScale;
+
+        AxisWeights axis;
+        axis.first.resize(dstSize);
+        axis.count.resize(dstSize);
+        axis.offset.resize(dstSize);
+        std::vector<double> taps;
+        for (int i = 0; i < dstSize; ++i) {
+            double center = (i + 0.5) * scale;
+            int left = std::max(0, static_cast<int>(std::floor(center - support)));
+            int right = std::min(srcSize - 1, static_cast<int>(std::ceil(center + support)));
+
+            taps.clear();
+            double sum = 0.0;
+            for (int j = left; j <= right; ++j) {
+                double weight;
+                if (filter == Filter::Box) {
+                    // Overlap of source pixel [j, j + 1) with the destination pixel's footprint
+                    double lo = std::max<double>(j, center - support);
+                    double hi = std::min<double>(j + 1, center + support);
+                    weight = std::max(0.0, hi - lo);
+                } else {
+                    weight = lanczos3((j + 0.5 - center) / filterScale);
+                }
+                taps.push_back(weight);
+                sum += weight;
+            }
+            // Zero taps at the ends only cost time
+            size_t begin = 0, end = taps.size();
+            while (begin < end && taps[begin] == 0.0) ++begin;
+            while (end > begin && taps[end - 1] == 0.0) --end;
+            if (begin == end || std::abs(sum) < 1e-12) { // Can't happen for sane sizes; use the nearest pixel
+                taps.assign(1, 1.0);
+                left = std::clamp(static_cast<int>(center), 0, srcSize - 1);
+                begin = 0;
+                end = 1;
+                sum = 1.0;
+            }
+
+            axis.first[i] = left + static_cast<int>(begin);
+            axis.count[i] = static_cast<int>(end - begin);
+            axis.offset[i] = axis.weights.size();
+            for (size_t k = begin; k < end; ++k) axis.weights.push_back(static_cast<float>(taps[k] / sum));
+        }
+        return axis;
+    }
+
+} // namespace
+
+std::vector<unsigned char> resize(const std::vector<unsigned char>& rgba, int srcWidth, int srcHeight,
+                                  int dstWidth, int dstHeight, Filter filter) {
+    if (srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0 ||
+        rgba.size() < static_cast<size_t>(srcWidth) * srcHeight * 4) {
+        return {};
+    }
+    if (srcWidth == dstWidth && srcHeight == dstHeight) {
+        return std::vector<unsigned char>(rgba.begin(), rgba.begin() + static_cast<size_t>(srcWidth) * srcHeight * 4);
+    }
+
+    AxisWeights horizontal = computeWeights(srcWidth, dstWidth, filter);
+    AxisWeights vertical = computeWeights(srcHeight, dstHeight, filter);
+
+    // Premultiplied alpha, in 0..255 units
+    std::vector<float> source(static_cast<size_t>(srcWidth) * srcHeight * 4);
+    for (size_t p = 0; p < source.size(); p += 4) {
+        float alpha = rgba[p + 3] * (1.0f / 255.0f);
+        source[p + 0] = rgba[p + 0] * alpha;
+        source[p + 1] = rgba[p + 1] * alpha;
+        source[p + 2] = rgba[p + 2] * alpha;
+        source[p + 3] = rgba[p + 3];
+    }
+
+    // Horizontal pass: srcHeight rows of dstWidth pixels
+    size_t hStride = static_cast<size_t>(dstWidth) * 4;
+    std::vector<float> rows(hStride * srcHeight, 0.0f);
+    for (int y = 0; y < srcHeight; ++y) {
+        const float* srcRow = &source[static_cast<size_t>(y) * srcWidth * 4];
+        float* dstRow = &rows[y * hStride];
+        for (int x = 0; x < dstWidth; ++x) {
+            const float* weights = &horizontal.weights[horizontal.offset[x]];
+            const float* in = srcRow + static_cast<size_t>(horizontal.first[x]) * 4;
+            float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+            for (int k = 0; k < horizontal.count[x]; ++k, in += 4) {
+                r += weights[k] * in[0];
+                g += weights[k] * in[1];
+                b += weights[k] * in[2];
+                a += weights[k] * in[3];
+            }
+            float* out = dstRow + x * 4;
+            out[0] = r;
+            out[1] = g;
+            out[2] = b;
+            out[3] = a;
+        }
+    }
+
+    // Vertical pass: whole rows at a time, so the inner loop is a contiguous multiply-add
+    std::vector<unsigned char> result(static_cast<size_t>(dstWidth) * dstHeight * 4);
+    std::vector<float> accumulator(hStride);
+    for (int y = 0; y < dstHeight; ++y) {
+        std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+        const float* weights = &vertical.weights[vertical.offset[y]];
+        for (int k = 0; k < vertical.count[y]; ++k) {
+            float weight = weights[k];
+            const float* in = &rows[(vertical.first[y] + k) * hStride];
+            for (size_t i = 0; i < hStride; ++i) accumulator[i] += weight * in[i];
+        }
+
+        unsigned char* out = &result[y * hStride];
+        for (size_t i = 0; i < hStride; i += 4) {
+            float alpha = std::clamp(accumulator[i + 3], 0.0f, 255.0f);
+            if (alpha < 0.5f) {
+                out[i] = out[i + 1] = out[i + 2] = out[i + 3] = 0;
+                continue;
+            }
+            float unpremultiply = 255.0f / alpha;
+            for (int c = 0; c < 3; ++c) {
+                out[i + c] = static_cast<unsigned char>(std::clamp(accumulator[i + c] * unpremultiply, 0.0f, 255.0f) + 0.5f);
+            }
+            out[i + 3] = static_cast<unsigned char>(alpha + 0.5f);
+        }
+    }
+    return result;
+}
+
+void fitWithin(int width, int height, int maxSize, int& fitWidth, int& fitHeight) {
+    fitWidth = width;
+    fitHeight = height;
+    if (maxSize <= 0 || (width <= maxSize && height <= maxSize)) return;
+    double scale = static_cast<double>(maxSize) / std::max(width, height);
+    fitWidth = std::clamp(static_cast<int>(std::lround(width * scale)), 1, maxSize);
+    fitHeight = std::clamp(static_cast<int>(std::lround(height * scale)), 1, maxSize);
+}
+
+} // namespace ImageResampler
@@ -3,22 +3,29 @@
 #include <vector>
 #include <string>
 #include <algorithm> // For std::sort
+#include <cstring>
 #include <imgui_internal.h> // May be needed for specific ImGuiKey details or IsKeyDownMap
 #include <set>
 #include <chrono> // For timing ESC debounce
-#include <iostream> // For cerr
+#include "Logger.hpp"
 
 namespace InputUtils {
 
 // Helper function to map ImGuiKey to string representation
 // Focuses on non-modifier keys suitable for the main part of a hotkey.
-std::string ImGuiKeyToString(ImGuiKey key) {
+// Returns views of static strings, so scanning every key each frame allocates nothing.
+std::string_view ImGuiKeyName(ImGuiKey key) {
+    static constexpr std::string_view LETTERS = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    static constexpr std::string_view DIGITS = "0123456789";
+    static constexpr std::string_view FUNCTION_KEYS[] = {"F1", "F2", "F3", "F4", "F5", "F6",
+                                                         "F7", "F8", "F9", "F10", "F11", "F12"};
+
     // Handle letters and numbers directly
-    if (key >= ImGuiKey_A && key <= ImGuiKey_Z) { return std::string(1, (char)('A' + (key - ImGuiKey_A))); }
-    if (key >= ImGuiKey_0 && key <= ImGuiKey_9) { return std::string(1, (char)('0' + (key - ImGuiKey_0))); }
+    if (key >= ImGuiKey_A && key <= ImGuiKey_Z) { return LETTERS.substr(key - ImGuiKey_A, 1); }
+    if (key >= ImGuiKey_0 && key <= ImGuiKey_9) { return DIGITS.substr(key - ImGuiKey_0, 1); }
 
     // Function Keys
-    if (key >= ImGuiKey_F1 && key <= ImGuiKey_F12) { return "F" + std::to_string(key - ImGuiKey_F1 + 1); }
+    if (key >= ImGuiKey_F1 && key <= ImGuiKey_F12) { return FUNCTION_KEYS[key - ImGuiKey_F1]; }
     // Add F13-F24 if needed (ImGuiKey_F13 etc.)
 
     // Special Keys
@@ -84,6 +91,10 @@ std::string ImGuiKeyToString(ImGuiKey key) {
     }
 }
 
+std::string ImGuiKeyToString(ImGuiKey key) {
+    return std::string(ImGuiKeyName(key));
+}
+
 static std::set<int> g_pressedKeys;
 static char g_hotkeyBuffer[HOTKEY_BUFFER_SIZE] = {0};
 static bool g_capturing = false;
@@ -110,8 +121,8 @@ bool TryCaptureHotkey(char* buffer, size_t buffer_size) {
     // 3. Find the main key *pressed* in this frame
     ImGuiKey mainKeyPressed = ImGuiKey_None;
     for (ImGuiKey key = ImGuiKey_NamedKey_BEGIN; key < ImGuiKey_NamedKey_END; key = (ImGuiKey)(key + 1)) {
-         // Skip modifiers, Escape, and unknown keys handled by ImGuiKeyToString returning ""
-        if (ImGuiKeyToString(key).empty()) {
+         // Skip modifiers, Escape, and unknown keys handled by ImGuiKeyName returning ""
+        if (ImGuiKeyName(key).empty()) {
             continue;
         }
         // Use IsKeyPressed to detect the initial press, 'false' = don't allow repeat
@@ -131,37 +142,31 @@ bool TryCaptureHotkey(char* buffer, size_t buffer_size) {
          
         // We need at least one modifier OR the main key itself must be non-modifier
         if (ctrlDown || shiftDown || altDown || superDown || !isModifierAlone) {
-            std::string result = "";
-            std::vector<std::string> parts;
+            // Joined with "+" straight into the caller's buffer
+            size_t length = 0;
+            auto appendPart = [&](std::string_view part) {
+                if (length > 0 && length + 1 < buffer_size) buffer[length++] = '+';
+                size_t count = std::min(part.size(), buffer_size - 1 - length);
+                std::memcpy(buffer + length, part.data(), count);
+                length += count;
+            };
 
             // Add modifiers in a consistent order
-            if (ctrlDown) parts.push_back("CTRL");
-            if (altDown) parts.push_back("ALT");
-            if (shiftDown) parts.push_back("SHIFT");
-            if (superDown) parts.push_back("WIN"); // Use WIN consistently
+            if (ctrlDown) appendPart("CTRL");
+            if (altDown) appendPart("ALT");
+            if (shiftDown) appendPart("SHIFT");
+            if (superDown) appendPart("WIN"); // Use WIN consistently
 
             // Add the main key
-            std::string mainKeyStr = ImGuiKeyToString(mainKeyPressed);
-            if (!mainKeyStr.empty()) {
-                 parts.push_back(mainKeyStr);
-            } else {
+            std::string_view mainKeyStr = ImGuiKeyName(mainKeyPressed);
+            if (mainKeyStr.empty()) {
                  // This case should ideally not happen due to the loop condition,
                  // but handle defensively.
                  buffer[0] = '\0';
                  return true; // Treat as invalid combo, finish capture
             }
-
-            // Join parts with "+"
-            for (size_t i = 0; i < parts.size(); ++i) {
-                result += parts[i];
-                if (i < parts.size() - 1) {
-                    result += "+";
-                }
-            }
-
-            // Copy to buffer
-            strncpy(buffer, result.c_str(), buffer_size - 1);
-            buffer[buffer_size - 1] = '\0'; // Ensure null termination
+            appendPart(mainKeyStr);
+            buffer[length] = '\0'; // Ensure null termination
 
             return true; // Capture finished successfully
         }
@@ -222,7 +227,7 @@ bool InitializeAudioControl() {
     // Initialize COM for this thread
     hr = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED | COINIT_DISABLE_OLE1DDE);
     if (FAILED(hr) && hr != RPC_E_CHANGED_MODE) { // RPC_E_CHANGED_MODE means COM already initialized differently, which is ok
-        std::cerr << "Error: CoInitializeEx failed, HR = 0x" << std::hex << hr << std::endl;
+        Logger::Error("CoInitializeEx failed, HR = 0x{:x}", hr);
         return false;
     }
 
@@ -230,7 +235,7 @@ bool InitializeAudioControl() {
     hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), NULL, CLSCTX_ALL,
                           __uuidof(IMMDeviceEnumerator), (void**)&pEnumerator);
     if (FAILED(hr)) {
-        std::cerr << "Error: CoCreateInstance(MMDeviceEnumerator) failed, HR = 0x" << std::hex << hr << std::endl;
+        Logger::Error("CoCreateInstance(MMDeviceEnumerator) failed, HR = 0x{:x}", hr);
         CoUninitialize(); // Clean up COM
         return false;
     }
@@ -239,7 +244,7 @@ bool InitializeAudioControl() {
     IMMDevice *pDevice = NULL;
     hr = pEnumerator->GetDefaultAudioEndpoint(eRender, eConsole, &pDevice);
     if (FAILED(hr)) {
-        std::cerr << "Error: GetDefaultAudioEndpoint failed, HR = 0x" << std::hex << hr << std::endl;
+        Logger::Error("GetDefaultAudioEndpoint failed, HR = 0x{:x}", hr);
         SAFE_RELEASE(pEnumerator);
         CoUninitialize();
         return false;
@@ -248,7 +253,7 @@ bool InitializeAudioControl() {
     // Activate the IAudioEndpointVolume interface
     hr = pDevice->Activate(__uuidof(IAudioEndpointVolume), CLSCTX_ALL, NULL, (void**)&pEndpointVolume);
     if (FAILED(hr)) {
-        std::cerr << "Error: Activate(IAudioEndpointVolume) failed, HR = 0x" << std::hex << hr << std::endl;
+        Logger::Error("Activate(IAudioEndpointVolume) failed, HR = 0x{:x}", hr);
     }
     else {
         success = true; // Successfully got the volume interface
@@ -262,7 +267,7 @@ bool InitializeAudioControl() {
         CoUninitialize();
     }
 
-    std::cout << "Audio control initialized " << (success ? "successfully." : "failed.") << std::endl;
+    Logger::Info("Audio control initialized {}", (success ? "successfully." : "failed."));
     return success;
 }
 
@@ -270,12 +275,12 @@ void UninitializeAudioControl() {
     SAFE_RELEASE(pEndpointVolume);
     SAFE_RELEASE(pEnumerator);
     CoUninitialize(); // Uninitialize COM
-    std::cout << "Audio control uninitialized." << std::endl;
+    Logger::Info("Audio control uninitialized.");
 }
 
 bool IncreaseMasterVolume() {
     if (!pEndpointVolume) {
-        std::cerr << "Error: Audio volume control not initialized." << std::endl;
+        Logger::Error("Audio volume control not initialized.");
         return false;
     }
     HRESULT hr = pEndpointVolume->VolumeStepUp(NULL);
@@ -289,7 +294,7 @@ bool IncreaseMasterVolume() {
 
 bool DecreaseMasterVolume() {
     if (!pEndpointVolume) {
-        std::cerr << "Error: Audio volume control not initialized." << std::endl;
+        Logger::Error("Audio volume control not initialized.");
         return false;
     }
     HRESULT hr = pEndpointVolume->VolumeStepDown(NULL);
@@ -303,7 +308,7 @@ bool DecreaseMasterVolume() {
 
 bool ToggleMasterMute() {
     if (!pEndpointVolume) {
-        std::cerr << "Error: Audio volume control not initialized." << std::endl;
+        Logger::Error("Audio volume control not initialized.");
         return false;
     }
     BOOL currentMute = FALSE;
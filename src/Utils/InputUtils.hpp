@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <imgui.h> // Required for ImGuiKey
 
 // ADDED: Include windows.h specifically for WORD definition under WIN32
@@ -20,7 +21,9 @@
 namespace InputUtils {
     // Converts ImGuiKey enum to a display string (e.g., ImGuiKey_A -> "A")
     // Returns empty string for unknown or modifier keys handled separately.
-    std::string ImGuiKeyToString(ImGuiKey key);
+    std::string_view ImGuiKeyName(ImGuiKey key);
+    std::string ImGuiKeyToString(ImGuiKey key); // Same, as an owned string
+
 
     // Checks for hotkey input in the current frame.
     // If a valid combination is pressed, formats it into the buffer and returns true.
@@ -0,0 +1,433 @@
+#include "Logger.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Logger {
+
+namespace detail {
+    std::atomic<uint8_t> g_minLevel{static_cast<uint8_t>(Level::Info)};
+}
+
+namespace {
+
+    // Single-producer (the owning thread) / single-consumer (the flusher) ring
+    struct Ring {
+        explicit Ring(size_t capacity) : slots(capacity), mask(capacity - 1) {}
+
+        std::vector<detail::Record> slots;
+        const size_t mask;
+        alignas(64) std::atomic<uint64_t> head{0}; // Written by the producer
+        alignas(64) std::atomic<uint64_t> tail{0}; // Written by the consumer
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> orphaned{false};         // Owning thread has exited
+    };
+
+    struct State {
+        std::mutex registryMutex;
+        std::vector<std::shared_ptr<Ring>> rings;
+        size_t ringCapacity = 1024;
+        uint64_t retiredDrops = 0; // Drop counts of rings whose threads have exited
+
+        std::mutex drainMutex; // Serializes consumers (flusher thread, Flush(), Shutdown())
+        uint64_t reportedDrops = 0;
+        std::vector<detail::Record> batch;
+        std::string stdoutBuffer;
+        std::string stderrBuffer;
+
+        std::mutex tailMutex;
+        std::deque<Entry> tail;
+        size_t tailCapacity = 2000;
+        std::atomic<uint64_t> sequence{0};
+        std::mutex listenerMutex; // Held while the listener runs, so removing it waits for the call
+        std::function<void()> tailListener;
+
+        std::atomic<bool> running{false};
+        bool writeToConsole = true;
+        std::chrono::milliseconds flushInterval{20};
+        std::thread flusher;
+        std::mutex wakeMutex;
+        std::condition_variable wake;
+        bool stopRequested = false;
+
+        // Early returns from main() may skip Shutdown(); never leave a joinable thread behind
+        ~State() {
+            if (flusher.joinable()) {
+                {
+                    std::lock_guard<std::mutex> lock(wakeMutex);
+                    stopRequested = true;
+                }
+                wake.notify_one();
+                flusher.join();
+            }
+        }
+    };
+
+    State& state() {
+        static State instance;
+        return instance;
+    }
+
+    size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+
+    // Keeps the thread's ring alive in the registry after the thread exits, so the
+    // flusher can still drain what it logged last
+    struct ThreadRing {
+        std::shared_ptr<Ring> ring;
+        ~ThreadRing() {
+            if (ring) ring->orphaned.store(true, std::memory_order_release);
+        }
+    };
+
+    Ring& threadRing() {
+        thread_local ThreadRing handle;
+        if (!handle.ring) {
+            State& s = state();
+            std::lock_guard<std::mutex> lock(s.registryMutex);
+            handle.ring = std::make_shared<Ring>(roundUpToPowerOfTwo(std::max<size_t>(s.ringCapacity, 2)));
+            s.rings.push_back(handle.ring);
+        }
+        return *handle.ring;
+    }
+
+    thread_local detail::Record t_scratch; // Used while the flusher is not running
+
+    int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    void appendArg(std::string& out, const char*& cursor, const char* end, bool hex) {
+        auto type = static_cast<detail::ArgType>(*cursor++);
+        char number[32];
+        switch (type) {
+            case detail::ArgType::Int: {
+                int64_t value;
+                std::memcpy(&value, cursor, sizeof(value));
+                cursor += sizeof(value);
+                std::snprintf(number, sizeof(number), hex ? "%llx" : "%lld", static_cast<long long>(value));
+                out += number;
+                break;
+            }
+            case detail::ArgType::UInt: {
+                uint64_t value;
+                std::memcpy(&value, cursor, sizeof(value));
+                cursor += sizeof(value);
+                std::snprintf(number, sizeof(number), hex ? "%llx" : "%llu", static_cast<unsigned long long>(value));
+                out += number;
+                break;
+            }
+            case detail::ArgType::Double: {
+                double value;
+                std::memcpy(&value, cursor, sizeof(value));
+                cursor += sizeof(value);
+                std::snprintf(number, sizeof(number), "%g", value);
+                out += number;
+                break;
+            }
+            case detail::ArgType::Bool:
+                out += *cursor++ ? "true" : "false";
+                break;
+            case detail::ArgType::Char:
+                out += *cursor++;
+                break;
+            case detail::ArgType::String: {
+                uint16_t length;
+                std::memcpy(&length, cursor, sizeof(length));
+                cursor += sizeof(length);
+                length = static_cast<uint16_t>(std::min<size_t>(length, static_cast<size_t>(end - cursor)));
+                out.append(cursor, length);
+                cursor += length;
+                break;
+            }
+            case detail::ArgType::Pointer: {
+                uintptr_t value;
+                std::memcpy(&value, cursor, sizeof(value));
+                cursor += sizeof(value);
+                std::snprintf(number, sizeof(number), "0x%llx", static_cast<unsigned long long>(value));
+                out += number;
+                break;
+            }
+        }
+    }
+
+    std::string formatRecord(const detail::Record& record) {
+        std::string out;
+        const char* cursor = record.payload;
+        const char* end = record.payload + record.size;
+        uint8_t argsLeft = record.argCount;
+
+        for (const char* f = record.format; *f; ++f) {
+            bool plain = f[0] == '{' && f[1] == '}';
+            bool hex = f[0] == '{' && f[1] == ':' && f[2] == 'x' && f[3] == '}';
+            if (!plain && !hex) {
+                out += *f;
+                continue;
+            }
+            if (argsLeft > 0) {
+                appendArg(out, cursor, end, hex);
+                --argsLeft;
+            } else {
+                out += "{?}"; // Argument did not fit into the record
+            }
+            f += hex ? 3 : 1;
+        }
+        return out;
+    }
+
+    void appendConsoleLine(std::string& out, const Entry& entry) {
+        std::time_t seconds = static_cast<std::time_t>(entry.timestampMs / 1000);
+        std::tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &seconds);
+#else
+        localtime_r(&seconds, &local);
+#endif
+        char prefix[48];
+        std::snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%03d %-5s ", local.tm_hour, local.tm_min, local.tm_sec,
+                      static_cast<int>(entry.timestampMs % 1000), LevelName(entry.level));
+        out += prefix;
+        out += entry.text;
+        out += '\n';
+    }
+
+    // Formats and outputs a batch of records that are already in timestamp order
+    void publish(State& s, const detail::Record* records, size_t count) {
+        if (count == 0) return;
+        std::vector<Entry> entries;
+        entries.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            Entry entry;
+            entry.timestampMs = records[i].timestampNs / 1000000;
+            entry.level = records[i].level;
+            entry.text = formatRecord(records[i]);
+            entries.push_back(std::move(entry));
+        }
+
+        if (s.writeToConsole) {
+            s.stdoutBuffer.clear();
+            s.stderrBuffer.clear();
+            for (const auto& entry : entries) {
+                appendConsoleLine(entry.level >= Level::Warn ? s.stderrBuffer : s.stdoutBuffer, entry);
+            }
+            // One write (and flush) per batch instead of one per line
+            if (!s.stdoutBuffer.empty()) {
+                std::fwrite(s.stdoutBuffer.data(), 1, s.stdoutBuffer.size(), stdout);
+                std::fflush(stdout);
+            }
+            if (!s.stderrBuffer.empty()) {
+                std::fwrite(s.stderrBuffer.data(), 1, s.stderrBuffer.size(), stderr);
+                std::fflush(stderr);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s.tailMutex);
+            for (auto& entry : entries) {
+                entry.sequence = s.sequence.load(std::memory_order_relaxed) + 1;
+                s.tail.push_back(std::move(entry));
+                s.sequence.store(s.tail.back().sequence, std::memory_order_release);
+            }
+            while (s.tail.size() > s.tailCapacity) {
+                s.tail.pop_front();
+            }
+        }
+        std::lock_guard<std::mutex> lock(s.listenerMutex);
+        if (s.tailListener) s.tailListener();
+    }
+
+    // Moves everything out of the rings and publishes it. Caller holds drainMutex.
+    void drainRings(State& s) {
+        s.batch.clear();
+        uint64_t totalDrops = 0;
+        {
+            std::lock_guard<std::mutex> lock(s.registryMutex);
+            totalDrops = s.retiredDrops;
+            for (auto it = s.rings.begin(); it != s.rings.end();) {
+                Ring& ring = **it;
+                uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+                uint64_t head = ring.head.load(std::memory_order_acquire);
+                for (; tail != head; ++tail) {
+                    s.batch.push_back(ring.slots[tail & ring.mask]);
+                }
+                ring.tail.store(tail, std::memory_order_release);
+                totalDrops += ring.dropped.load(std::memory_order_relaxed);
+
+                if (ring.orphaned.load(std::memory_order_acquire) &&
+                    ring.head.load(std::memory_order_acquire) == tail) {
+                    s.retiredDrops += ring.dropped.load(std::memory_order_relaxed);
+                    it = s.rings.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        // Interleave the threads' messages by time
+        std::stable_sort(s.batch.begin(), s.batch.end(), [](const detail::Record& a, const detail::Record& b) {
+            return a.timestampNs < b.timestampNs;
+        });
+        publish(s, s.batch.data(), s.batch.size());
+
+        if (totalDrops > s.reportedDrops) {
+            detail::Record notice;
+            notice.timestampNs = nowNs();
+            notice.level = Level::Warn;
+            notice.format = "[Logger] {} messages dropped (ring buffer full).";
+            detail::ArgWriter(notice).write(totalDrops - s.reportedDrops);
+            s.reportedDrops = totalDrops;
+            publish(s, &notice, 1);
+        }
+    }
+
+    void flusherLoop() {
+        State& s = state();
+        std::unique_lock<std::mutex> wakeLock(s.wakeMutex);
+        while (!s.stopRequested) {
+            s.wake.wait_for(wakeLock, s.flushInterval);
+            wakeLock.unlock();
+            {
+                std::lock_guard<std::mutex> lock(s.drainMutex);
+                drainRings(s);
+            }
+            wakeLock.lock();
+        }
+    }
+
+} // namespace
+
+namespace detail {
+
+    Record* BeginRecord(Level level) {
+        State& s = state();
+        Record* record = nullptr;
+        if (s.running.load(std::memory_order_acquire)) {
+            Ring& ring = threadRing();
+            uint64_t head = ring.head.load(std::memory_order_relaxed);
+            if (head - ring.tail.load(std::memory_order_acquire) >= ring.slots.size()) {
+                ring.dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr; // Never block the caller
+            }
+            record = &ring.slots[head & ring.mask];
+        } else {
+            record = &t_scratch;
+        }
+        record->timestampNs = nowNs();
+        record->level = level;
+        record->argCount = 0;
+        record->size = 0;
+        return record;
+    }
+
+    void CommitRecord(Record* record) {
+        if (record == &t_scratch) {
+            // No flusher: format and write on the calling thread
+            State& s = state();
+            std::lock_guard<std::mutex> lock(s.drainMutex);
+            publish(s, record, 1);
+            return;
+        }
+        Ring& ring = threadRing();
+        ring.head.store(ring.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+} // namespace detail
+
+void Init(const Options& options) {
+    State& s = state();
+    if (s.running.load()) return;
+    {
+        std::lock_guard<std::mutex> lock(s.registryMutex);
+        s.ringCapacity = options.ringCapacity;
+    }
+    {
+        std::lock_guard<std::mutex> lock(s.tailMutex);
+        s.tailCapacity = std::max<size_t>(options.tailCapacity, 1);
+    }
+    s.writeToConsole = options.writeToConsole;
+    s.flushInterval = options.flushInterval;
+    {
+        std::lock_guard<std::mutex> lock(s.wakeMutex);
+        s.stopRequested = false;
+    }
+    s.running.store(true, std::memory_order_release);
+    s.flusher = std::thread(flusherLoop);
+}
+
+void Shutdown() {
+    State& s = state();
+    if (!s.running.exchange(false)) return;
+    {
+        std::lock_guard<std::mutex> lock(s.wakeMutex);
+        s.stopRequested = true;
+    }
+    s.wake.notify_one();
+    if (s.flusher.joinable()) {
+        s.flusher.join();
+    }
+    // Anything committed after the last cycle
+    std::lock_guard<std::mutex> lock(s.drainMutex);
+    drainRings(s);
+}
+
+void Flush() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.drainMutex);
+    drainRings(s);
+}
+
+void SetLevel(Level level) {
+    detail::g_minLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+Level GetLevel() {
+    return static_cast<Level>(detail::g_minLevel.load(std::memory_order_relaxed));
+}
+
+const char* LevelName(Level level) {
+    switch (level) {
+        case Level::Debug: return "DEBUG";
+        case Level::Info: return "INFO";
+        case Level::Warn: return "WARN";
+        case Level::Error: return "ERROR";
+    }
+    return "?";
+}
+
+uint64_t CopyTail(std::vector<Entry>& out, uint64_t knownSequence) {
+    State& s = state();
+    uint64_t latest = s.sequence.load(std::memory_order_acquire);
+    if (latest == knownSequence) {
+        return latest; // Nothing new, skip the copy
+    }
+    std::lock_guard<std::mutex> lock(s.tailMutex);
+    out.assign(s.tail.begin(), s.tail.end());
+    return s.sequence.load(std::memory_order_relaxed);
+}
+
+void SetTailListener(std::function<void()> listener) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.listenerMutex);
+    s.tailListener = std::move(listener);
+}
+
+uint64_t DroppedCount() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.registryMutex);
+    uint64_t total = s.retiredDrops;
+    for (const auto& ring : s.rings) {
+        total += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+} // namespace Logger
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Asynchronous logging.
+//
+//   Logger::Info("[WS] Client connected. Address: {}", address);
+//
+// A call only checks the level, copies the arguments into a fixed-size record in a
+// per-thread lock-free ring and returns; formatting, console output and the in-memory
+// tail (shown by UIStatusLogWindow) are handled by a background flusher thread.
+// Format strings must be literals (they are stored by pointer). "{}" is replaced by the
+// next argument, "{:x}" prints an integer in hex. When a thread's ring is full the
+// message is dropped and counted instead of blocking the caller.
+// Before Init() (and after Shutdown()) messages are written synchronously.
+namespace Logger {
+
+    enum class Level : uint8_t {
+        Debug,
+        Info,
+        Warn,
+        Error
+    };
+
+    // A formatted message as kept in the in-memory tail
+    struct Entry {
+        uint64_t sequence = 0;   // 1-based, increases by one per message
+        int64_t timestampMs = 0; // Wall clock, milliseconds since the epoch
+        Level level = Level::Info;
+        std::string text;
+    };
+
+    struct Options {
+        size_t ringCapacity = 1024;   // Records per producer thread, rounded up to a power of two
+        size_t tailCapacity = 2000;   // Messages kept for the UI
+        std::chrono::milliseconds flushInterval{20};
+        bool writeToConsole = true;
+    };
+
+    // Start the background flusher. Call once at startup, before the worker threads.
+    void Init(const Options& options = {});
+    // Write everything still queued and stop the flusher.
+    void Shutdown();
+    // Write everything queued so far (blocks the caller; not for hot paths).
+    void Flush();
+
+    void SetLevel(Level level);
+    Level GetLevel();
+    const char* LevelName(Level level);
+
+    // Copies the tail into `out` if it changed since `knownSequence` (the value returned
+    // by the previous call). Returns the sequence of the newest message.
+    uint64_t CopyTail(std::vector<Entry>& out, uint64_t knownSequence);
+    // Total number of messages lost because a ring was full
+    uint64_t DroppedCount();
+    // Called after new messages reach the tail (usually on the flusher thread), e.g. to wake an idle
+    // UI that shows it. Keep it short; pass {} to remove it.
+    void SetTailListener(std::function<void()> listener);
+
+    namespace detail {
+
+        constexpr size_t RECORD_SIZE = 256;
+
+        enum class ArgType : uint8_t {
+            Int,
+            UInt,
+            Double,
+            Bool,
+            Char,
+            String,
+            Pointer
+        };
+
+        // One log call, arguments encoded as [type][value] into payload
+        struct Record {
+            int64_t timestampNs = 0;
+            const char* format = nullptr;
+            Level level = Level::Info;
+            uint8_t argCount = 0;
+            uint16_t size = 0;
+            char payload[RECORD_SIZE - 20];
+        };
+        static_assert(sizeof(Record) <= RECORD_SIZE, "Log record layout grew unexpectedly");
+
+        extern std::atomic<uint8_t> g_minLevel;
+
+        // Returns a slot in the calling thread's ring (or a scratch record when the
+        // flusher is not running), or nullptr if the ring is full.
+        Record* BeginRecord(Level level);
+        void CommitRecord(Record* record);
+
+        template <typename>
+        inline constexpr bool kUnsupportedArg = false;
+
+        class ArgWriter {
+        public:
+            explicit ArgWriter(Record& record) : m_record(record) {}
+
+            template <typename T>
+            void write(const T& value) {
+                using D = std::decay_t<T>;
+                if constexpr (std::is_same_v<D, bool>) {
+                    writeFixed(ArgType::Bool, static_cast<uint8_t>(value));
+                } else if constexpr (std::is_same_v<D, char>) {
+                    writeFixed(ArgType::Char, value);
+                } else if constexpr (std::is_enum_v<D>) {
+                    write(static_cast<std::underlying_type_t<D>>(value));
+                } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+                    writeFixed(ArgType::Int, static_cast<int64_t>(value));
+                } else if constexpr (std::is_integral_v<D>) {
+                    writeFixed(ArgType::UInt, static_cast<uint64_t>(value));
+                } else if constexpr (std::is_floating_point_v<D>) {
+                    writeFixed(ArgType::Double, static_cast<double>(value));
+                } else if constexpr (std::is_array_v<T>) {
+                    writeString(std::string_view(value)); // char array / string literal
+                } else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+                    writeString(value ? std::string_view(value) : std::string_view("(null)"));
+                } else if constexpr (std::is_same_v<D, std::filesystem::path>) {
+                    writeString(value.string());
+                } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                    writeString(std::string_view(value));
+                } else if constexpr (std::is_pointer_v<D>) {
+                    writeFixed(ArgType::Pointer, reinterpret_cast<uintptr_t>(value));
+                } else {
+                    static_assert(kUnsupportedArg<T>, "Unsupported Logger argument type");
+                }
+            }
+
+        private:
+            Record& m_record;
+
+            size_t remaining() const { return sizeof(m_record.payload) - m_record.size; }
+
+            template <typename V>
+            void writeFixed(ArgType type, V value) {
+                if (remaining() < 1 + sizeof(V)) return; // Out of space: shows as "{?}"
+                m_record.payload[m_record.size] = static_cast<char>(type);
+                std::memcpy(m_record.payload + m_record.size + 1, &value, sizeof(V));
+                m_record.size = static_cast<uint16_t>(m_record.size + 1 + sizeof(V));
+                ++m_record.argCount;
+            }
+
+            void writeString(std::string_view value) {
+                if (remaining() < 3) return;
+                // Long strings are truncated to what is left of the record
+                uint16_t length = static_cast<uint16_t>(std::min(value.size(), remaining() - 3));
+                m_record.payload[m_record.size] = static_cast<char>(ArgType::String);
+                std::memcpy(m_record.payload + m_record.size + 1, &length, sizeof(length));
+                std::memcpy(m_record.payload + m_record.size + 3, value.data(), length);
+                m_record.size = static_cast<uint16_t>(m_record.size + 3 + length);
+                ++m_record.argCount;
+            }
+        };
+
+    } // namespace detail
+
+    inline bool IsEnabled(Level level) {
+        return static_cast<uint8_t>(level) >= detail::g_minLevel.load(std::memory_order_relaxed);
+    }
+
+    template <size_t N, typename... Args>
+    void Log(Level level, const char (&format)[N], const Args&... args) {
+        if (!IsEnabled(level)) return;
+        detail::Record* record = detail::BeginRecord(level);
+        if (!record) return;
+        record->format = format;
+        detail::ArgWriter writer(*record);
+        (writer.write(args), ...);
+        detail::CommitRecord(record);
+    }
+
+    template <size_t N, typename... Args>
+    void Debug(const char (&format)[N], const Args&... args) { Log(Level::Debug, format, args...); }
+
+    template <size_t N, typename... Args>
+    void Info(const char (&format)[N], const Args&... args) { Log(Level::Info, format, args...); }
+
+    template <size_t N, typename... Args>
+    void Warn(const char (&format)[N], const Args&... args) { Log(Level::Warn, format, args...); }
+
+    template <size_t N, typename... Args>
+    void Error(const char (&format)[N], const Args&... args) { Log(Level::Error, format, args...); }
+
+} // namespace Logger
@@ -2,7 +2,7 @@
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #include <iphlpapi.h>
-#include <iostream> // For std::cerr
+#include "Logger.hpp"
 #include <vector>   // For std::vector used internally
 #include <memory>   // For smart pointers if needed, though raw pointers are used by API
 
@@ -58,7 +58,7 @@ std::string GetLocalIPv4() {
         // If loop completes without finding a suitable IP
         return "No suitable IP found";
     } else {
-        std::cerr << "GetAdaptersAddresses failed with error: " << dwRetVal << std::endl;
+        Logger::Error("GetAdaptersAddresses failed with error: {}", dwRetVal);
         return "Error fetching IP";
     }
     // Should not reach here if successful or error, but added for safety.
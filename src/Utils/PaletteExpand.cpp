@@ -0,0 +1,144 @@
+#include "PaletteExpand.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PALETTE_EXPAND_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define PALETTE_EXPAND_TARGET(isa) // MSVC compiles any intrinsic without flags
+#else
+#define PALETTE_EXPAND_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace PaletteExpand {
+
+namespace { // Anonymous namespace for internal linkage
+
+    inline bool isOpaque(uint32_t color) {
+        uint8_t rgba[4];
+        std::memcpy(rgba, &color, 4);
+        return rgba[3] >= 128;
+    }
+
+    void expandScalar(const uint8_t* indices, size_t count, const uint32_t* palette, uint8_t* dst) {
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t color = palette[indices[i]];
+            if (isOpaque(color)) std::memcpy(dst + i * 4, &color, 4);
+        }
+    }
+
+#ifdef PALETTE_EXPAND_X86
+    // No gather before AVX2: the four lookups are scalar, the transparency blend is not
+    PALETTE_EXPAND_TARGET("sse2")
+    void expandSse2(const uint8_t* indices, size_t count, const uint32_t* palette, uint8_t* dst) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i colors = _mm_setr_epi32(static_cast<int>(palette[indices[i]]), static_cast<int>(palette[indices[i + 1]]),
+                                            static_cast<int>(palette[indices[i + 2]]), static_cast<int>(palette[indices[i + 3]]));
+            __m128i opaque = _mm_srai_epi32(colors, 31); // Alpha's top bit spread over the pixel
+            __m128i* out = reinterpret_cast<__m128i*>(dst + i * 4);
+            __m128i canvas = _mm_loadu_si128(out);
+            _mm_storeu_si128(out, _mm_or_si128(_mm_and_si128(opaque, colors), _mm_andnot_si128(opaque, canvas)));
+        }
+        expandScalar(indices + i, count - i, palette, dst + i * 4);
+    }
+
+    PALETTE_EXPAND_TARGET("avx2")
+    void expandAvx2(const uint8_t* indices, size_t count, const uint32_t* palette, uint8_t* dst) {
+        const int* table = reinterpret_cast<const int*>(palette);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices + i)));
+            __m256i colors = _mm256_i32gather_epi32(table, lanes, 4);
+            __m256i opaque = _mm256_srai_epi32(colors, 31);
+            __m256i* out = reinterpret_cast<__m256i*>(dst + i * 4);
+            _mm256_storeu_si256(out, _mm256_blendv_epi8(_mm256_loadu_si256(out), colors, opaque));
+        }
+        expandScalar(indices + i, count - i, palette, dst + i * 4);
+    }
+
+    bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6; // OSXSAVE, XMM and YMM state
+        if (!osSavesYmm) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2"); // Also checks that the OS saves the YMM registers
+#endif
+    }
+
+#if !defined(__x86_64__) && !defined(_M_X64)
+    // Only needed on 32-bit x86; SSE2 is part of x86-64
+    bool cpuHasSse2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#else
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+#endif
+#endif
+
+    Kernel detect() {
+#ifdef PALETTE_EXPAND_X86
+        if (cpuHasAvx2()) return Kernel::Avx2;
+#if defined(__x86_64__) || defined(_M_X64)
+        return Kernel::Sse2; // Part of x86-64
+#else
+        return cpuHasSse2() ? Kernel::Sse2 : Kernel::Scalar;
+#endif
+#else
+        return Kernel::Scalar;
+#endif
+    }
+
+} // namespace
+
+Kernel bestKernel() {
+    static const Kernel best = detect();
+    return best;
+}
+
+bool isSupported(Kernel kernel) {
+    Kernel best = bestKernel();
+    switch (kernel) {
+        case Kernel::Scalar: return true;
+        case Kernel::Sse2: return best == Kernel::Sse2 || best == Kernel::Avx2;
+        case Kernel::Avx2: return best == Kernel::Avx2;
+    }
+    return false;
+}
+
+const char* kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar: return "scalar";
+        case Kernel::Sse2: return "sse2";
+        case Kernel::Avx2: return "avx2";
+    }
+    return "unknown";
+}
+
+void expandRow(Kernel kernel, const uint8_t* indices, size_t count, const uint32_t* palette, uint8_t* dst) {
+    switch (kernel) {
+#ifdef PALETTE_EXPAND_X86
+        case Kernel::Avx2: expandAvx2(indices, count, palette, dst); return;
+        case Kernel::Sse2: expandSse2(indices, count, palette, dst); return;
+#endif
+        default: expandScalar(indices, count, palette, dst); return;
+    }
+}
+
+void expandRow(const uint8_t* indices, size_t count, const uint32_t* palette, uint8_t* dst) {
+    expandRow(bestKernel(), indices, count, palette, dst);
+}
+
+} // namespace PaletteExpand
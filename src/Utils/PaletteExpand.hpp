@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Expands rows of 8-bit palette indices to RGBA pixels, the inner loop of GIF compositing.
+// Vectorized with SSE2 or AVX2 on x86, picked at runtime from what the CPU supports; the
+// scalar kernel is the fallback everywhere else. All kernels give bit-identical results.
+namespace PaletteExpand {
+
+enum class Kernel {
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+// The fastest kernel this CPU runs (detected once)
+Kernel bestKernel();
+bool isSupported(Kernel kernel);
+const char* kernelName(Kernel kernel);
+
+// Writes palette[indices[i]] to pixel i of `dst` (RGBA, 4 bytes per pixel, no alignment
+// needed) for `count` pixels. `palette` holds 256 colours as RGBA bytes; a colour whose
+// alpha is below 128 marks a transparent index and leaves the pixel in `dst` as it is.
+void expandRow(const uint8_t* indices, size_t count, const uint32_t* palette, uint8_t* dst);
+// Same with a given kernel, which must be supported (for benchmarks and checks)
+void expandRow(Kernel kernel, const uint8_t* indices, size_t count, const uint32_t* palette, uint8_t* dst);
+
+} // namespace PaletteExpand
@@ -0,0 +1,141 @@
+#include "SkylinePacker.hpp"
+#include <algorithm>
+#include <limits>
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : m_width(width), m_height(height)
+{
+    clear();
+}
+
+void SkylinePacker::clear()
+{
+    m_skyline.assign(1, Segment{0, 0, m_width});
+    m_freeRects.clear();
+    m_usedArea = 0;
+    m_rectCount = 0;
+}
+
+int SkylinePacker::fitAt(size_t index, int width, int height) const
+{
+    int x = m_skyline[index].x;
+    if (x + width > m_width) return -1;
+    int y = 0;
+    int remaining = width;
+    for (size_t i = index; remaining > 0; ++i) { // The skyline spans the full width, so this stays in range
+        y = std::max(y, m_skyline[i].y);
+        if (y + height > m_height) return -1;
+        remaining -= m_skyline[i].width;
+    }
+    return y;
+}
+
+void SkylinePacker::addSegment(size_t index, const PackedRect& rect)
+{
+    m_skyline.insert(m_skyline.begin() + index, Segment{rect.x, rect.y + rect.height, rect.width});
+
+    // Cut the segments the new one now covers
+    int right = rect.x + rect.width;
+    size_t next = index + 1;
+    while (next < m_skyline.size() && m_skyline[next].x < right) {
+        Segment& segment = m_skyline[next];
+        int covered = right - segment.x;
+        if (covered < segment.width) {
+            segment.x += covered;
+            segment.width -= covered;
+            break;
+        }
+        m_skyline.erase(m_skyline.begin() + next);
+    }
+
+    // Merge neighbours at the same height
+    for (size_t i = 0; i + 1 < m_skyline.size();) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+}
+
+std::optional<PackedRect> SkylinePacker::insert(int width, int height)
+{
+    if (width <= 0 || height <= 0 || width > m_width || height > m_height) return std::nullopt;
+
+    // A released rectangle that fits, wasting as little of it as possible
+    auto bestFree = m_freeRects.end();
+    int64_t bestWaste = std::numeric_limits<int64_t>::max();
+    for (auto it = m_freeRects.begin(); it != m_freeRects.end(); ++it) {
+        if (it->width < width || it->height < height) continue;
+        int64_t waste = int64_t(it->width) * it->height - int64_t(width) * height;
+        if (waste < bestWaste) {
+            bestWaste = waste;
+            bestFree = it;
+            if (waste == 0) break;
+        }
+    }
+    if (bestFree != m_freeRects.end()) {
+        PackedRect rect{bestFree->x, bestFree->y, width, height};
+        m_freeRects.erase(bestFree);
+        m_usedArea += uint64_t(width) * height;
+        ++m_rectCount;
+        return rect;
+    }
+
+    // Otherwise the skyline position with the lowest top; ties go to the narrower segment
+    // (less space left unusable beside it)
+    size_t bestIndex = m_skyline.size();
+    int bestTop = std::numeric_limits<int>::max();
+    int bestWidth = std::numeric_limits<int>::max();
+    for (size_t i = 0; i < m_skyline.size(); ++i) {
+        int y = fitAt(i, width, height);
+        if (y < 0) continue;
+        int top = y + height;
+        if (top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth)) {
+            bestIndex = i;
+            bestTop = top;
+            bestWidth = m_skyline[i].width;
+        }
+    }
+    if (bestIndex == m_skyline.size()) return std::nullopt;
+
+    PackedRect rect{m_skyline[bestIndex].x, bestTop - height, width, height};
+    addSegment(bestIndex, rect);
+    m_usedArea += uint64_t(width) * height;
+    ++m_rectCount;
+    return rect;
+}
+
+void SkylinePacker::release(const PackedRect& rect)
+{
+    m_freeRects.push_back(rect);
+    m_usedArea -= uint64_t(rect.width) * rect.height;
+    --m_rectCount;
+}
+
+SkylinePacker::Stats SkylinePacker::stats() const
+{
+    Stats stats;
+    uint64_t skylineArea = 0;
+    for (const auto& segment : m_skyline) {
+        skylineArea += uint64_t(segment.width) * segment.y;
+        stats.skylineTop = std::max(stats.skylineTop, segment.y);
+    }
+    stats.occupancy = double(m_usedArea) / (double(m_width) * m_height);
+    stats.fragmentation = skylineArea > 0 ? double(skylineArea - m_usedArea) / double(skylineArea) : 0.0;
+    stats.rects = m_rectCount;
+    stats.freeRects = m_freeRects.size();
+    return stats;
+}
+
+bool SkylinePacker::shouldRepack() const
+{
+    if (m_freeRects.empty()) return false;
+    return stats().fragmentation >= REPACK_FRAGMENTATION;
+}
+
+bool SkylinePacker::repackOrder(const PackedRect& a, const PackedRect& b)
+{
+    return a.height != b.height ? a.height > b.height : a.width > b.width;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Position of a rectangle handed out by SkylinePacker, in pixels from the top-left corner
+struct PackedRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// Packs rectangles into a fixed-size area, for texture atlases. Keeps the "skyline" (the
+// top edge of everything placed so far) as a list of horizontal segments and puts each
+// new rectangle where its top ends up lowest (bottom-left rule), so rows of similar icons
+// fill up tightly.
+//
+// A skyline can't give space back, so release() keeps freed rectangles in a free list
+// that insert() tries first; a replaced icon of the same size takes its old place. The
+// space is only reclaimed fully by clear() and inserting everything again (a repack).
+//
+// Pure CPU bookkeeping; no GL context needed.
+class SkylinePacker {
+public:
+    struct Stats {
+        double occupancy = 0.0;     // Area of live rectangles / whole area
+        double fragmentation = 0.0; // Area below the skyline not holding a live rectangle / area below the skyline
+        size_t rects = 0;           // Live rectangles
+        size_t freeRects = 0;       // Released rectangles waiting for reuse
+        int skylineTop = 0;         // Highest point of the skyline (rows used)
+    };
+
+    // Repack when at least this share of the area below the skyline is unusable
+    static constexpr double REPACK_FRAGMENTATION = 0.25;
+
+    SkylinePacker(int width, int height);
+
+    // Reserves a width x height rectangle; nullopt if it doesn't fit anywhere
+    std::optional<PackedRect> insert(int width, int height);
+    // Makes a rectangle returned by insert() available to later inserts of the same size or smaller
+    void release(const PackedRect& rect);
+    // Forgets every rectangle
+    void clear();
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    Stats stats() const;
+    // True if released space adds up to enough fragmentation that a repack is worth it;
+    // asked when a new rectangle doesn't fit
+    bool shouldRepack() const;
+    // Order to insert rectangles in for a repack: tallest first packs a skyline most tightly
+    static bool repackOrder(const PackedRect& a, const PackedRect& b);
+
+private:
+    struct Segment {
+        int x;
+        int y; // Top of the used area over [x, x + width)
+        int width;
+    };
+
+    // Lowest y a width x height rectangle can sit at with its left edge on segment `index`; -1 if it doesn't fit
+    int fitAt(size_t index, int width, int height) const;
+    void addSegment(size_t index, const PackedRect& rect);
+
+    int m_width;
+    int m_height;
+    std::vector<Segment> m_skyline; // Left to right, covering [0, m_width)
+    std::vector<PackedRect> m_freeRects;
+    uint64_t m_usedArea = 0;
+    size_t m_rectCount = 0;
+};
@@ -1,11 +1,9 @@
 #include "TextureLoader.hpp"
 #include <map>
-#include <iostream>
+#include "Logger.hpp"
 #include <vector> // Needed for stb_image
 
-// Define STB_IMAGE_IMPLEMENTATION in *one* CPP file. This is the one.
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
+#include <stb_image.h> // Implemented in IconResizer.cpp, which builds without GL
 
 namespace TextureLoader {
 
@@ -24,7 +22,7 @@ GLuint LoadTexture(const std::string& filename) {
     }
 
     // Texture not in cache, attempt to load
-    std::cout << "Loading texture: " << filename << std::endl;
+    Logger::Info("Loading texture: {}", filename);
     int width, height, channels;
     // Force 4 channels (RGBA) for consistency with OpenGL formats
     unsigned char* data = stbi_load(filename.c_str(), &width, &height, &channels, 4);
@@ -32,11 +30,11 @@ GLuint LoadTexture(const std::string& filename) {
     GLuint textureID = 0; // Default to 0 (failure)
 
     if (data == nullptr) {
-        std::cerr << "Error loading image: " << filename << " - " << stbi_failure_reason() << std::endl;
+        Logger::Error("Error loading image: {} - {}", filename, stbi_failure_reason());
     } else {
         glGenTextures(1, &textureID);
         if (textureID == 0) {
-             std::cerr << "Error: Failed to generate texture ID for " << filename << std::endl;
+             Logger::Error("Failed to generate texture ID for {}", filename);
         } else {
             glBindTexture(GL_TEXTURE_2D, textureID);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -46,7 +44,7 @@ GLuint LoadTexture(const std::string& filename) {
             glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Ensure correct alignment
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
             glBindTexture(GL_TEXTURE_2D, 0);
-            std::cout << "Successfully loaded texture: " << filename << " (ID: " << textureID << ")" << std::endl;
+            Logger::Info("Successfully loaded texture: {} (ID: {})", filename, textureID);
         }
         stbi_image_free(data); // Free the image data once uploaded to OpenGL
     }
@@ -56,12 +54,36 @@ GLuint LoadTexture(const std::string& filename) {
     return textureID;
 }
 
+bool LoadPixels(const std::string& filename, std::vector<unsigned char>& rgba, int& width, int& height) {
+    int channels;
+    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &channels, 4);
+    if (data == nullptr) {
+        Logger::Error("Error loading image: {} - {}", filename, stbi_failure_reason());
+        return false;
+    }
+    rgba.assign(data, data + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(data);
+    return true;
+}
+
+void ReleaseTexture(const std::string& filename) {
+    auto it = g_staticTextureCache.find(filename);
+    if (it == g_staticTextureCache.end()) {
+        return;
+    }
+    if (it->second != 0) {
+        glDeleteTextures(1, &it->second);
+        Logger::Info("Released static texture: {} (ID: {})", filename, it->second);
+    }
+    g_staticTextureCache.erase(it); // Also forgets a cached load failure
+}
+
 void ReleaseStaticTextures() {
-    std::cout << "Releasing " << g_staticTextureCache.size() << " cached static textures..." << std::endl;
+    Logger::Info("Releasing {} cached static textures...", g_staticTextureCache.size());
     for (auto const& [path, textureId] : g_staticTextureCache) {
         if (textureId != 0) { // Only delete valid texture IDs
             glDeleteTextures(1, &textureId);
-             std::cout << "  Deleted static texture: " << path << " (ID: " << textureId << ")" << std::endl;
+             Logger::Info("  Deleted static texture: {} (ID: {})", path, textureId);
         }
     }
     g_staticTextureCache.clear(); // Clear the map
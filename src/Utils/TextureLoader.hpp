@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <GL/glew.h> // For GLuint
 
 namespace TextureLoader {
@@ -9,6 +10,14 @@ namespace TextureLoader {
     // Returns the OpenGL texture ID, or 0 on failure.
     GLuint LoadTexture(const std::string& filename);
 
+    // Decodes an image file to RGBA8 pixels without creating a texture (not cached).
+    // Returns false (and logs) on failure.
+    bool LoadPixels(const std::string& filename, std::vector<unsigned char>& rgba, int& width, int& height);
+
+    // Drops one cached texture (if loaded) so the next LoadTexture reads the file again.
+    // Must be called on the thread that owns the GL context.
+    void ReleaseTexture(const std::string& filename);
+
     // Releases all cached static textures. Call this during shutdown.
     void ReleaseStaticTextures();
 
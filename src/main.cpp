@@ -8,16 +8,20 @@
 #include <GLFW/glfw3.h>
 
 #include <GL/glew.h>      // Include GLEW header (now safe after GLFW_INCLUDE_NONE)
+#include <cstdlib> // std::getenv
 #include <memory> // For std::unique_ptr
-#include <iostream> // For std::cerr
+#include "Utils/Logger.hpp"
 
 #include "UIManager.hpp" // Include the new UI Manager header
 #include "ConfigManager.hpp" // Include ConfigManager header
 #include "ActionExecutor.hpp" // Include ActionExecutor header
 #include "CommServer.hpp" // Include CommServer header
+#include "RenderScheduler.hpp" // Draws only when something changed
+#include "ConfigWatcher.hpp" // Hot reload of config.json
 #include "TranslationManager.hpp" // Include TranslationManager header
 #include "Utils/InputUtils.hpp" // For audio control init/uninit
 #include "Utils/TextureLoader.hpp" // <<< ADDED
+#include "Utils/AllocationProfiler.hpp" // Per-frame allocation counts (WEBSTREAMDECK_PROFILE_ALLOCATIONS)
 
 static void glfw_error_callback(int error, const char* description)
 {
@@ -26,6 +30,9 @@ static void glfw_error_callback(int error, const char* description)
 
 int main(int, char**)
 {
+    // Logging is asynchronous from here on; the Status/Log window shows the tail
+    Logger::Init();
+
     glfwSetErrorCallback(glfw_error_callback);
     if (!glfwInit()) return 1;
 
@@ -53,6 +60,7 @@ int main(int, char**)
     glfwSwapInterval(1); // Enable vsync
 
     IMGUI_CHECKVERSION();
+    AllocationProfiler::InstallImGuiAllocator(); // No-op unless allocation profiling is built in
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO(); (void)io;
     io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;   // Enable Docking
@@ -111,68 +119,98 @@ int main(int, char**)
     ActionExecutor actionExecutor(configManager);
     UIManager uiManager(configManager, actionExecutor, translationManager);
 
+    // Kiosks on integrated GPUs can lower the icon texture budget, e.g.
+    // WEBSTREAMDECK_TEXTURE_BUDGET_MB=16
+    if (const char* budgetMb = std::getenv("WEBSTREAMDECK_TEXTURE_BUDGET_MB")) {
+        char* end = nullptr;
+        unsigned long megabytes = std::strtoul(budgetMb, &end, 10);
+        if (end != budgetMb && *end == '\0' && megabytes > 0) {
+            uiManager.setTextureBudget(static_cast<size_t>(megabytes) * 1024 * 1024);
+            Logger::Info("Icon texture budget: {} MB", megabytes);
+        } else {
+            Logger::Warn("Ignoring WEBSTREAMDECK_TEXTURE_BUDGET_MB={}: expected a positive number of megabytes", budgetMb);
+        }
+    }
+
     // Create Communication Server, passing ConfigManager
     auto commServer = std::make_unique<CommServer>(configManager);
     const int webSocketPort = 9002;
 
-    // Define the message handler lambda
+    // button_press, hello and get_config are handled by CommServer itself;
+    // anything that reaches this handler is a message type we don't know
     commServer->set_message_handler(
-        [&actionExecutor](uWS::WebSocket<false, true, PerSocketData>* /*ws*/, const json& payload, bool /*isBinary*/) {
-            try {
-                // Check protocol: { "type": "button_press", "payload": { "button_id": "..." } }
-                if (payload.contains("type") && payload["type"].is_string() && payload["type"] == "button_press") {
-                    if (payload.contains("payload") && payload["payload"].is_object()) {
-                        const auto& buttonPayload = payload["payload"];
-                        if (buttonPayload.contains("button_id") && buttonPayload["button_id"].is_string()) {
-                            std::string buttonId = buttonPayload["button_id"].get<std::string>();
-                            std::cout << "Received button press for ID: " << buttonId << std::endl;
-                            // UPDATED: Call requestAction instead of executeAction
-                            actionExecutor.requestAction(buttonId);
-                        } else {
-                            std::cerr << "Message handler: Missing or invalid 'button_id' in payload." << std::endl;
-                        }
-                    } else {
-                        std::cerr << "Message handler: Missing or invalid 'payload' object." << std::endl;
-                    }
-                } else {
-                    // Optional: Handle other message types or ignore
-                    std::cerr << "Message handler: Received unknown message type or format." << std::endl;
-                }
-            } catch (const json::exception& e) {
-                std::cerr << "Message handler: JSON processing error: " << e.what() << std::endl;
-            } catch (const std::exception& e) {
-                std::cerr << "Message handler: General error: " << e.what() << std::endl;
-            }
+        [](uWS::WebSocket<false, true, PerSocketData>* /*ws*/, const json& payload, bool /*isBinary*/) {
+            Logger::Error("Message handler: Received unknown message type or format: {}",
+                          payload.dump(-1, ' ', false, json::error_handler_t::replace));
         }
     );
 
+    // Presses from both protocols arrive here with the button id already validated
+    commServer->set_button_press_handler([&actionExecutor](std::string_view buttonId) {
+        Logger::Debug("Received button press for ID: {}", buttonId);
+        actionExecutor.requestAction(buttonId);
+    });
+
+    // Actions run on their own thread as soon as they are queued; only the ones
+    // that need the main thread come back through processPendingActions()
+    actionExecutor.setMainThreadWakeup([]() { glfwPostEmptyEvent(); });
+    actionExecutor.start();
+
+    // The UI sleeps while idle; these changes on other threads wake it for a frame
+    commServer->set_status_listener([]() { glfwPostEmptyEvent(); });
+    // New log lines only need a frame while the Status/Log window is on screen to show them
+    Logger::SetTailListener([&uiManager]() {
+        if (uiManager.isLogWindowVisible()) glfwPostEmptyEvent();
+    });
+    uiManager.setIconWakeup([]() { glfwPostEmptyEvent(); });  // A decoded icon is ready to upload
+
     // Start the server
     if (!commServer->start(webSocketPort)) {
-        std::cerr << "!!!!!!!! FAILED TO START WEBSOCKET SERVER ON PORT " << webSocketPort << " !!!!!!!!" << std::endl;
+        Logger::Error("!!!!!!!! FAILED TO START WEBSOCKET SERVER ON PORT {} !!!!!!!!", webSocketPort);
         // Decide how to handle failure - maybe exit, maybe continue without server?
         // For now, just print error and continue.
     }
 
+    // Pick up edits to config.json made outside the app (scripts, git checkouts). Reloads
+    // run on the watcher thread; only what the diff touched is invalidated: web clients
+    // get a layout delta through the config listener, plus the stale icons below.
+    ConfigWatcher configWatcher(configManager.getConfigFilePath(), [&]() {
+        auto diff = configManager.reloadFromDisk();
+        if (!diff) return;
+        if (!diff->staleIconPaths.empty()) {
+            commServer->invalidate_assets(diff->staleIconUrls);
+            uiManager.invalidateIconTextures(diff->staleIconPaths);
+        }
+        glfwPostEmptyEvent(); // Redraw with the new configuration
+    });
+    configWatcher.start();
+
     ImVec4 clear_color = ImVec4(0.1f, 0.1f, 0.1f, 1.00f);
 
     // Initialize Core Audio Control (Windows only)
 #ifdef _WIN32
     if (!InputUtils::InitializeAudioControl()) {
-        std::cerr << "Warning: Failed to initialize Core Audio controls." << std::endl;
+        Logger::Warn("Failed to initialize Core Audio controls.");
         // Continue execution even if audio control fails, 
         // volume buttons will just log errors when pressed.
     }
 #endif
 
+    RenderScheduler renderScheduler(window);
+
     while (!glfwWindowShouldClose(window))
     {
-        glfwPollEvents();
+        // Sleeps until input, a glfwPostEmptyEvent() from another thread or the next GIF
+        // frame; returns false while the window is minimized
+        bool drawFrame = renderScheduler.waitForNextFrame();
 
-        // ADDED: Process actions requested from other threads
+        // Run actions the executor thread handed back to the main thread
         actionExecutor.processPendingActions();
 
         // Update server status in UIManager
         uiManager.setServerStatus(commServer->is_running(), webSocketPort);
+        if (!drawFrame) continue;
+        uiManager.setRenderStats(renderScheduler.stats());
 
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
@@ -201,12 +239,19 @@ int main(int, char**)
         }
 
         glfwSwapBuffers(window);
+        renderScheduler.frameDrawn(uiManager.secondsUntilNextFrame());
+        AllocationProfiler::EndFrame();
     }
 
     // Cleanup
-    std::cout << "Stopping WebSocket server..." << std::endl;
+    Logger::SetTailListener({}); // Nothing left to wake; GLFW goes away below
+    uiManager.setIconWakeup({});
+    configWatcher.stop(); // Its callback uses the server and the UI
+    Logger::Info("Stopping WebSocket server...");
     commServer->stop(); // Stop the server thread before cleaning up ImGui/GLFW
-    std::cout << "WebSocket server stopped." << std::endl;
+    Logger::Info("WebSocket server stopped.");
+    actionExecutor.stop(); // No more presses can arrive; finish before audio/COM teardown
+    configManager.flushPendingSave(); // Don't lose edits made just before closing
 
     // Uninitialize Core Audio Control (Windows only)
 #ifdef _WIN32
@@ -222,5 +267,7 @@ int main(int, char**)
     glfwDestroyWindow(window);
     glfwTerminate();
 
+    Logger::Shutdown(); // Writes out anything still queued
+
     return 0;
 } 
\ No newline at end of file
@@ -5,6 +5,7 @@ const ui = (() => {
     const buttonGrid = document.getElementById('button-grid');
     const appTitle = document.getElementById('app-title');
     const paginationDotsContainer = document.getElementById('pagination-dots');
+    const pageBar = document.getElementById('page-bar');
     const connectionStatusDiv = document.getElementById('connection-status');
 
     let currentPageIndex = 0;
@@ -110,16 +111,73 @@ const ui = (() => {
         goToPage(0);
     }
 
+    // --- Page Bar (pages and folders from the server) --- 
+    // Tabs for the top-level pages, or a back button while a folder is open
+    function showPageBar(pages, pageId) {
+        pageBar.innerHTML = '';
+        const page = pages.find(p => p.id === pageId);
+        const topLevelPages = pages.filter(p => !p.folder);
+
+        if (page && page.folder) {
+            const backElement = document.createElement('button');
+            backElement.className = 'page-tab page-back';
+            backElement.textContent = '\u2039 Back';
+            backElement.onclick = () => window.websocketService.closeFolder();
+            pageBar.appendChild(backElement);
+
+            const titleElement = document.createElement('span');
+            titleElement.className = 'page-title';
+            titleElement.textContent = pageName(page);
+            pageBar.appendChild(titleElement);
+        } else if (topLevelPages.length > 1) {
+            topLevelPages.forEach(p => {
+                const tabElement = document.createElement('button');
+                tabElement.className = 'page-tab';
+                tabElement.classList.toggle('active', p.id === pageId);
+                tabElement.textContent = pageName(p);
+                tabElement.onclick = () => window.websocketService.viewPage(p.id);
+                pageBar.appendChild(tabElement);
+            });
+        }
+
+        const visible = pageBar.childElementCount > 0;
+        pageBar.style.display = visible ? 'flex' : 'none';
+        document.body.classList.toggle('has-page-bar', visible);
+    }
+
+    function pageName(page) {
+        return page.name || page.id || 'Main';
+    }
+
+    // --- Helper: Icon URL ---
+    // Icons are drawn well below this many CSS pixels in every layout; the server sends
+    // them resized for it and the screen's pixel ratio instead of at their full size
+    const ICON_CSS_SIZE = 96;
+
+    function iconUrl(iconPath) {
+        if (!iconPath.startsWith('/assets/icons/') || iconPath.includes('?')) {
+            return iconPath;
+        }
+        const dpr = Math.min(Math.max(window.devicePixelRatio || 1, 1), 4);
+        return `${iconPath}?w=${ICON_CSS_SIZE}&dpr=${dpr}`;
+    }
+
     // --- Helper: Create Button Element --- 
     function createButtonElement(button) {
         const btnElement = document.createElement('button');
         btnElement.className = 'grid-button';
-        btnElement.onclick = () => window.websocketService.sendButtonPress(button.id);
+        if (button.folder) {
+            // Opens another page instead of sending a press
+            btnElement.classList.add('folder-button');
+            btnElement.onclick = () => window.websocketService.openFolder(button.folder);
+        } else {
+            btnElement.onclick = () => window.websocketService.sendButtonPress(button.id);
+        }
 
         if (button.icon_path && button.icon_path.trim() !== '') {
             btnElement.classList.add('has-icon');
             const imgElement = document.createElement('img');
-            imgElement.src = button.icon_path; 
+            imgElement.src = iconUrl(button.icon_path);
             imgElement.alt = button.name;
             imgElement.onerror = () => {
                 console.error(`Failed to load icon: ${button.icon_path}`);
@@ -291,6 +349,7 @@ const ui = (() => {
     return {
         init,
         loadButtons,
+        showPageBar,
         connectionStatusDiv
     };
 
@@ -4,6 +4,32 @@ let websocket = null;
 let uiModule = null; // Will be injected
 let connectionStatusDiv = null; // Direct reference to status element
 
+// Pages the server offers ("deck"), the page being shown and the pages to go back to
+// when folders are closed (innermost last). The server only sends the page being shown.
+let deckPages = [];
+let deckVersion = 0;
+let currentPageId = '';
+let folderTrail = [];
+// Page asked for again after a reconnect, until it arrives. The server opens every
+// connection on the root page first; that page is skipped so the trail survives.
+let restoringPageId = null;
+
+// Last full layout received for the current page and the version it corresponds to.
+// layout_update messages for that page are deltas against this version.
+let currentLayout = [];
+let layoutVersion = 0;
+
+// Binary press protocol (see src/BinaryProtocol.hpp). 0 until the server agrees in "hello".
+const BINARY_PROTOCOL_VERSION = 1;
+const OPCODE_BUTTON_PRESS = 0x01;
+const OPCODE_PRESS_ACK = 0x81;
+const ACK_ACCEPTED = 0;
+const ACK_STALE_LAYOUT = 1;
+let binaryProtocol = 0;
+let buttonIndexById = new Map();
+let pressSequence = 0;
+const pendingPresses = new Map(); // sequence -> button id, until acked
+
 function connectWebSocket(appUIModule, statusElement) {
     uiModule = appUIModule;
     connectionStatusDiv = statusElement;
@@ -12,12 +38,23 @@ function connectWebSocket(appUIModule, statusElement) {
     updateStatus('Connecting...', 'status-connecting');
 
     websocket = new WebSocket(config.websocketUrl);
+    websocket.binaryType = 'arraybuffer';
 
     websocket.onopen = (event) => {
         console.log('WebSocket connection opened');
         updateStatus('Connected', 'status-connected');
-        // Request initial config or state if needed
-        // Example: websocket.send(JSON.stringify({ type: 'get_config' }));
+        binaryProtocol = 0;
+        pendingPresses.clear();
+        // Versions only compare within one connection; a restarted server counts from 1 again
+        deckVersion = 0;
+        layoutVersion = 0;
+        // Offer the binary press protocol; presses stay on JSON until the server agrees
+        websocket.send(JSON.stringify({ type: 'hello', payload: { binary_protocol: BINARY_PROTOCOL_VERSION } }));
+        // The server starts every connection on the root page; return to where we were
+        restoringPageId = currentPageId !== '' ? currentPageId : null;
+        if (restoringPageId !== null) {
+            sendViewPage(restoringPageId);
+        }
     };
 
     websocket.onclose = (event) => {
@@ -34,6 +71,10 @@ function connectWebSocket(appUIModule, statusElement) {
     };
 
     websocket.onmessage = (event) => {
+        if (event.data instanceof ArrayBuffer) {
+            handleBinaryMessage(event.data);
+            return;
+        }
         console.log('Message from server:', event.data);
         try {
             const message = JSON.parse(event.data);
@@ -48,10 +89,34 @@ function handleServerMessage(message) {
     if (!uiModule) return; // Guard against UI module not ready
 
     switch (message.type) {
+        case 'deck':
+            handleDeck(message.payload);
+            break;
         case 'initial_config':
-        case 'layout_update': // Assuming server might send updates
-            console.log('Received layout configuration:', message.payload.layout);
-            uiModule.loadButtons(message.payload.layout);
+            console.log(`Received page '${message.payload.page}':`, message.payload.layout);
+            if (isRootPageBeforeRestore(message.payload.page || '')) {
+                break;
+            }
+            restoringPageId = null;
+            if (message.payload.page !== currentPageId) {
+                // A different page than before (navigation, or ours was removed)
+                currentPageId = message.payload.page || '';
+                if (!isFolder(currentPageId)) {
+                    folderTrail = [];
+                }
+            }
+            currentLayout = message.payload.layout || [];
+            layoutVersion = message.payload.version || 0;
+            rebuildButtonIndex();
+            uiModule.showPageBar(deckPages, currentPageId);
+            uiModule.loadButtons(currentLayout);
+            break;
+        case 'hello':
+            binaryProtocol = (message.payload && message.payload.binary_protocol) || 0;
+            console.log(`Binary press protocol: ${binaryProtocol ? 'v' + binaryProtocol : 'off (JSON)'}`);
+            break;
+        case 'layout_update':
+            handleLayoutUpdate(message.payload);
             break;
         // Add other message types here
         default:
@@ -59,15 +124,171 @@ function handleServerMessage(message) {
     }
 }
 
+function handleDeck(deck) {
+    if (deck.version < deckVersion) {
+        return; // Older than what we have
+    }
+    deckPages = deck.pages || [];
+    deckVersion = deck.version;
+    folderTrail = folderTrail.filter(pageId => deckPages.some(page => page.id === pageId));
+    uiModule.showPageBar(deckPages, currentPageId);
+    // If our page was removed the server moves us to the root page by itself
+}
+
+// The root page the server opens a new connection on, while the page we asked for is
+// still on its way. If that page is gone from the deck, the root page is the answer.
+function isRootPageBeforeRestore(pageId) {
+    return restoringPageId !== null && pageId === '' && deckPages.some(page => page.id === restoringPageId);
+}
+
+function isFolder(pageId) {
+    const page = deckPages.find(page => page.id === pageId);
+    return Boolean(page && page.folder);
+}
+
+function handleLayoutUpdate(delta) {
+    if ((delta.page || '') !== currentPageId) {
+        return; // For the page we just left
+    }
+    if (delta.version <= layoutVersion) {
+        return; // Already covered by a newer initial_config
+    }
+    if (delta.base_version !== layoutVersion) {
+        // Missed an update; ask for the full layout instead of guessing
+        console.log(`Layout delta v${delta.base_version}->v${delta.version} does not apply to v${layoutVersion}, resyncing.`);
+        requestFullConfig();
+        return;
+    }
+
+    const removed = new Set(delta.removed || []);
+    const changed = new Map((delta.changed || []).map(button => [button.id, button]));
+    let layout = currentLayout
+        .filter(button => !removed.has(button.id))
+        .map(button => changed.get(button.id) || button);
+
+    const added = (delta.added || []).slice().sort((a, b) => a.index - b.index);
+    for (const { index, ...button } of added) {
+        layout.splice(Math.min(index, layout.length), 0, button);
+    }
+
+    if (delta.order) {
+        const byId = new Map(layout.map(button => [button.id, button]));
+        layout = delta.order.map(id => byId.get(id)).filter(Boolean);
+    }
+
+    currentLayout = layout;
+    layoutVersion = delta.version;
+    rebuildButtonIndex();
+    console.log(`Applied layout delta, now at v${layoutVersion}.`);
+    uiModule.loadButtons(currentLayout);
+}
+
+function sendViewPage(pageId) {
+    websocket.send(JSON.stringify({ type: 'view_page', payload: { page_id: pageId } }));
+}
+
+// Show a top-level page. The page itself arrives as an initial_config.
+function viewPage(pageId) {
+    if (!websocket || websocket.readyState !== WebSocket.OPEN) {
+        console.error('WebSocket is not connected.');
+        return;
+    }
+    folderTrail = [];
+    if (pageId === '') {
+        restoringPageId = null; // Asked for the root page itself
+    }
+    sendViewPage(pageId);
+}
+
+// Open a folder from the current page; closeFolder() comes back here
+function openFolder(pageId) {
+    if (!websocket || websocket.readyState !== WebSocket.OPEN) {
+        console.error('WebSocket is not connected.');
+        return;
+    }
+    folderTrail.push(currentPageId);
+    sendViewPage(pageId);
+}
+
+function closeFolder() {
+    if (!websocket || websocket.readyState !== WebSocket.OPEN) {
+        console.error('WebSocket is not connected.');
+        return;
+    }
+    const previous = folderTrail.length > 0 ? folderTrail.pop() : '';
+    if (previous === '') {
+        restoringPageId = null; // Asked for the root page itself
+    }
+    sendViewPage(previous);
+}
+
+function requestFullConfig() {
+    if (websocket && websocket.readyState === WebSocket.OPEN) {
+        websocket.send(JSON.stringify({ type: 'get_config' }));
+    }
+}
+
+// Button indices in binary presses refer to the current page at the given version
+function rebuildButtonIndex() {
+    buttonIndexById = new Map(currentLayout.map((button, index) => [button.id, index]));
+}
+
+function handleBinaryMessage(buffer) {
+    const view = new DataView(buffer);
+    if (view.byteLength < 4 || view.getUint8(0) !== OPCODE_PRESS_ACK) {
+        console.error('Unexpected binary message from server:', buffer.byteLength, 'bytes');
+        return;
+    }
+    const status = view.getUint8(1);
+    const sequence = view.getUint16(2, true);
+    const buttonId = pendingPresses.get(sequence);
+    pendingPresses.delete(sequence);
+    if (status === ACK_ACCEPTED || buttonId === undefined) {
+        return;
+    }
+    console.warn(`Binary press for ${buttonId} rejected (status ${status}), resending as JSON.`);
+    if (status === ACK_STALE_LAYOUT) {
+        requestFullConfig();
+    }
+    // The id form is always valid, whatever layout version the server is on
+    sendJsonButtonPress(buttonId);
+}
+
+function sendBinaryButtonPress(buttonId) {
+    const index = buttonIndexById.get(buttonId);
+    if (index === undefined) {
+        return false;
+    }
+    const sequence = pressSequence;
+    pressSequence = (pressSequence + 1) & 0xFFFF;
+
+    const view = new DataView(new ArrayBuffer(12));
+    view.setUint8(0, OPCODE_BUTTON_PRESS);
+    view.setUint8(1, binaryProtocol);
+    view.setUint16(2, sequence, true);
+    view.setUint32(4, index, true);
+    view.setUint32(8, layoutVersion >>> 0, true); // Low 32 bits, matching the server
+    pendingPresses.set(sequence, buttonId);
+    websocket.send(view.buffer);
+    return true;
+}
+
+function sendJsonButtonPress(buttonId) {
+    const message = {
+        type: 'button_press',
+        payload: {
+            button_id: buttonId
+        }
+    };
+    websocket.send(JSON.stringify(message));
+}
+
 function sendButtonPress(buttonId) {
     if (websocket && websocket.readyState === WebSocket.OPEN) {
-        const message = {
-            type: 'button_press',
-            payload: {
-                button_id: buttonId
-            }
-        };
-        websocket.send(JSON.stringify(message));
+        if (binaryProtocol && sendBinaryButtonPress(buttonId)) {
+            return;
+        }
+        sendJsonButtonPress(buttonId);
         console.log(`Sent button press: ${buttonId}`);
     } else {
         console.error('WebSocket is not connected.');
@@ -85,5 +306,8 @@ function updateStatus(text, className) {
 // Export functions needed by other modules
 window.websocketService = {
     connectWebSocket,
-    sendButtonPress
+    sendButtonPress,
+    viewPage,
+    openFolder,
+    closeFolder
 }; 
\ No newline at end of file